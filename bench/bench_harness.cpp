@@ -0,0 +1,203 @@
+// bench_harness.cpp - 微基准框架实现
+
+#include "bench_harness.h"
+#include "config_file.h"
+
+namespace {
+
+// 丢弃全部输出的 streambuf
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+NullBuffer g_null_buffer;
+
+string FormatMs(double ms) {
+    ostringstream ss;
+    ss << fixed << setprecision(ms < 10.0 ? 4 : 2) << ms;
+    return ss.str();
+}
+
+const BenchCheck* FindCheck(const vector<BenchCheck>& checks, const BenchStats& s) {
+    for (const auto& c : checks) {
+        if (c.name == s.name && c.instance == s.instance) return &c;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+ScopedSilence::ScopedSilence() : saved_(cout.rdbuf(&g_null_buffer)) {}
+
+ScopedSilence::~ScopedSilence() {
+    cout.rdbuf(saved_);
+}
+
+double Percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(ceil(p * sorted.size()));
+    rank = min(max<size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+BenchStats RunBenchmark(const string& name, const string& instance, const BenchOptions& options,
+                        const function<void()>& setup, const function<void()>& body) {
+    vector<double> samples;
+    samples.reserve(options.repetitions);
+
+    for (int k = 0; k < options.warmup + options.repetitions; k++) {
+        ScopedSilence silence;
+        if (setup) setup();
+        auto start = chrono::steady_clock::now();
+        body();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        if (k >= options.warmup) samples.push_back(ms);
+    }
+
+    BenchStats s;
+    s.name = name;
+    s.instance = instance;
+    s.repetitions = static_cast<int>(samples.size());
+    sort(samples.begin(), samples.end());
+    if (!samples.empty()) {
+        s.min_ms = samples.front();
+        s.max_ms = samples.back();
+        s.mean_ms = accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        s.p50_ms = Percentile(samples, 0.50);
+        s.p90_ms = Percentile(samples, 0.90);
+        s.p99_ms = Percentile(samples, 0.99);
+    }
+    cout << "[基准] " << left << setw(16) << name << setw(14) << instance << right
+         << " p50=" << FormatMs(s.p50_ms) << "ms\n";
+    return s;
+}
+
+bool ReadBenchBaseline(const string& path, BenchBaseline& baseline) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) return false;
+    baseline.clear();
+    for (const auto& section : sections) {
+        for (const auto& [key, value] : section.entries) {
+            baseline[section.name][key] = atof(value.c_str());
+        }
+    }
+    return true;
+}
+
+bool WriteBenchBaseline(const string& path, const vector<BenchStats>& results) {
+    ofstream fout(path);
+    if (!fout) {
+        cerr << "[基准] 无法写入基线: " << path << "\n";
+        return false;
+    }
+    fout << "; LS-NTGF-Bench --record 生成，值为 p50 毫秒\n";
+    string current;
+    for (const auto& s : results) {
+        if (s.instance != current) {
+            current = s.instance;
+            fout << "\n[" << current << "]\n";
+        }
+        fout << s.name << " = " << FormatMs(s.p50_ms) << "\n";
+    }
+    return static_cast<bool>(fout);
+}
+
+bool ReadBenchTolerance(const string& path, map<string, double>& tolerance) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) return false;
+    const ConfigSection* section = FindConfigSection(sections, "tolerance");
+    if (section == nullptr) {
+        cerr << "[基准] 阈值文件缺少 [tolerance] 节: " << path << "\n";
+        return false;
+    }
+    for (const auto& [key, value] : section->entries) {
+        tolerance[key] = atof(value.c_str());
+    }
+    return true;
+}
+
+vector<BenchCheck> CompareWithBaseline(const vector<BenchStats>& results,
+                                       const BenchBaseline& baseline,
+                                       const map<string, double>& tolerance) {
+    double default_tolerance = 0.25;
+    if (auto it = tolerance.find("default"); it != tolerance.end()) {
+        default_tolerance = it->second;
+    }
+
+    vector<BenchCheck> checks;
+    for (const auto& s : results) {
+        BenchCheck c;
+        c.name = s.name;
+        c.instance = s.instance;
+        c.p50_ms = s.p50_ms;
+        auto tol = tolerance.find(s.name);
+        c.tolerance = tol != tolerance.end() ? tol->second : default_tolerance;
+
+        auto section = baseline.find(s.instance);
+        if (section != baseline.end()) {
+            auto entry = section->second.find(s.name);
+            if (entry != section->second.end()) c.baseline_ms = entry->second;
+        }
+
+        if (c.baseline_ms < 0.0) {
+            c.status = "new";
+        } else if (s.p50_ms > c.baseline_ms * (1.0 + c.tolerance)) {
+            c.status = "regression";
+        } else if (s.p50_ms < c.baseline_ms / (1.0 + c.tolerance)) {
+            c.status = "improved";
+        } else {
+            c.status = "ok";
+        }
+        checks.push_back(c);
+    }
+    return checks;
+}
+
+void WriteBenchJson(ostream& out, const vector<pair<string, string>>& context,
+                    const vector<BenchStats>& results, const vector<BenchCheck>& checks) {
+    out << "{\n  \"context\": {";
+    for (size_t k = 0; k < context.size(); k++) {
+        out << (k > 0 ? "," : "") << "\n    \"" << context[k].first << "\": \""
+            << context[k].second << "\"";
+    }
+    out << "\n  },\n  \"results\": [";
+    for (size_t k = 0; k < results.size(); k++) {
+        const auto& s = results[k];
+        out << (k > 0 ? "," : "") << "\n    {\"benchmark\": \"" << s.name
+            << "\", \"instance\": \"" << s.instance << "\", \"repetitions\": " << s.repetitions
+            << ", \"min_ms\": " << s.min_ms << ", \"mean_ms\": " << s.mean_ms
+            << ", \"p50_ms\": " << s.p50_ms << ", \"p90_ms\": " << s.p90_ms
+            << ", \"p99_ms\": " << s.p99_ms << ", \"max_ms\": " << s.max_ms << "}";
+    }
+    out << "\n  ],\n  \"checks\": [";
+    for (size_t k = 0; k < checks.size(); k++) {
+        const auto& c = checks[k];
+        out << (k > 0 ? "," : "") << "\n    {\"benchmark\": \"" << c.name
+            << "\", \"instance\": \"" << c.instance << "\", \"baseline_ms\": ";
+        if (c.baseline_ms < 0.0) {
+            out << "null";
+        } else {
+            out << c.baseline_ms;
+        }
+        out << ", \"p50_ms\": " << c.p50_ms << ", \"tolerance\": " << c.tolerance
+            << ", \"status\": \"" << c.status << "\"}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void PrintBenchTable(const vector<BenchStats>& results, const vector<BenchCheck>& checks) {
+    cout << "\n" << left << setw(16) << "benchmark" << setw(14) << "instance" << right
+         << setw(12) << "p50(ms)" << setw(12) << "p90(ms)" << setw(12) << "p99(ms)"
+         << setw(12) << "base(ms)" << "  status\n";
+    cout << string(90, '-') << "\n";
+    for (const auto& s : results) {
+        const BenchCheck* c = FindCheck(checks, s);
+        cout << left << setw(16) << s.name << setw(14) << s.instance << right
+             << setw(12) << FormatMs(s.p50_ms) << setw(12) << FormatMs(s.p90_ms)
+             << setw(12) << FormatMs(s.p99_ms)
+             << setw(12) << (c && c->baseline_ms >= 0.0 ? FormatMs(c->baseline_ms) : "-")
+             << "  " << (c ? c->status : "-") << "\n";
+    }
+}
@@ -0,0 +1,81 @@
+// bench_harness.h - 微基准框架
+// 每个基准先做 warmup 次不计时运行，再做 repetitions 次计时运行；每次运行前调用 setup
+// (不计时，用于恢复被 body 修改的输入)。统计 min/mean/p50/p90/p99/max (毫秒)。
+//
+// 回归检查: 基线文件 (INI，每个实例一节，键为基准名，值为 p50 毫秒，由 --record 写出) 与
+// 阈值文件 ([tolerance] 节，键为基准名或 default，值为允许的 p50 相对增幅) 比较，
+// p50 > 基线 * (1 + 阈值) 判为回归
+
+#ifndef BENCH_HARNESS_H_
+#define BENCH_HARNESS_H_
+
+#include "common.h"
+
+// 单个基准的计时统计
+struct BenchStats {
+    string name;          // 基准名 (read_data, merge_fg, ...)
+    string instance;      // 实例规模 (N1000_T30)
+    int repetitions = 0;
+    double min_ms = 0.0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+struct BenchOptions {
+    int warmup = 2;
+    int repetitions = 10;
+};
+
+// 与基线比较的结果
+struct BenchCheck {
+    string name;
+    string instance;
+    double baseline_ms = -1.0;  // -1 表示基线中没有
+    double p50_ms = 0.0;
+    double tolerance = 0.0;
+    string status;              // ok / regression / improved / new
+};
+
+// 计时期间把 cout 重定向到空设备 (ReadData、合并等直接写 cout)
+class ScopedSilence {
+public:
+    ScopedSilence();
+    ~ScopedSilence();
+    ScopedSilence(const ScopedSilence&) = delete;
+    ScopedSilence& operator=(const ScopedSilence&) = delete;
+
+private:
+    streambuf* saved_;
+};
+
+// 最近秩百分位，sorted 为升序
+double Percentile(const vector<double>& sorted, double p);
+
+// 执行一个基准
+BenchStats RunBenchmark(const string& name, const string& instance, const BenchOptions& options,
+                        const function<void()>& setup, const function<void()>& body);
+
+// 基线: baseline[实例][基准] = p50 毫秒
+using BenchBaseline = map<string, map<string, double>>;
+
+bool ReadBenchBaseline(const string& path, BenchBaseline& baseline);
+bool WriteBenchBaseline(const string& path, const vector<BenchStats>& results);
+
+// 阈值: tolerance[基准]，"default" 为缺省值
+bool ReadBenchTolerance(const string& path, map<string, double>& tolerance);
+
+vector<BenchCheck> CompareWithBaseline(const vector<BenchStats>& results,
+                                       const BenchBaseline& baseline,
+                                       const map<string, double>& tolerance);
+
+// 结果 JSON (context 为运行参数，原样写出字符串值)
+void WriteBenchJson(ostream& out, const vector<pair<string, string>>& context,
+                    const vector<BenchStats>& results, const vector<BenchCheck>& checks);
+
+// 终端表格
+void PrintBenchTable(const vector<BenchStats>& results, const vector<BenchCheck>& checks);
+
+#endif  // BENCH_HARNESS_H_
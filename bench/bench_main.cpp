@@ -0,0 +1,369 @@
+// bench_main.cpp - 非求解热点路径的微基准 (LS-NTGF-Bench)
+// 在生成的算例 (见 instance_generator.h) 上按规模逐级测量:
+//   read_data           ReadData 读取 CSV
+//   merge_fg            UpdateBigOrderFG 流向-分组合并
+//   split_results       SplitBigOrderResults 大订单结果拆分
+//   model_build         完整模型构建并装载到 CPLEX (未合并实例，即 --no-merge)
+//   model_build_merged  同上，合并后的实例 (RF/RFO/RR 实际求解的规模)
+//   extract_plan        ExtractFinalPlan 读出最终计划
+//   plan_metrics        ComputePlanMetrics 成本分解与产能利用指标
+//   result_json         WriteResultJson 结果 JSON
+//   logger              Logger 格式化写入 10000 行
+// CPLEX 求解本身不计时；拆分与提取所需的解由固定取值的 LP 得到。
+//
+// 用法: LS-NTGF-Bench [--sizes 100x30,1000x30] [--reps n] [--baseline file] [--record] [--json file]
+
+#include "optimizer.h"
+#include "solve_driver.h"
+#include "lot_sizing_model.h"
+#include "plan_metrics.h"
+#include "cplex_pool.h"
+#include "logger.h"
+#include "instance_generator.h"
+#include "bench_harness.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct BenchSize {
+    int N = 0;
+    int T = 0;
+    string Label() const { return "N" + to_string(N) + "_T" + to_string(T); }
+};
+
+// "100x30,1000x30" -> [(100,30), (1000,30)]
+bool ParseSizes(const string& text, vector<BenchSize>& sizes) {
+    sizes.clear();
+    vector<string> tokens;
+    SplitString(text, tokens, ",");
+    for (const auto& token : tokens) {
+        size_t x = token.find('x');
+        if (x == string::npos) return false;
+        BenchSize size;
+        size.N = atoi(token.substr(0, x).c_str());
+        size.T = atoi(token.substr(x + 1).c_str());
+        if (size.N < 1 || size.T < 1) return false;
+        sizes.push_back(size);
+    }
+    return !sizes.empty();
+}
+
+void PrintBenchUsage(const char* program) {
+    cout << "Usage: " << program << " [options]\n\n"
+         << "Micro-benchmarks for parsing, merge, model build, extraction, metrics,\n"
+         << "result JSON and logging on generated instances.\n\n"
+         << "Options:\n"
+         << "  --sizes <NxT,...>        Instance sizes (default: 100x30,1000x30,10000x60)\n"
+         << "  --flows <n>              Flows per instance (default: 5)\n"
+         << "  --groups <n>             Groups per instance (default: 5)\n"
+         << "  --warmup <n>             Untimed runs per benchmark (default: 2)\n"
+         << "  --reps <n>               Timed runs per benchmark (default: 10)\n"
+         << "  --only <a,b,...>         Run only the named benchmarks\n"
+         << "  --work-dir <dir>         Generated instances and scratch files (default: ./bench_work)\n"
+         << "  --json <file>            Write results as JSON\n"
+         << "  --baseline <file>        Compare p50 against a baseline (INI)\n"
+         << "  --thresholds <file>      Per-benchmark tolerances (default: bench/thresholds.ini)\n"
+         << "  --record                 Write the results to --baseline instead of comparing\n"
+         << "  -h, --help               Show this help message\n\n"
+         << "Exit code is 2 when a benchmark regresses beyond its tolerance.\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    string sizes_text = "100x30,1000x30,10000x60";
+    int flows = 5;
+    int groups = 5;
+    BenchOptions options;
+    set<string> only;
+    string work_dir = "./bench_work";
+    string json_path;
+    string baseline_path;
+    string thresholds_path = "bench/thresholds.ini";
+    bool record = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            PrintBenchUsage(argv[0]);
+            return 0;
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            sizes_text = argv[++i];
+        } else if (arg == "--flows" && i + 1 < argc) {
+            flows = max(1, atoi(argv[++i]));
+        } else if (arg == "--groups" && i + 1 < argc) {
+            groups = max(1, atoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            options.warmup = max(0, atoi(argv[++i]));
+        } else if (arg == "--reps" && i + 1 < argc) {
+            options.repetitions = max(1, atoi(argv[++i]));
+        } else if (arg == "--only" && i + 1 < argc) {
+            vector<string> names;
+            SplitString(argv[++i], names, ",");
+            only.insert(names.begin(), names.end());
+        } else if (arg == "--work-dir" && i + 1 < argc) {
+            work_dir = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (arg == "--thresholds" && i + 1 < argc) {
+            thresholds_path = argv[++i];
+        } else if (arg == "--record") {
+            record = true;
+        } else {
+            cerr << "Unknown option: " << arg << "\n";
+            PrintBenchUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    vector<BenchSize> sizes;
+    if (!ParseSizes(sizes_text, sizes)) {
+        cerr << "[基准] 规模格式应为 NxT[,NxT...]: " << sizes_text << "\n";
+        return 1;
+    }
+    if (record && baseline_path.empty()) {
+        cerr << "[基准] --record 需要 --baseline 指定写入的文件\n";
+        return 1;
+    }
+    // 要求比较却没有基线时直接失败，避免 run-bench 在未记录基线的机器上空跑通过
+    if (!record && !baseline_path.empty() && !fs::exists(baseline_path)) {
+        cerr << "[基准] 基线不存在 (" << baseline_path << ")，先用 --record 记录\n";
+        return 1;
+    }
+    try {
+        fs::create_directories(work_dir);
+    } catch (const std::exception& e) {
+        cerr << "[基准] 无法创建目录: " << e.what() << "\n";
+        return 1;
+    }
+
+    auto selected = [&](const string& name) { return only.empty() || only.count(name) > 0; };
+
+    CommandLineArgs args;
+    args.cplex_workdir = work_dir;
+    args.cplex_threads = 1;
+    args.output_dir = work_dir;
+
+    vector<BenchStats> results;
+
+    for (const auto& size : sizes) {
+        string label = size.Label();
+        cout << "\n[基准] 实例 " << label << " (F=" << flows << " G=" << groups << ")\n";
+
+        // 生成算例
+        GeneratorParams gen;
+        gen.N = size.N;
+        gen.T = size.T;
+        gen.F = flows;
+        gen.G = groups;
+        string path = (fs::path(work_dir) / (DefaultInstanceName(gen) + ".csv")).string();
+        {
+            ofstream fout(path, ios::out | ios::binary);
+            if (!fout || !GenerateInstance(gen, fout)) {
+                cerr << "[基准] 生成算例失败: " << path << "\n";
+                return 1;
+            }
+        }
+        args.input_file = path;
+
+        // 读取
+        AllValues base_values;
+        AllLists base_lists;
+        if (selected("read_data")) {
+            results.push_back(RunBenchmark("read_data", label, options, nullptr, [&]() {
+                ReadData(base_values, base_lists, path);
+            }));
+        } else {
+            ScopedSilence silence;
+            ReadData(base_values, base_lists, path);
+        }
+        if (base_values.number_of_items <= 0) {
+            cerr << "[基准] 读取算例失败: " << path << "\n";
+            return 1;
+        }
+        ApplyArgs(args, base_values);
+
+        // 合并
+        AllValues merged_values = base_values;
+        AllLists merged_lists = base_lists;
+        if (selected("merge_fg")) {
+            results.push_back(RunBenchmark("merge_fg", label, options, [&]() {
+                merged_values = base_values;
+                merged_lists = base_lists;
+            }, [&]() {
+                UpdateBigOrderFG(merged_values, merged_lists);
+            }));
+        } else {
+            ScopedSilence silence;
+            UpdateBigOrderFG(merged_values, merged_lists);
+        }
+
+        try {
+            // 模型构建 (含装载到 CPLEX 与归还环境时清空模型)
+            auto build = [&](const AllValues& values, const AllLists& lists) {
+                CplexLease lease = AcquireCplex(values, 1e6);
+                IloModel model(lease.Env());
+                LotSizingVars vars;
+                BuildLotSizingModel(lease.Env(), model, values, lists, vars);
+                lease.Load(model);
+            };
+            if (selected("model_build")) {
+                results.push_back(RunBenchmark("model_build", label, options, nullptr, [&]() {
+                    build(base_values, base_lists);
+                }));
+            }
+            if (selected("model_build_merged")) {
+                results.push_back(RunBenchmark("model_build_merged", label, options, nullptr, [&]() {
+                    build(merged_values, merged_lists);
+                }));
+            }
+
+            // 结果拆分: 每个大订单 [T] 的 x/b/y/l/I 取固定值求解一次
+            if (selected("split_results")) {
+                int big_items = merged_values.number_of_items;
+                int T = merged_values.number_of_periods;
+                CplexLease lease = AcquireCplex(merged_values, 1e6);
+                IloEnv env = lease.Env();
+                IloModel model(env);
+                IloArray<IloNumVarArray> X(env, big_items), B(env, big_items), Y(env, big_items),
+                    L(env, big_items), I(env, big_items);
+                IloExpr total(env);
+                for (int i = 0; i < big_items; i++) {
+                    X[i] = IloNumVarArray(env, T, 1.0, 1.0);
+                    B[i] = IloNumVarArray(env, T, 0.0, 0.0);
+                    Y[i] = IloNumVarArray(env, T, 1.0, 1.0);
+                    L[i] = IloNumVarArray(env, T, 0.0, 0.0);
+                    I[i] = IloNumVarArray(env, T, 0.0, 0.0);
+                    total += IloSum(X[i]) + IloSum(B[i]) + IloSum(Y[i]) + IloSum(L[i]) + IloSum(I[i]);
+                }
+                model.add(IloMinimize(env, total));
+                total.end();
+                IloCplex& cplex = lease.Load(model);
+                cplex.solve();
+
+                AllValues split_values = merged_values;
+                AllLists split_lists = merged_lists;
+                results.push_back(RunBenchmark("split_results", label, options, [&]() {
+                    split_values.number_of_items = big_items;
+                }, [&]() {
+                    SplitBigOrderResults(split_values, split_lists, X, B, Y, L, I, cplex);
+                }));
+            }
+
+            // 计划提取、指标与结果 JSON: y = lambda = 0 固定后的 LP 解 (x = 0, u = 1)
+            AllValues plan_values = base_values;
+            AllLists plan_lists = base_lists;
+            int G = plan_values.number_of_groups;
+            int T = plan_values.number_of_periods;
+            plan_lists.small_y.assign(G, vector<int>(T, 0));
+            plan_lists.small_l.assign(G, vector<int>(T, 0));
+            if (selected("extract_plan") || selected("plan_metrics") || selected("result_json")) {
+                CplexLease lease = AcquireCplex(plan_values, 1e6);
+                IloEnv env = lease.Env();
+                IloModel model(env);
+                LotSizingVars vars;
+                BuildLotSizingModel(env, model, plan_values, plan_lists, vars);
+                for (int g = 0; g < G; g++) {
+                    for (int t = 0; t < T; t++) {
+                        vars.Y[g][t].setBounds(0, 0);
+                        vars.Lambda[g][t].setBounds(0, 0);
+                    }
+                    model.add(IloConversion(env, vars.Y[g], ILOFLOAT));
+                    model.add(IloConversion(env, vars.Lambda[g], ILOFLOAT));
+                }
+                model.add(IloConversion(env, vars.U, ILOFLOAT));
+                IloCplex& cplex = lease.Load(model);
+                if (!cplex.solve()) {
+                    cerr << "[基准] 固定 LP 求解失败，跳过提取/指标/JSON\n";
+                } else {
+                    ExtractFinalPlan(cplex, plan_values, plan_lists, vars.X, vars.B, vars.I, vars.U);
+                    if (selected("extract_plan")) {
+                        results.push_back(RunBenchmark("extract_plan", label, options, nullptr, [&]() {
+                            ExtractFinalPlan(cplex, plan_values, plan_lists,
+                                             vars.X, vars.B, vars.I, vars.U);
+                        }));
+                    }
+                }
+            }
+            if (selected("plan_metrics") && !plan_lists.small_x.empty()) {
+                results.push_back(RunBenchmark("plan_metrics", label, options, nullptr, [&]() {
+                    ComputePlanMetrics(plan_values, plan_lists);
+                }));
+            }
+            if (selected("result_json") && !plan_lists.small_x.empty()) {
+                ComputePlanMetrics(plan_values, plan_lists);
+                SolveSummary summary;
+                summary.objective = 0.0;
+                summary.runtime = 0.0;
+                results.push_back(RunBenchmark("result_json", label, options, nullptr, [&]() {
+                    ostringstream json;
+                    WriteResultJson(json, args, plan_values, plan_lists, summary);
+                }));
+            }
+        } catch (IloException& e) {
+            cerr << "[基准] CPLEX错误: " << e.getMessage() << "\n";
+            CplexPool::Instance().Shutdown();
+            return 1;
+        }
+
+        // 日志吞吐 (与实例规模无关，只在第一个规模上测量)
+        if (selected("logger") && &size == &sizes.front()) {
+            Logger logger((fs::path(work_dir) / "bench_logger").string());
+            results.push_back(RunBenchmark("logger", label, options, nullptr, [&]() {
+                for (int k = 0; k < 10000; k++) {
+                    LOG_FMT("[基准] 迭代 %d 目标=%.2f 时间=%.3fs\n", k, k * 1.5, k * 0.001);
+                }
+            }));
+        }
+    }
+
+    CplexPool::Instance().Shutdown();
+
+    // 基线比较或记录
+    vector<BenchCheck> checks;
+    int exit_code = 0;
+    if (record) {
+        if (!WriteBenchBaseline(baseline_path, results)) return 1;
+        cout << "\n[基准] 基线已写入: " << baseline_path << "\n";
+    } else if (!baseline_path.empty()) {
+        BenchBaseline baseline;
+        map<string, double> tolerance;
+        if (!ReadBenchBaseline(baseline_path, baseline)) {
+            return 1;
+        }
+        if (fs::exists(thresholds_path) && !ReadBenchTolerance(thresholds_path, tolerance)) return 1;
+        checks = CompareWithBaseline(results, baseline, tolerance);
+        for (const auto& c : checks) {
+            if (c.status == "regression") exit_code = 2;
+        }
+    }
+
+    PrintBenchTable(results, checks);
+
+    if (!json_path.empty()) {
+        ofstream fout(json_path);
+        if (!fout) {
+            cerr << "[基准] 无法写入: " << json_path << "\n";
+            return 1;
+        }
+        vector<pair<string, string>> context = {
+            {"sizes", sizes_text},
+            {"flows", to_string(flows)},
+            {"groups", to_string(groups)},
+            {"warmup", to_string(options.warmup)},
+            {"repetitions", to_string(options.repetitions)},
+            {"baseline", baseline_path},
+        };
+        WriteBenchJson(fout, context, results, checks);
+        cout << "[基准] 结果已写入: " << json_path << "\n";
+    }
+
+    if (exit_code != 0) {
+        cout << "[基准] 存在超出阈值的性能回归\n";
+    }
+    return exit_code;
+}
@@ -2,6 +2,7 @@
 // 包含大订单的合并、求解、拆分、验证等功能
 
 #include "optimizer.h"
+#include "cplex_pool.h"
 #include <map>
 #include <algorithm>
 #include <iostream>
@@ -349,7 +350,9 @@ void SolveBigOrder(AllValues& values, AllLists& lists) {
     cout << "\n[大订单求解器] 启动...\n";
 
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, values.cpx_runtime_limit);
+        IloEnv env = lease.Env();
         IloModel model(env);
 
         IloArray<IloNumVarArray> X(env, values.number_of_items);
@@ -364,6 +367,9 @@ void SolveBigOrder(AllValues& values, AllLists& lists) {
             B[i] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
         }
 
+        // 变量随环境归还结束 (见 cplex_pool.h)
+        for (auto vars : {X, Y, I, B}) lease.Own(vars);
+
         IloExpr objective(env);
 
         for (int i = 0; i < values.number_of_items; i++) {
@@ -421,12 +427,7 @@ void SolveBigOrder(AllValues& values, AllLists& lists) {
             }
         }
 
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, values.cpx_runtime_limit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        IloCplex& cplex = lease.Load(model);
 
         auto start = chrono::steady_clock::now();
         bool solved = cplex.solve();
@@ -456,8 +457,6 @@ void SolveBigOrder(AllValues& values, AllLists& lists) {
             values.result_big_order.gap = -1.0;
         }
 
-        env.end();
-
     } catch (IloException& e) {
         cout << "[错误] CPLEX: " << e << "\n";
         values.result_big_order.objective = -1.0;
@@ -0,0 +1,177 @@
+// child_solve.cpp - 子进程求解实现
+
+#include "child_solve.h"
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+#ifdef _WIN32
+// CommandLineToArgvW / MSVC CRT 的解析规则: 含空白或引号的参数加引号，
+// 引号前与结尾的反斜杠加倍
+string QuoteWindowsArg(const string& arg) {
+    if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == string::npos) {
+        return arg;
+    }
+    string quoted = "\"";
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            backslashes++;
+            continue;
+        }
+        if (c == '"') {
+            quoted.append(backslashes * 2 + 1, '\\');
+        } else {
+            quoted.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        quoted += c;
+    }
+    quoted.append(backslashes * 2, '\\');
+    quoted += '"';
+    return quoted;
+}
+
+int SpawnAndWait(const vector<string>& command) {
+    string line;
+    for (const auto& arg : command) {
+        line += (line.empty() ? "" : " ") + QuoteWindowsArg(arg);
+    }
+
+    SECURITY_ATTRIBUTES sa{sizeof(sa), nullptr, TRUE};
+    HANDLE null_handle = CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &sa,
+                                     OPEN_EXISTING, 0, nullptr);
+    STARTUPINFOA si{};
+    si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+    si.hStdOutput = null_handle;
+    si.hStdError = null_handle;
+    PROCESS_INFORMATION pi{};
+    BOOL started = CreateProcessA(nullptr, line.data(), nullptr, nullptr, TRUE, 0,
+                                  nullptr, nullptr, &si, &pi);
+    if (null_handle != INVALID_HANDLE_VALUE) CloseHandle(null_handle);
+    if (!started) return -1;
+
+    WaitForSingleObject(pi.hProcess, INFINITE);
+    DWORD code = 0;
+    GetExitCodeProcess(pi.hProcess, &code);
+    CloseHandle(pi.hProcess);
+    CloseHandle(pi.hThread);
+    return static_cast<int>(code);
+}
+#else
+int SpawnAndWait(const vector<string>& command) {
+    vector<char*> argv;
+    for (const auto& arg : command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    // 标准输出与标准错误丢弃
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    pid_t pid;
+    int rc = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) return -1;
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+#endif
+
+}  // namespace
+
+string ResolveProgram(const string& program) {
+#ifndef _WIN32
+    std::error_code ec;
+    fs::path self = fs::read_symlink("/proc/self/exe", ec);
+    if (!ec) return self.string();
+#endif
+    return fs::absolute(program).string();
+}
+
+vector<string> ChildSolveCommand(const string& program, const vector<string>& options,
+                                 const fs::path& run_dir, const string& instance) {
+    vector<string> command = {program};
+    command.insert(command.end(), options.begin(), options.end());
+    command.insert(command.end(), {"-o", run_dir.string(),
+                                   "-l", (run_dir / "solve").string(),
+                                   "-f", instance});
+    return command;
+}
+
+vector<string> SplitOptions(const string& text) {
+    vector<string> options;
+    istringstream in(text);
+    string token;
+    while (in >> token) {
+        options.push_back(token);
+    }
+    return options;
+}
+
+ChildSolveResult RunChildSolve(const vector<string>& command, const fs::path& run_dir) {
+    ChildSolveResult result;
+
+    auto start = chrono::steady_clock::now();
+    result.exit_code = SpawnAndWait(command);
+    result.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(run_dir, ec)) {
+        string name = entry.path().filename().string();
+        if (entry.path().extension() != ".json" || name.find("_result_") == string::npos) continue;
+        ifstream fin(entry.path());
+        stringstream buffer;
+        buffer << fin.rdbuf();
+        string text = buffer.str();
+        result.objective = JsonNumber(text, "objective", -1.0);
+        result.solve_time = JsonNumber(text, "solve_time", -1.0);
+        result.nodes = static_cast<long>(JsonNumber(text, "nodes", -1.0));
+        result.root_bound = JsonNumber(text, "root_bound", -1.0);
+        result.status = result.objective >= 0 ? JsonString(text, "status") : "no_solution";
+        break;
+    }
+    if (result.objective < 0 && result.exit_code != 0) {
+        result.status = "failed";
+    }
+    if (result.status.empty()) {
+        result.status = "completed";
+    }
+    return result;
+}
+
+double JsonNumber(const string& text, const string& key, double fallback) {
+    size_t pos = text.find("\"" + key + "\":");
+    if (pos == string::npos) return fallback;
+    return strtod(text.c_str() + pos + key.size() + 3, nullptr);
+}
+
+string JsonString(const string& text, const string& key) {
+    size_t pos = text.find("\"" + key + "\": \"");
+    if (pos == string::npos) return "";
+    size_t begin = pos + key.size() + 5;
+    size_t end = text.find('"', begin);
+    return end == string::npos ? "" : text.substr(begin, end - begin);
+}
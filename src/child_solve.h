@@ -0,0 +1,43 @@
+// child_solve.h - 子进程求解
+// 调参 (tune.h) 与回归套件 (regress.h) 共用: 以本程序的子进程求解一个实例
+// (输出目录与日志放在 run_dir，终端输出丢弃)，再从 run_dir 中的结果 JSON 读取目标、状态与节点数
+
+#ifndef CHILD_SOLVE_H_
+#define CHILD_SOLVE_H_
+
+#include "optimizer.h"
+#include <filesystem>
+
+// 子进程求解结果
+struct ChildSolveResult {
+    string status = "failed";   // completed / interrupted / no_solution / failed
+    double objective = -1.0;
+    double time = 0.0;          // 子进程墙钟时间
+    double solve_time = -1.0;   // 结果 JSON 的 solve_time
+    long nodes = -1;            // 结果 JSON 的 metrics.cplex.nodes
+    double root_bound = -1.0;   // 结果 JSON 的 bound.root_bound (--root-bound off 时为 -1)
+    int exit_code = 0;          // 子进程退出码，无法启动或被信号终止时为 -1
+};
+
+// 本程序路径 (Linux 取 /proc/self/exe，不依赖启动方式)
+string ResolveProgram(const string& program);
+
+// 子进程参数表: program options... -o run_dir -l run_dir/solve -f instance
+// 参数逐个传给子进程 (不经 shell)，路径与参数值中的空格、引号无需转义
+vector<string> ChildSolveCommand(const string& program, const vector<string>& options,
+                                 const std::filesystem::path& run_dir, const string& instance);
+
+// 按空白切分附加参数 (如套件文件的 options，不支持引号)
+vector<string> SplitOptions(const string& text);
+
+// 启动子进程 (POSIX: posix_spawn，Windows: CreateProcess)，终端输出丢弃；
+// 等待结束后读取 run_dir 中的结果 JSON (run_dir 需已创建)
+ChildSolveResult RunChildSolve(const vector<string>& command, const std::filesystem::path& run_dir);
+
+// 结果 JSON 中第一个 "key": 后的数值
+double JsonNumber(const string& text, const string& key, double fallback);
+
+// 结果 JSON 中第一个 "key": "value"
+string JsonString(const string& text, const string& key);
+
+#endif  // CHILD_SOLVE_H_
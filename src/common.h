@@ -96,6 +96,10 @@ inline string GetCurrentTimestamp() {
     return ss.str();
 }
 
+inline double SecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
 // 字符串工具函数
 inline string ToString(int value) {
     return to_string(value);
@@ -107,6 +111,30 @@ inline string ToString(double value, int precision = 6) {
     return ss.str();
 }
 
+// JSON 字符串转义 (结果 JSON、服务响应、子问题转储共用)，其余控制字符输出为 \u00XX
+inline string JsonEscape(const string& s) {
+    string out;
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+    return out;
+}
+
 // 向量工具函数
 template<typename T>
 inline void ClearVector(vector<T>& vec) {
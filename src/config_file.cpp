@@ -0,0 +1,68 @@
+// config_file.cpp - INI 配置文件实现
+
+#include "config_file.h"
+
+static string TrimConfig(const string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+const string* ConfigSection::Find(const string& key) const {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->first == key) return &it->second;
+    }
+    return nullptr;
+}
+
+bool ReadConfigFile(const string& path, vector<ConfigSection>& sections) {
+    ifstream fin(path);
+    if (!fin) {
+        cerr << "[配置] 无法打开: " << path << "\n";
+        return false;
+    }
+
+    sections.clear();
+    sections.push_back(ConfigSection());
+
+    string line;
+    int line_no = 0;
+    while (getline(fin, line)) {
+        line_no++;
+        line = TrimConfig(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+
+        if (line[0] == '[') {
+            if (line.back() != ']') {
+                cerr << "[配置] " << path << ":" << line_no << " 节名缺少 ]\n";
+                return false;
+            }
+            ConfigSection section;
+            section.name = TrimConfig(line.substr(1, line.size() - 2));
+            sections.push_back(section);
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == string::npos || eq == 0) {
+            cerr << "[配置] " << path << ":" << line_no << " 应为 key = value\n";
+            return false;
+        }
+        sections.back().entries.emplace_back(TrimConfig(line.substr(0, eq)),
+                                             TrimConfig(line.substr(eq + 1)));
+    }
+
+    // 没有全局键时去掉空的匿名节
+    if (sections.front().entries.empty()) {
+        sections.erase(sections.begin());
+    }
+    return true;
+}
+
+const ConfigSection* FindConfigSection(const vector<ConfigSection>& sections, const string& name) {
+    for (const auto& section : sections) {
+        if (section.name == name) return &section;
+    }
+    return nullptr;
+}
@@ -0,0 +1,28 @@
+// config_file.h - INI 配置文件
+// 参数配置 (--profile，调参器输出见 tune.h) 与 CPLEX 参数配置共用的读取器:
+//   ; 或 # 开头为注释
+//   [节名]
+//   key = value
+// 第一个节之前的键属于名称为空的节。键名与值去除首尾空白，值中的行尾注释不剥离
+
+#ifndef CONFIG_FILE_H_
+#define CONFIG_FILE_H_
+
+#include "optimizer.h"
+
+// 配置文件中的一节 (键按文件顺序保存，允许重复键)
+struct ConfigSection {
+    string name;
+    vector<pair<string, string>> entries;
+
+    // 最后一个同名键的值，不存在时返回 nullptr
+    const string* Find(const string& key) const;
+};
+
+// 读取配置文件；格式错误时输出行号并返回 false
+bool ReadConfigFile(const string& path, vector<ConfigSection>& sections);
+
+// 按名称查找节，不存在时返回 nullptr
+const ConfigSection* FindConfigSection(const vector<ConfigSection>& sections, const string& name);
+
+#endif  // CONFIG_FILE_H_
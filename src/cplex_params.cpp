@@ -0,0 +1,278 @@
+// cplex_params.cpp - CPLEX 参数配置实现
+
+#include "cplex_params.h"
+#include "logger.h"
+#include <functional>
+
+namespace {
+
+// 按参数类型解析文本值并设置 (Concert 的参数常量按类型区分重载)
+bool SetParamText(IloCplex& cplex, IloCplex::IntParam param, const string& value) {
+    char* end = nullptr;
+    long v = strtol(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0') return false;
+    cplex.setParam(param, static_cast<IloInt>(v));
+    return true;
+}
+
+bool SetParamText(IloCplex& cplex, IloCplex::LongParam param, const string& value) {
+    char* end = nullptr;
+    long long v = strtoll(value.c_str(), &end, 10);
+    if (end == value.c_str() || *end != '\0') return false;
+    cplex.setParam(param, static_cast<CPXLONG>(v));
+    return true;
+}
+
+bool SetParamText(IloCplex& cplex, IloCplex::NumParam param, const string& value) {
+    char* end = nullptr;
+    double v = strtod(value.c_str(), &end);
+    if (end == value.c_str() || *end != '\0') return false;
+    cplex.setParam(param, v);
+    return true;
+}
+
+bool SetParamText(IloCplex& cplex, IloCplex::BoolParam param, const string& value) {
+    if (value == "true" || value == "1") {
+        cplex.setParam(param, true);
+    } else if (value == "false" || value == "0") {
+        cplex.setParam(param, false);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 当前值不是默认值时写成文本，否则返回空串
+template <typename P>
+string NonDefaultText(IloCplex& cplex, P param) {
+    if (cplex.getParam(param) == cplex.getDefault(param)) return "";
+    ostringstream ss;
+    ss << cplex.getParam(param);
+    return ss.str();
+}
+
+string NonDefaultText(IloCplex& cplex, IloCplex::BoolParam param) {
+    if (cplex.getParam(param) == cplex.getDefault(param)) return "";
+    return cplex.getParam(param) ? "true" : "false";
+}
+
+struct CplexParamEntry {
+    const char* key;
+    std::function<bool(IloCplex&, const string&)> set;
+    std::function<string(IloCplex&)> non_default;
+};
+
+template <typename P>
+CplexParamEntry Entry(const char* key, P param) {
+    return {key,
+            [param](IloCplex& cplex, const string& value) { return SetParamText(cplex, param, value); },
+            [param](IloCplex& cplex) { return NonDefaultText(cplex, param); }};
+}
+
+const vector<CplexParamEntry>& ParamTable() {
+    using P = IloCplex::Param;
+    static const vector<CplexParamEntry> table = {
+        Entry("emphasis", P::Emphasis::MIP),
+        Entry("probe", P::MIP::Strategy::Probe),
+        Entry("heuristic_freq", P::MIP::Strategy::HeuristicFreq),
+        Entry("rins", P::MIP::Strategy::RINSHeur),
+        Entry("fp_heur", P::MIP::Strategy::FPHeur),
+        Entry("lb_heur", P::MIP::Strategy::LBHeur),
+        Entry("node_select", P::MIP::Strategy::NodeSelect),
+        Entry("variable_select", P::MIP::Strategy::VariableSelect),
+        Entry("branch", P::MIP::Strategy::Branch),
+        Entry("search", P::MIP::Strategy::Search),
+        Entry("dive", P::MIP::Strategy::Dive),
+        Entry("start_algorithm", P::MIP::Strategy::StartAlgorithm),
+        Entry("sub_algorithm", P::MIP::Strategy::SubAlgorithm),
+        Entry("cut_passes", P::MIP::Limits::CutPasses),
+        Entry("cuts_gomory", P::MIP::Cuts::Gomory),
+        Entry("cuts_mir", P::MIP::Cuts::MIRCut),
+        Entry("cuts_flow_covers", P::MIP::Cuts::FlowCovers),
+        Entry("cuts_covers", P::MIP::Cuts::Covers),
+        Entry("cuts_implied", P::MIP::Cuts::Implied),
+        Entry("cuts_zero_half", P::MIP::Cuts::ZeroHalfCut),
+        Entry("cuts_lift_proj", P::MIP::Cuts::LiftProj),
+        Entry("cuts_cliques", P::MIP::Cuts::Cliques),
+        Entry("cuts_disjunctive", P::MIP::Cuts::Disjunctive),
+        Entry("cuts_mcf", P::MIP::Cuts::MCFCut),
+        Entry("cuts_path", P::MIP::Cuts::PathCut),
+        Entry("presolve", P::Preprocessing::Presolve),
+        Entry("symmetry", P::Preprocessing::Symmetry),
+        Entry("repeat_presolve", P::Preprocessing::RepeatPresolve),
+        Entry("reduce", P::Preprocessing::Reduce),
+        Entry("mip_gap", P::MIP::Tolerances::MIPGap),
+        Entry("parallel", P::Parallel),
+        Entry("random_seed", P::RandomSeed),
+    };
+    return table;
+}
+
+const CplexParamEntry* FindEntry(const string& key) {
+    for (const auto& entry : ParamTable()) {
+        if (key == entry.key) return &entry;
+    }
+    return nullptr;
+}
+
+// 检查一节配置的参数名与取值格式 (数值或 true/false)，越界由 CPLEX 在设置时检查
+bool CheckProfileSection(const string& path, const ConfigSection& section) {
+    for (const auto& [key, value] : section.entries) {
+        if (!IsCplexParamKey(key)) {
+            cerr << "[配置] " << path << " [" << section.name << "] 未知 CPLEX 参数: " << key << "\n";
+            return false;
+        }
+        char* end = nullptr;
+        strtod(value.c_str(), &end);
+        bool numeric = end != value.c_str() && *end == '\0';
+        if (!numeric && value != "true" && value != "false") {
+            cerr << "[配置] " << path << " [" << section.name << "] " << key
+                 << " 的值无效: " << value << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool IsCplexParamKey(const string& key) {
+    return FindEntry(key) != nullptr;
+}
+
+vector<string> CplexParamKeys() {
+    vector<string> keys;
+    for (const auto& entry : ParamTable()) keys.push_back(entry.key);
+    return keys;
+}
+
+bool ApplyCplexParam(IloCplex& cplex, const string& key, const string& value) {
+    const CplexParamEntry* entry = FindEntry(key);
+    return entry != nullptr && entry->set(cplex, value);
+}
+
+void ApplyCplexProfile(IloCplex& cplex, const ConfigSection& profile) {
+    for (const auto& [key, value] : profile.entries) {
+        if (!ApplyCplexParam(cplex, key, value)) {
+            LOG_FMT("[CPLEX] 配置 [%s] 参数 %s=%s 无法解析，已跳过\n",
+                    profile.name.c_str(), key.c_str(), value.c_str());
+        }
+    }
+}
+
+bool ReadCplexProfiles(const string& path, vector<ConfigSection>& profiles) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) {
+        return false;
+    }
+    profiles.clear();
+    for (auto& section : sections) {
+        if (section.name.empty()) continue;
+        if (!CheckProfileSection(path, section)) return false;
+        profiles.push_back(std::move(section));
+    }
+    return true;
+}
+
+vector<pair<string, string>> NonDefaultCplexParams(IloCplex& cplex) {
+    vector<pair<string, string>> params;
+    for (const auto& entry : ParamTable()) {
+        string value = entry.non_default(cplex);
+        if (!value.empty()) params.emplace_back(entry.key, value);
+    }
+    return params;
+}
+
+const vector<string>& CplexPhaseNames() {
+    static const vector<string> names = {
+        "rf_window", "rf_final", "fo_window", "fo_final",
+        "rr_step1", "rr_step2", "rr_step3", "direct",
+    };
+    return names;
+}
+
+bool ReadCplexPhaseProfiles(const string& path, map<string, CplexPhaseProfile>& phases) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) {
+        return false;
+    }
+    const auto& names = CplexPhaseNames();
+    auto is_phase = [&](const string& name) {
+        return std::find(names.begin(), names.end(), name) != names.end();
+    };
+
+    // [phases] 之外的节都是参数配置
+    vector<ConfigSection> profiles;
+    const ConfigSection* mapping = nullptr;
+    for (const auto& section : sections) {
+        if (section.name == "phases") {
+            mapping = &section;
+        } else if (!section.name.empty()) {
+            profiles.push_back(section);
+        }
+    }
+    for (const auto& profile : profiles) {
+        if (!CheckProfileSection(path, profile)) return false;
+    }
+    auto find_profile = [&](const string& name) -> const ConfigSection* {
+        for (const auto& profile : profiles) {
+            if (profile.name == name) return &profile;
+        }
+        return nullptr;
+    };
+
+    phases.clear();
+    if (mapping != nullptr) {
+        for (const auto& [phase, name] : mapping->entries) {
+            if (!is_phase(phase)) {
+                cerr << "[配置] " << path << " [phases] 未知阶段: " << phase << "\n";
+                return false;
+            }
+            const ConfigSection* profile = find_profile(name);
+            if (profile == nullptr) {
+                cerr << "[配置] " << path << " [phases] " << phase << " 引用的配置不存在: " << name << "\n";
+                return false;
+            }
+            phases[phase] = {profile->name, profile->entries};
+        }
+    }
+    for (const auto& phase : names) {
+        if (phases.count(phase) > 0) continue;
+        if (const ConfigSection* profile = find_profile(phase)) {
+            phases[phase] = {profile->name, profile->entries};
+        }
+    }
+    return true;
+}
+
+bool ApplyCplexPhase(IloCplex& cplex, const AllValues& values, const string& phase) {
+    auto it = values.cplex_phase_profiles.find(phase);
+    if (it == values.cplex_phase_profiles.end() || it->second.params.empty()) {
+        return false;
+    }
+    for (const auto& [key, value] : it->second.params) {
+        try {
+            if (!ApplyCplexParam(cplex, key, value)) {
+                LOG_FMT("[CPLEX] 阶段 %s 参数 %s=%s 无法解析，已跳过\n",
+                        phase.c_str(), key.c_str(), value.c_str());
+            }
+        } catch (IloException& e) {
+            LOG_FMT("[CPLEX] 阶段 %s 参数 %s=%s 无效: %s\n",
+                    phase.c_str(), key.c_str(), value.c_str(), e.getMessage());
+        }
+    }
+    return true;
+}
+
+void LogCplexPhaseProfiles(const AllValues& values) {
+    for (const auto& phase : CplexPhaseNames()) {
+        auto it = values.cplex_phase_profiles.find(phase);
+        if (it == values.cplex_phase_profiles.end()) continue;
+        string text;
+        for (const auto& [key, value] : it->second.params) {
+            text += (text.empty() ? "" : " ") + key + "=" + value;
+        }
+        LOG_FMT("[CPLEX] 阶段 %s 使用配置 [%s]: %s\n", phase.c_str(), it->second.name.c_str(),
+                text.empty() ? "(默认参数)" : text.c_str());
+    }
+}
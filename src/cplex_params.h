@@ -0,0 +1,54 @@
+// cplex_params.h - CPLEX 参数配置
+// CPLEX 参数配置文件 (INI，见 config_file.h) 每一节为一个命名配置，键为下表中的参数名:
+//   [small_window]
+//   emphasis = 1
+//   heuristic_freq = 5
+// 只开放对子问题求解影响较大的参数 (强调、探测、启发式、割平面、分支策略、预处理、容差、并行)，
+// 时限、线程数与工作目录仍由调用方设置。值按参数类型解析，取值范围由 CPLEX 在设置时检查
+//
+// 分阶段配置 (--cplex-profiles): 同一文件中的 [phases] 节把求解阶段映射到配置名，
+// 没有映射的阶段使用与阶段同名的节 (LS-NTGF-Replay --tune-param 按阶段名输出)，都没有时用 CPLEX 默认值:
+//   [phases]
+//   rf_window = small_window
+//   fo_window = small_window
+// 阶段: rf_window、rf_final (RF 与 RFO 的 RF 部分)、fo_window、fo_final、
+//       rr_step1、rr_step2、rr_step3、direct (完整模型直接求解与系数扫描)
+
+#ifndef CPLEX_PARAMS_H_
+#define CPLEX_PARAMS_H_
+
+#include "optimizer.h"
+#include "config_file.h"
+
+// 参数名是否可用
+bool IsCplexParamKey(const string& key);
+
+// 全部参数名 (按表顺序)
+vector<string> CplexParamKeys();
+
+// 设置一个参数；参数名未知或值无法解析时返回 false，取值越界时 CPLEX 抛出 IloException
+bool ApplyCplexParam(IloCplex& cplex, const string& key, const string& value);
+
+// 设置一个配置中的全部参数 (无法解析的值记日志并跳过)
+void ApplyCplexProfile(IloCplex& cplex, const ConfigSection& profile);
+
+// 读取配置文件并检查参数名；匿名节 (第一个节之前的键) 被忽略
+bool ReadCplexProfiles(const string& path, vector<ConfigSection>& profiles);
+
+// 表中取值不是默认值的参数 (调参结果导出)
+vector<pair<string, string>> NonDefaultCplexParams(IloCplex& cplex);
+
+// 求解阶段名
+const vector<string>& CplexPhaseNames();
+
+// 读取分阶段配置 ([phases] 映射与同名节)，参数名与取值格式的检查同 ReadCplexProfiles
+bool ReadCplexPhaseProfiles(const string& path, map<string, CplexPhaseProfile>& phases);
+
+// 设置阶段的参数 (没有配置时不做任何事)；返回是否设置了参数。
+// 值无法按参数类型解析或被 CPLEX 拒绝时记日志并跳过该参数 (读取时已检查格式)
+bool ApplyCplexPhase(IloCplex& cplex, const AllValues& values, const string& phase);
+
+// 日志输出各阶段使用的配置
+void LogCplexPhaseProfiles(const AllValues& values);
+
+#endif  // CPLEX_PARAMS_H_
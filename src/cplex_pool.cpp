@@ -0,0 +1,262 @@
+// cplex_pool.cpp - CPLEX 环境池实现
+//
+// 归还时先 clearModel 并移除通用回调，再结束模型中的全部约束与目标，
+// 最后结束借用方登记的变量数组 (Own)，环境在子问题间不累积模型对象。
+// 环境内存超过上限时 (未登记的零散对象或 CPLEX 内部缓存) 整体 end() 并在下次借出时重建
+
+#include "cplex_pool.h"
+#include "cplex_params.h"
+#include "logger.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include <chrono>
+
+namespace {
+
+constexpr double kCplexPoolMemoryLimit = 512.0 * 1024 * 1024;  // 单个环境内存上限 (字节)
+
+// 结束数组中的变量 (跳过空句柄) 与数组本身
+void EndVarArray(IloNumVarArray& vars) {
+    if (!vars.getImpl()) return;
+    for (IloInt j = 0; j < vars.getSize(); j++) {
+        if (vars[j].getImpl()) vars[j].end();
+    }
+    vars.end();
+}
+
+// 通用参数 (与各求解器原有设置一致)
+void ApplyProfile(CplexSlot& slot, const AllValues& values) {
+    slot.cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
+    slot.cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
+    slot.cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+    slot.workdir = values.cplex_workdir;
+    slot.workmem = values.cplex_workmem;
+}
+
+}  // namespace
+
+CplexLease::CplexLease(CplexLease&& other) noexcept
+    : pool_(other.pool_), slot_(other.slot_), model_(other.model_), loaded_(other.loaded_),
+      owned_vars_(std::move(other.owned_vars_)), owned_matrices_(std::move(other.owned_matrices_)) {
+    other.slot_ = nullptr;
+    other.loaded_ = false;
+}
+
+CplexLease::~CplexLease() {
+    if (slot_ != nullptr) {
+        pool_->Release(*this);
+    }
+}
+
+void CplexLease::Own(IloNumVarArray vars) {
+    owned_vars_.push_back(vars);
+}
+
+void CplexLease::Own(IloArray<IloNumVarArray> vars) {
+    owned_matrices_.push_back(vars);
+}
+
+IloCplex& CplexLease::Load(const IloModel& model) {
+    auto start = std::chrono::steady_clock::now();
+    slot_->cplex.extract(model);
+    model_ = model;
+    loaded_ = true;
+    pool_->AddOverhead(SecondsSince(start));
+    return slot_->cplex;
+}
+
+void CplexLease::ApplyPhase(const AllValues& values, const std::string& phase) {
+    if (ApplyCplexPhase(slot_->cplex, values, phase)) {
+        slot_->phase_params = true;
+    }
+}
+
+CplexPool& CplexPool::Instance() {
+    static CplexPool pool;
+    return pool;
+}
+
+CplexPool::~CplexPool() {
+    Shutdown();
+}
+
+CplexLease CplexPool::Acquire(const AllValues& values, double time_limit, int threads) {
+    auto start = std::chrono::steady_clock::now();
+    bool interrupted_before = g_interrupt.Requested();
+
+    CplexSlot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& candidate : slots_) {
+            if (!candidate->busy) {
+                slot = candidate.get();
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            slots_.push_back(std::make_unique<CplexSlot>());
+            slot = slots_.back().get();
+        }
+        slot->busy = true;
+    }
+
+    // 环境创建 (许可证检出) 在锁外进行
+    bool created = false;
+    try {
+        if (!slot->ready) {
+            slot->env.emplace();
+            slot->cplex = IloCplex(*slot->env);
+            slot->cplex.setOut(slot->env->getNullStream());
+            slot->aborter = IloCplex::Aborter(*slot->env);
+            slot->cplex.use(slot->aborter);
+            ApplyProfile(*slot, values);
+            slot->ready = true;
+            created = true;
+        } else if (slot->phase_params) {
+            // 上一次借出设置了阶段参数，恢复默认后重设通用参数
+            slot->cplex.setDefaults();
+            ApplyProfile(*slot, values);
+            slot->phase_params = false;
+        } else if (slot->workdir != values.cplex_workdir ||
+                   slot->workmem != values.cplex_workmem) {
+            ApplyProfile(*slot, values);
+        }
+        // 先清除再登记: 登记之后到达的中断由监视线程中止；登记失败说明中断已请求，
+        // 此后的 Clamp 给出收尾时限。任何借出的时限都不超过全局截止时间
+        slot->aborter.clear();
+        bool registered = g_interrupt.Register(&slot->aborter);
+        slot->cplex.setParam(IloCplex::TiLim, g_interrupt.Clamp(g_deadline.Clamp(time_limit)));
+        if (!registered && !interrupted_before) {
+            // 中断在借出过程中到达，本次求解属于中断前的迭代，直接中止
+            slot->aborter.abort();
+        }
+        slot->cplex.setParam(IloCplex::Threads, threads);
+    } catch (...) {
+        g_interrupt.Unregister(&slot->aborter);
+        std::lock_guard<std::mutex> lock(mutex_);
+        slot->busy = false;
+        throw;
+    }
+
+    double elapsed = SecondsSince(start);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.leases++;
+        if (created) {
+            stats_.envs_created++;
+            stats_.startup_time += elapsed;
+        } else {
+            stats_.warm_leases++;
+            stats_.overhead_time += elapsed;
+        }
+    }
+    return CplexLease(this, slot);
+}
+
+void CplexPool::AddOverhead(double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.overhead_time += seconds;
+}
+
+void CplexPool::Release(CplexLease& lease) {
+    auto start = std::chrono::steady_clock::now();
+    CplexSlot* slot = lease.slot_;
+    IloModel model = lease.model_;
+    bool loaded = lease.loaded_;
+    g_interrupt.Unregister(&slot->aborter);
+
+    bool keep = slot->ready;
+    if (keep) {
+        try {
+            slot->cplex.use(static_cast<IloCplex::Callback::Function*>(nullptr), 0);
+            slot->cplex.setOut(slot->env->getNullStream());
+            if (loaded) {
+                slot->cplex.clearModel();
+                vector<IloExtractable> contents;
+                for (IloModel::Iterator it(model); it.ok(); ++it) {
+                    contents.push_back(*it);
+                }
+                for (auto& extractable : contents) {
+                    extractable.end();
+                }
+                model.end();
+            }
+            // 变量在引用它们的约束之后结束
+            for (auto& matrix : lease.owned_matrices_) {
+                if (!matrix.getImpl()) continue;
+                for (IloInt i = 0; i < matrix.getSize(); i++) {
+                    EndVarArray(matrix[i]);
+                }
+                matrix.end();
+            }
+            for (auto& vars : lease.owned_vars_) {
+                EndVarArray(vars);
+            }
+            keep = slot->env->getMemoryUsage() <= kCplexPoolMemoryLimit;
+        } catch (...) {
+            keep = false;
+        }
+    }
+
+    bool recycled = false;
+    if (!keep && slot->ready) {
+        try {
+            slot->aborter.end();
+            slot->cplex.end();
+            slot->env->end();
+        } catch (...) {
+        }
+        slot->env.reset();
+        slot->ready = false;
+        recycled = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->busy = false;
+    if (recycled) {
+        stats_.envs_recycled++;
+    }
+    stats_.overhead_time += SecondsSince(start);
+}
+
+CplexPoolStats CplexPool::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void CplexPool::Shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& slot : slots_) {
+        if (slot->busy || !slot->ready) continue;
+        try {
+            slot->aborter.end();
+            slot->cplex.end();
+            slot->env->end();
+        } catch (...) {
+        }
+        slot->env.reset();
+        slot->ready = false;
+    }
+}
+
+CplexLease AcquireCplex(const AllValues& values, double time_limit) {
+    return CplexPool::Instance().Acquire(values, time_limit, values.cplex_threads);
+}
+
+void RecordCplexPoolStats(AllValues& values) {
+    CplexPoolStats stats = CplexPool::Instance().Stats();
+    if (stats.leases == 0) {
+        return;
+    }
+
+    auto& m = values.metrics;
+    m.pool_envs_created = stats.envs_created;
+    m.pool_leases = stats.leases;
+    m.pool_warm_leases = stats.warm_leases;
+    m.pool_startup_time = stats.startup_time;
+    m.pool_overhead_time = stats.overhead_time;
+
+    LOG_FMT("[环境池] 环境创建=%d (重建=%d) 借出=%ld 复用=%ld 创建耗时=%.3fs 单次开销=%.4fs\n",
+            stats.envs_created, stats.envs_recycled, stats.leases, stats.warm_leases,
+            stats.startup_time, stats.overhead_time / stats.leases);
+}
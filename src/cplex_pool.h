@@ -0,0 +1,113 @@
+// cplex_pool.h - CPLEX 环境池
+// RF/FO/RR 子问题不再各自创建并 end() 自己的 IloEnv: 池中保存已完成环境初始化、
+// 许可证检出和通用参数设置的 (IloEnv, IloCplex)，按需借出，求解后清空模型归还。
+// 每个并发使用者 (工作线程) 同时占用一个环境，空闲环境在后续子问题间复用。
+//
+// 通用参数 (Strategy::File / WorkDir / WorkMem) 在环境创建时设置，
+// 时限与线程数在每次借出时设置；调用方额外设置的参数归还时不复原，
+// 需要特殊参数的求解 (后台下界) 不使用本池。
+// 分阶段参数配置 (ApplyPhase，见 cplex_params.h) 例外: 设置过的环境下次借出时先恢复默认参数
+// 每个环境带一个 Aborter，借出期间登记到中断控制器 (见 interrupt.h)
+
+#ifndef CPLEX_POOL_H_
+#define CPLEX_POOL_H_
+
+#include "optimizer.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+
+// 池统计 (进程内累计)
+struct CplexPoolStats {
+    int envs_created = 0;          // 创建的环境数
+    int envs_recycled = 0;         // 因内存上限重建的环境数
+    long leases = 0;               // 借出次数
+    long warm_leases = 0;          // 复用已有环境的借出次数
+    double startup_time = 0.0;     // 环境创建耗时 (初始化 + 许可证 + 通用参数)
+    double overhead_time = 0.0;    // 借出/装载模型/归还耗时 (不含求解)
+};
+
+// 池中的一个环境
+struct CplexSlot {
+    std::optional<IloEnv> env;     // 借出时创建 (IloEnv 默认构造即分配环境)
+    IloCplex cplex;
+    IloCplex::Aborter aborter;     // 已挂到 cplex，每次借出时清除
+    bool ready = false;            // 环境与求解器已创建
+    bool busy = false;             // 已借出
+    std::string workdir;           // 已设置的通用参数
+    int workmem = 0;
+    bool phase_params = false;     // 设置过分阶段参数，下次借出时恢复默认
+};
+
+class CplexPool;
+
+// 借出的环境，析构时归还 (RAII)
+class CplexLease {
+public:
+    CplexLease(CplexLease&& other) noexcept;
+    CplexLease(const CplexLease&) = delete;
+    CplexLease& operator=(const CplexLease&) = delete;
+    CplexLease& operator=(CplexLease&&) = delete;
+    ~CplexLease();
+
+    IloEnv Env() const { return *slot_->env; }
+
+    // 求解器的 Aborter (中断与并行重试淘汰共用)
+    IloCplex::Aborter& Aborter() const { return slot_->aborter; }
+
+    // 装载模型，返回已配置好参数的求解器 (每次借出只装载一次)
+    IloCplex& Load(const IloModel& model);
+
+    // 设置阶段参数配置 (见 cplex_params.h)，在 Load 之后、求解之前调用
+    void ApplyPhase(const AllValues& values, const std::string& phase);
+
+    // 登记本次求解创建的变量数组: 归还时在约束与模型之后结束其中的变量和数组本身
+    // (空句柄跳过)。每个变量只登记一次；只引用已登记变量的数组 (回调、MIP start) 由使用者自行 end()
+    void Own(IloNumVarArray vars);
+    void Own(IloArray<IloNumVarArray> vars);
+
+private:
+    friend class CplexPool;
+    CplexLease(CplexPool* pool, CplexSlot* slot) : pool_(pool), slot_(slot) {}
+
+    CplexPool* pool_ = nullptr;
+    CplexSlot* slot_ = nullptr;
+    IloModel model_;
+    bool loaded_ = false;
+    vector<IloNumVarArray> owned_vars_;
+    vector<IloArray<IloNumVarArray>> owned_matrices_;
+};
+
+class CplexPool {
+public:
+    static CplexPool& Instance();
+
+    ~CplexPool();
+
+    // 借出环境: time_limit 为本次求解时限，threads 为 CPLEX 线程数 (0=自动)
+    CplexLease Acquire(const AllValues& values, double time_limit, int threads);
+
+    CplexPoolStats Stats() const;
+
+    // 结束全部空闲环境 (程序退出前调用)
+    void Shutdown();
+
+private:
+    friend class CplexLease;
+    CplexPool() = default;
+
+    void AddOverhead(double seconds);
+    void Release(CplexLease& lease);
+
+    mutable std::mutex mutex_;
+    vector<std::unique_ptr<CplexSlot>> slots_;
+    CplexPoolStats stats_;
+};
+
+// 使用 values 中的线程数从全局池借出环境
+CplexLease AcquireCplex(const AllValues& values, double time_limit);
+
+// 池统计并入 values.metrics 并输出日志
+void RecordCplexPoolStats(AllValues& values);
+
+#endif  // CPLEX_POOL_H_
@@ -0,0 +1,97 @@
+// deadline.cpp - 全局截止时间调度实现
+
+#include "deadline.h"
+
+namespace {
+
+constexpr double kDeadlineMinBudget = 1.0;        // 单次求解最短时限 (秒)
+constexpr double kDeadlineMinReserve = 2.0;       // 最终求解预留下限 (秒)
+constexpr double kDeadlineReserveFraction = 0.05; // 最终求解预留占总时限比例
+constexpr double kDeadlineShareStretch = 2.0;     // 历史耗时低于份额时的放宽倍数
+
+}  // namespace
+
+DeadlineScheduler g_deadline;
+
+void DeadlineScheduler::Start(double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    start_ = chrono::steady_clock::now();
+    limit_ = max(0.0, seconds);
+    solves_ = 0;
+    solve_total_ = 0.0;
+    wrapped_up_ = false;
+}
+
+double DeadlineScheduler::Elapsed() const {
+    return chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+}
+
+double DeadlineScheduler::Remaining() const {
+    if (!Enabled()) {
+        return numeric_limits<double>::infinity();
+    }
+    return max(0.0, limit_ - Elapsed());
+}
+
+double DeadlineScheduler::MeanSolve() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return solves_ > 0 ? solve_total_ / solves_ : 0.0;
+}
+
+double DeadlineScheduler::Reserve() const {
+    double reserve = max(kDeadlineMinReserve, kDeadlineReserveFraction * limit_);
+    reserve = max(reserve, MeanSolve());
+    return min(reserve, 0.5 * limit_);
+}
+
+double DeadlineScheduler::Budget(double base, int remaining_solves) const {
+    if (!Enabled()) {
+        return base;
+    }
+    double available = Remaining() - Reserve();
+    double share = available / max(1, remaining_solves);
+    double mean = MeanSolve();
+    if (mean > 0.0 && mean < share) {
+        share = min(available, kDeadlineShareStretch * share);
+    }
+    double budget = max(kDeadlineMinBudget, min(base, share));
+    return min(budget, max(kDeadlineMinBudget, Remaining()));
+}
+
+double DeadlineScheduler::FinalBudget(double base) const {
+    if (!Enabled()) {
+        return base;
+    }
+    return max(kDeadlineMinBudget, min(base, Remaining()));
+}
+
+double DeadlineScheduler::Clamp(double base) const {
+    if (!Enabled()) {
+        return base;
+    }
+    return max(kDeadlineMinBudget, min(base, Remaining()));
+}
+
+bool DeadlineScheduler::ShouldWrapUp() const {
+    if (!Enabled()) {
+        return false;
+    }
+    double mean = MeanSolve();
+    return Remaining() <= Reserve() + max(kDeadlineMinBudget, mean);
+}
+
+void DeadlineScheduler::RecordSolve(double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    solves_++;
+    solve_total_ += seconds;
+}
+
+void DeadlineScheduler::MarkWrapUp() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wrapped_up_ = true;
+}
+
+bool DeadlineScheduler::WrappedUp() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return wrapped_up_;
+}
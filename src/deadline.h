@@ -0,0 +1,60 @@
+// deadline.h - 全局截止时间调度
+// --deadline 给出整个进程的墙钟时间上限 (从程序启动计时)。子问题不再各用固定时限，
+// 而是向调度器申请预算:
+//   可用时间 = 剩余时间 - 最终求解预留
+//   预算     = min(原时限, 可用时间 / 剩余子问题数)
+// 已观测子问题平均耗时低于均分份额时允许单个子问题用到两倍份额 (难窗口多用，易窗口省下的时间
+// 自动留给后续)；预留量取 max(下限, 总时限的固定比例, 平均子问题耗时)。
+// 剩余时间只够预留时各算法停止迭代、直接收尾。
+// 所有 CPLEX 调用 (含环境池借出) 的时限另外截断到剩余时间；未设置截止时间时各接口原样返回原时限
+
+#ifndef DEADLINE_H_
+#define DEADLINE_H_
+
+#include "common.h"
+#include <mutex>
+
+class DeadlineScheduler {
+public:
+    // seconds <= 0 表示不限时
+    void Start(double seconds);
+
+    bool Enabled() const { return limit_ > 0.0; }
+    double Limit() const { return limit_; }
+    double Elapsed() const;
+    double Remaining() const;              // 未启用时为无穷大
+
+    // 子问题时限: base 为原时限，remaining_solves 为包括本次在内预计还需求解的子问题数
+    double Budget(double base, int remaining_solves) const;
+
+    // 最终求解时限: 剩余全部时间 (不超过 base)
+    double FinalBudget(double base) const;
+
+    // 任意 CPLEX 调用的时限上限 min(base, 剩余时间)
+    double Clamp(double base) const;
+
+    // 剩余时间只够最终求解，应停止迭代收尾
+    bool ShouldWrapUp() const;
+
+    // 记录一次子问题求解耗时 (线程安全)
+    void RecordSolve(double seconds);
+
+    // 收尾标记 (写入结果)
+    void MarkWrapUp();
+    bool WrappedUp() const;
+
+private:
+    double Reserve() const;
+    double MeanSolve() const;
+
+    mutable std::mutex mutex_;
+    chrono::steady_clock::time_point start_ = chrono::steady_clock::now();
+    double limit_ = 0.0;
+    int solves_ = 0;
+    double solve_total_ = 0.0;
+    bool wrapped_up_ = false;
+};
+
+extern DeadlineScheduler g_deadline;
+
+#endif  // DEADLINE_H_
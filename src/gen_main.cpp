@@ -0,0 +1,133 @@
+// gen_main.cpp - 算例生成器主程序 (LS-NTGF-Gen)
+// 生成 ReadData 格式的 CSV 算例，不依赖 CPLEX，见 instance_generator.h
+//
+// 用法: LS-NTGF-Gen [-N n] [-T n] [-F n] [-G n] [options] [-o 目录或文件]
+
+#include "instance_generator.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static void PrintGenUsage(const char* program) {
+    GeneratorParams d;
+    cout << "Usage: " << program << " [options]\n\n"
+         << "Generates lot-sizing instances in the CSV layout read by LS-NTGF-All.\n"
+         << "Output is byte-identical for the same options and seed on every platform.\n\n"
+         << "Size:\n"
+         << "  -N <n>                   Number of orders (default: " << d.N << ")\n"
+         << "  -T <n>                   Number of periods (default: " << d.T << ")\n"
+         << "  -F <n>                   Number of flows (default: " << d.F << ")\n"
+         << "  -G <n>                   Number of groups (default: " << d.G << ")\n\n"
+         << "Structure:\n"
+         << "  --capacity <n>           Capacity per period (default: " << d.capacity << ")\n"
+         << "                           Solve with the same --capacity if not 1440\n"
+         << "  --tightness <r>          Production load / total capacity (default: " << d.tightness << ")\n"
+         << "  --window-min <n>         Minimum time window width (default: " << d.window_min << ")\n"
+         << "  --window-max <n>         Maximum time window width (default: " << d.window_max << ")\n"
+         << "  --setup-cost-ratio <r>   Setup cost / (holding cost * family demand per period)\n"
+         << "                           (default: " << d.setup_cost_ratio << ")\n"
+         << "  --setup-time-ratio <r>   Setup time / capacity per period (default: " << d.setup_time_ratio << ")\n\n"
+         << "Output:\n"
+         << "  --seed <n>               Random seed (default: " << d.seed << ")\n"
+         << "  --count <n>              Generate n instances with seeds seed..seed+n-1 (default: 1)\n"
+         << "  --name <s>               case_id (default: gen_N<N>_T<T>_F<F>_G<G>_s<seed>)\n"
+         << "  -o, --output <path>      Output directory, or .csv file when --count is 1\n"
+         << "                           (default: ./data)\n"
+         << "  -h, --help               Show this help message\n\n"
+         << "Examples:\n"
+         << "  " << program << " -N 100 -T 30 -F 5 -G 5 --seed 7\n"
+         << "  " << program << " -N 100000 -T 365 -F 10 -G 10 --tightness 0.85 -o big.csv\n";
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorParams params;
+    string output = "./data";
+    int count = 1;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            PrintGenUsage(argv[0]);
+            return 0;
+        } else if (arg == "-N" && i + 1 < argc) {
+            params.N = atoi(argv[++i]);
+        } else if (arg == "-T" && i + 1 < argc) {
+            params.T = atoi(argv[++i]);
+        } else if (arg == "-F" && i + 1 < argc) {
+            params.F = atoi(argv[++i]);
+        } else if (arg == "-G" && i + 1 < argc) {
+            params.G = atoi(argv[++i]);
+        } else if (arg == "--capacity" && i + 1 < argc) {
+            params.capacity = atoi(argv[++i]);
+        } else if (arg == "--tightness" && i + 1 < argc) {
+            params.tightness = atof(argv[++i]);
+        } else if (arg == "--window-min" && i + 1 < argc) {
+            params.window_min = atoi(argv[++i]);
+        } else if (arg == "--window-max" && i + 1 < argc) {
+            params.window_max = atoi(argv[++i]);
+        } else if (arg == "--setup-cost-ratio" && i + 1 < argc) {
+            params.setup_cost_ratio = atof(argv[++i]);
+        } else if (arg == "--setup-time-ratio" && i + 1 < argc) {
+            params.setup_time_ratio = atof(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            params.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--count" && i + 1 < argc) {
+            count = max(1, atoi(argv[++i]));
+        } else if (arg == "--name" && i + 1 < argc) {
+            params.name = argv[++i];
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            cerr << "Unknown option: " << arg << "\n";
+            PrintGenUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!ValidateGeneratorParams(params)) {
+        return 1;
+    }
+
+    // 单个算例且输出以 .csv 结尾时直接写该文件，否则写入目录
+    bool single_file = count == 1 && fs::path(output).extension() == ".csv";
+    try {
+        fs::path dir = single_file ? fs::path(output).parent_path() : fs::path(output);
+        if (!dir.empty()) fs::create_directories(dir);
+    } catch (const std::exception& e) {
+        cerr << "[生成] 无法创建目录: " << e.what() << "\n";
+        return 1;
+    }
+
+    string base_name = params.name;
+    uint64_t first_seed = params.seed;
+    for (int k = 0; k < count; k++) {
+        params.seed = first_seed + static_cast<uint64_t>(k);
+        params.name = base_name.empty() || count == 1 ? base_name : base_name + "_" + to_string(k + 1);
+        string file_name = params.name.empty() ? DefaultInstanceName(params) : params.name;
+        fs::path path = single_file ? fs::path(output) : fs::path(output) / (file_name + ".csv");
+
+        auto start = chrono::steady_clock::now();
+        ofstream fout(path, ios::out | ios::binary);  // 二进制模式，各平台均为 LF 换行
+        GeneratedInstanceStats stats;
+        if (!fout || !GenerateInstance(params, fout, &stats)) {
+            cerr << "[生成] 写入失败: " << path.string() << "\n";
+            return 1;
+        }
+        fout.close();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "[生成] " << path.string() << "\n"
+             << "       N=" << params.N << " T=" << params.T << " F=" << params.F
+             << " G=" << params.G << " seed=" << params.seed
+             << fixed << setprecision(3)
+             << " 利用率=" << stats.utilization << " setup占比=" << stats.setup_share
+             << " 用时=" << elapsed << "秒\n" << defaultfloat;
+    }
+    if (params.G * llround(params.setup_time_ratio * params.capacity) >= params.capacity) {
+        cout << "[警告] 全部分组同期 setup 的占用超过每期产能，可考虑减小 --setup-time-ratio\n";
+    }
+    if (params.capacity != 1440) {
+        cout << "[生成] 产能为 " << params.capacity << "，求解时加 --capacity " << params.capacity << "\n";
+    }
+    return 0;
+}
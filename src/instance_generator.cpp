@@ -0,0 +1,178 @@
+// instance_generator.cpp - 算例生成实现
+
+#include "instance_generator.h"
+
+namespace {
+
+// 随机数: mt19937_64 的输出序列由标准规定，而 uniform_int_distribution 等分布的实现
+// 各标准库不同，同一种子在 MSVC 与 libstdc++ 上会得到不同算例。这里自行做区间映射
+class GeneratorRng {
+public:
+    explicit GeneratorRng(uint64_t seed) : engine_(seed) {}
+
+    // [lo, hi] 内均匀整数 (拒绝采样，无取模偏差)
+    long long UniformInt(long long lo, long long hi) {
+        uint64_t range = static_cast<uint64_t>(hi - lo) + 1;
+        if (range == 0) return lo + static_cast<long long>(engine_());
+        uint64_t limit = numeric_limits<uint64_t>::max() - numeric_limits<uint64_t>::max() % range;
+        uint64_t x;
+        do {
+            x = engine_();
+        } while (x >= limit);
+        return lo + static_cast<long long>(x % range);
+    }
+
+private:
+    mt19937_64 engine_;
+};
+
+// 以百分之一为单位的金额写成两位小数 (不经过浮点格式化)
+string FormatCents(long long cents) {
+    string frac = to_string(cents % 100);
+    if (frac.size() < 2) frac = "0" + frac;
+    return to_string(cents / 100) + "." + frac;
+}
+
+struct GeneratedOrder {
+    int group;
+    int flow;
+    int demand;
+    int ew;
+    int lw;
+    int usage;
+    long long cost_cents;
+};
+
+}  // namespace
+
+bool ValidateGeneratorParams(const GeneratorParams& params) {
+    auto fail = [](const string& msg) {
+        cerr << "[生成] 参数无效: " << msg << "\n";
+        return false;
+    };
+    if (params.N < 1 || params.T < 1 || params.F < 1 || params.G < 1) {
+        return fail("N、T、F、G 须为正整数");
+    }
+    if (params.capacity < 1) return fail("capacity 须为正整数");
+    if (!(params.tightness > 0.0)) return fail("tightness 须大于 0");
+    if (params.window_min < 1 || params.window_max < params.window_min) {
+        return fail("时间窗宽度须满足 1 <= window_min <= window_max");
+    }
+    if (params.window_min > params.T) return fail("window_min 超过周期数");
+    if (params.setup_cost_ratio < 0.0 || params.setup_time_ratio < 0.0) {
+        return fail("setup 比例不能为负");
+    }
+    return true;
+}
+
+string DefaultInstanceName(const GeneratorParams& params) {
+    return "gen_N" + to_string(params.N) + "_T" + to_string(params.T) +
+           "_F" + to_string(params.F) + "_G" + to_string(params.G) +
+           "_s" + to_string(params.seed);
+}
+
+bool GenerateInstance(const GeneratorParams& params, ostream& out, GeneratedInstanceStats* stats) {
+    if (!ValidateGeneratorParams(params)) {
+        return false;
+    }
+
+    const int N = params.N;
+    const int T = params.T;
+    const int F = params.F;
+    const int G = params.G;
+    GeneratorRng rng(params.seed);
+
+    // 流向库存成本 [0.50, 2.00]
+    vector<long long> cost_i_cents(F);
+    for (int f = 0; f < F; f++) {
+        cost_i_cents[f] = rng.UniformInt(50, 200);
+    }
+
+    // 订单 (需求量暂为未缩放的原始值)
+    int window_max = min(params.window_max, T);
+    vector<GeneratedOrder> orders(N);
+    double raw_load = 0.0;
+    for (auto& order : orders) {
+        order.group = static_cast<int>(rng.UniformInt(0, G - 1));
+        order.flow = static_cast<int>(rng.UniformInt(0, F - 1));
+        int width = static_cast<int>(rng.UniformInt(params.window_min, window_max));
+        order.ew = static_cast<int>(rng.UniformInt(0, T - width));
+        order.lw = order.ew + width - 1;
+        order.usage = static_cast<int>(rng.UniformInt(1, 3));
+        order.cost_cents = rng.UniformInt(100, 500);
+        order.demand = static_cast<int>(rng.UniformInt(1, 100));
+        raw_load += static_cast<double>(order.demand) * order.usage;
+    }
+
+    // 缩放需求量到目标利用率；取整误差 (按产能占用计) 结转到下一订单，大 N 时总占用不漂移
+    double target_load = params.tightness * T * params.capacity;
+    double scale = target_load / raw_load;
+    double carry = 0.0;
+    long long total_demand = 0;
+    long long production_load = 0;
+    vector<long long> group_demand(G, 0);
+    for (auto& order : orders) {
+        double exact_load = order.demand * scale * order.usage;
+        order.demand = static_cast<int>(max(1LL, llround((exact_load + carry) / order.usage)));
+        carry += exact_load - static_cast<double>(order.demand) * order.usage;
+        total_demand += order.demand;
+        production_load += static_cast<long long>(order.demand) * order.usage;
+        group_demand[order.group] += order.demand;
+    }
+
+    // 下游能力: 订单需求在时间窗内均摊 (余数给前几期)
+    vector<vector<long long>> period_demand(F, vector<long long>(T, 0));
+    for (const auto& order : orders) {
+        int periods = order.lw - order.ew + 1;
+        int per_period = order.demand / periods;
+        int remaining = order.demand % periods;
+        for (int t = order.ew; t <= order.lw; t++) {
+            period_demand[order.flow][t] += per_period + (remaining > 0 ? 1 : 0);
+            if (remaining > 0) remaining--;
+        }
+    }
+
+    // 族参数
+    double mean_cost_i = 0.0;
+    for (long long c : cost_i_cents) mean_cost_i += c / 100.0;
+    mean_cost_i /= F;
+    int usage_y = static_cast<int>(llround(params.setup_time_ratio * params.capacity));
+    vector<long long> cost_y(G);
+    for (int g = 0; g < G; g++) {
+        double per_period = static_cast<double>(group_demand[g]) / T;
+        cost_y[g] = max(1LL, llround(params.setup_cost_ratio * mean_cost_i * per_period));
+    }
+
+    // 写出 (格式与 ReadData 一致)
+    out << "case_id," << (params.name.empty() ? DefaultInstanceName(params) : params.name) << "\n";
+    out << "T," << T << "\n";
+    out << "F," << F << "\n";
+    out << "G," << G << "\n";
+    out << "cost_y";
+    for (int g = 0; g < G; g++) out << "," << cost_y[g];
+    out << "\ncost_i";
+    for (int f = 0; f < F; f++) out << "," << FormatCents(cost_i_cents[f]);
+    out << "\nusage_y";
+    for (int g = 0; g < G; g++) out << "," << usage_y;
+    out << "\nN," << N << "\n";
+    for (int f = 0; f < F; f++) {
+        out << "demand_f" << (f + 1);
+        for (int t = 0; t < T; t++) out << "," << period_demand[f][t];
+        out << "\n";
+    }
+    for (int i = 0; i < N; i++) {
+        const auto& order = orders[i];
+        out << "order_" << (i + 1) << "," << (i + 1) << "," << (order.group + 1) << ","
+            << (order.flow + 1) << "," << order.demand << "," << order.ew << "," << order.lw << ","
+            << order.usage << "," << FormatCents(order.cost_cents) << "\n";
+    }
+
+    if (stats != nullptr) {
+        stats->total_demand = total_demand;
+        stats->production_load = production_load;
+        stats->utilization = static_cast<double>(production_load) /
+                             (static_cast<double>(T) * params.capacity);
+        stats->setup_share = static_cast<double>(G) * usage_y / params.capacity;
+    }
+    return static_cast<bool>(out);
+}
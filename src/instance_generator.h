@@ -0,0 +1,56 @@
+// instance_generator.h - 算例生成
+// 生成与 ReadData 读取格式相同的 CSV 算例 (见 README 14.6)，供扩展性测试与基准使用，
+// 不依赖 CPLEX。给定参数与种子时输出逐字节确定 (跨平台、跨标准库)。
+//
+// 生成方式:
+//   订单      分组、流向均匀分配；时间窗宽度在 [window_min, window_max] 内均匀，位置在计划期内均匀
+//   产能消耗  usage_x 在 [1, 3] 内均匀，生产成本在 [1.00, 5.00] 内均匀
+//   需求量    先在 [1, 100] 内均匀抽取，再整体缩放使 sum(需求 * usage_x) = tightness * T * capacity
+//             (不含 setup 占用；取整后的实际利用率由 GeneratedInstanceStats 给出)
+//   下游能力  demand_f 行为各流向订单需求在时间窗内的均摊 (与合并后重建周期需求的方式一致)
+//   族参数    usage_y = setup_time_ratio * capacity；
+//             cost_y = setup_cost_ratio * 平均库存成本 * 该族平均每期需求 (TBO 约为 sqrt(2 * ratio) 期)
+//
+// ReadData 固定产能为 1440，capacity 取其他值时求解需加 --capacity
+
+#ifndef INSTANCE_GENERATOR_H_
+#define INSTANCE_GENERATOR_H_
+
+#include "common.h"
+#include <cstdint>
+
+// 生成参数
+struct GeneratorParams {
+    int N = 100;                    // 订单数
+    int T = 30;                     // 周期数
+    int F = 5;                      // 流向数
+    int G = 5;                      // 分组数
+    int capacity = 1440;            // 每期产能
+    double tightness = 0.7;         // 产能利用率 (生产占用 / 总产能)
+    int window_min = 1;             // 时间窗最小宽度 (周期)
+    int window_max = 5;             // 时间窗最大宽度 (周期)
+    double setup_cost_ratio = 2.0;  // 启动成本 / (库存成本 * 每期族需求)
+    double setup_time_ratio = 0.05; // 启动产能 / 每期产能
+    uint64_t seed = 1;
+    string name;                    // case_id，空时按参数命名
+};
+
+// 生成结果统计
+struct GeneratedInstanceStats {
+    long long total_demand = 0;
+    long long production_load = 0;  // sum(需求 * usage_x)
+    double utilization = 0.0;        // production_load / (T * capacity)
+    double setup_share = 0.0;        // 全部族每期 setup 一次的产能占比
+};
+
+// 检查参数，不合法时输出原因并返回 false
+bool ValidateGeneratorParams(const GeneratorParams& params);
+
+// 缺省文件名: gen_N<N>_T<T>_F<F>_G<G>_s<seed>.csv
+string DefaultInstanceName(const GeneratorParams& params);
+
+// 生成算例写入 out；stats 非空时写入统计
+bool GenerateInstance(const GeneratorParams& params, ostream& out,
+                      GeneratedInstanceStats* stats = nullptr);
+
+#endif  // INSTANCE_GENERATOR_H_
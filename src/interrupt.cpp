@@ -0,0 +1,142 @@
+// interrupt.cpp - 协作式中断实现
+//
+// 信号处理函数只累加计数 (async-signal-safe)，由监视线程轮询后转为中断请求，
+// 加锁、写日志与 Aborter::abort 都在监视线程中进行
+
+#include "interrupt.h"
+#include "logger.h"
+#include <csignal>
+
+namespace {
+
+constexpr int kInterruptPollMs = 50;     // 监视线程轮询间隔 (毫秒)
+constexpr int kInterruptExitCode = 130;  // 第二次信号时的退出码
+
+volatile std::sig_atomic_t g_signal_count = 0;
+
+extern "C" void HandleInterruptSignal(int) {
+    g_signal_count = g_signal_count + 1;
+    if (g_signal_count > 1) {
+        std::_Exit(kInterruptExitCode);
+    }
+}
+
+// stdin 命令: GUI 发送一行 cancel/stop 请求中断
+bool IsCancelCommand(string line) {
+    line.erase(std::remove_if(line.begin(), line.end(),
+                              [](unsigned char c) { return std::isspace(c); }),
+               line.end());
+    for (char& c : line) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return line == "cancel" || line == "stop" || line == "[cancel]";
+}
+
+}  // namespace
+
+InterruptController g_interrupt;
+
+InterruptController::~InterruptController() {
+    Shutdown();
+}
+
+void InterruptController::Install(bool listen_stdin, double grace) {
+    grace_ = max(1.0, grace);
+    std::signal(SIGINT, HandleInterruptSignal);
+    std::signal(SIGTERM, HandleInterruptSignal);
+
+    if (!monitor_.joinable()) {
+        stop_ = false;
+        monitor_ = std::thread(&InterruptController::Monitor, this);
+    }
+
+    // getline 无法可移植地中断，读取线程分离运行，随进程结束
+    if (listen_stdin) {
+        std::thread([this]() {
+            string line;
+            while (std::getline(cin, line)) {
+                if (IsCancelCommand(line)) {
+                    Request("stdin");
+                }
+            }
+        }).detach();
+    }
+}
+
+void InterruptController::Shutdown() {
+    stop_ = true;
+    if (monitor_.joinable()) {
+        monitor_.join();
+    }
+}
+
+void InterruptController::Request(const char* source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (requested_) {
+        return;
+    }
+    source_ = source;
+    requested_ = true;
+}
+
+string InterruptController::Source() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return source_;
+}
+
+void InterruptController::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (g_signal_count > 0) {
+        return;
+    }
+    requested_ = false;
+    dispatched_ = false;
+    source_.clear();
+}
+
+bool InterruptController::Register(IloCplex::Aborter* aborter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (requested_) {
+        return false;
+    }
+    aborters_.push_back(aborter);
+    return true;
+}
+
+void InterruptController::Unregister(IloCplex::Aborter* aborter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborters_.erase(std::remove(aborters_.begin(), aborters_.end(), aborter), aborters_.end());
+}
+
+double InterruptController::Clamp(double base) const {
+    return requested_ ? min(base, grace_) : base;
+}
+
+void InterruptController::Monitor() {
+    while (!stop_) {
+        if (g_signal_count > 0) {
+            Request("signal");
+        }
+        if (requested_ && !dispatched_) {
+            Dispatch();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(kInterruptPollMs));
+    }
+}
+
+void InterruptController::Dispatch() {
+    size_t aborted = 0;
+    string source;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!requested_ || dispatched_) {
+            return;  // 期间已被 Reset
+        }
+        for (IloCplex::Aborter* aborter : aborters_) {
+            aborter->abort();
+        }
+        aborted = aborters_.size();
+        source = source_;
+        dispatched_ = true;
+    }
+    LOG_FMT("\n[中断] 收到中断请求 (%s)，中止 %zu 个求解，以当前最好结果收尾 (收尾时限 %.1fs)\n",
+            source.c_str(), aborted, grace_);
+}
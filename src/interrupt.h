@@ -0,0 +1,83 @@
+// interrupt.h - 协作式中断
+// SIGINT/SIGTERM 或 stdin 命令 (GUI 发送 "cancel") 触发中断请求:
+//   1. 监视线程中止全部已登记的 CPLEX 求解 (环境池借出的求解器均已登记)
+//   2. 各算法在循环中检查 Requested()，停止迭代并用已有结果补全计划
+//      (RF 以已固定前缀为基础，剩余周期合并为一个窗口快速求解)
+//   3. 请求之后开始的求解不再登记，时限截断到收尾时限，保证能产出完整计划
+// 结果照常写入 JSON，summary.status 为 "interrupted"。
+// 第二次收到信号时直接退出进程
+
+#ifndef INTERRUPT_H_
+#define INTERRUPT_H_
+
+#include "optimizer.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class InterruptController {
+public:
+    InterruptController() = default;
+    ~InterruptController();
+
+    InterruptController(const InterruptController&) = delete;
+    InterruptController& operator=(const InterruptController&) = delete;
+
+    // 注册信号处理并启动监视线程；listen_stdin 为 true 时另外监听 stdin 命令
+    // grace 为中断后每次收尾求解的时限 (秒)
+    void Install(bool listen_stdin, double grace);
+
+    // 停止监视线程 (程序退出前调用)
+    void Shutdown();
+
+    // 请求中断 (线程安全，source 写入日志)
+    void Request(const char* source);
+
+    bool Requested() const { return requested_.load(); }
+
+    // 请求来源 ("signal" / "stdin" / 调用方给出的名称)
+    string Source();
+
+    // 清除中断状态 (服务模式下每个请求开始前调用；信号计数不清除)
+    void Reset();
+
+    // 登记/解除正在求解的 Aborter；已请求中断时不再登记并返回 false
+    bool Register(IloCplex::Aborter* aborter);
+    void Unregister(IloCplex::Aborter* aborter);
+
+    // 中断后的求解时限 min(base, grace)，未中断时原样返回
+    double Clamp(double base) const;
+
+private:
+    void Monitor();
+    void Dispatch();
+
+    std::atomic<bool> requested_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> dispatched_{false};
+    double grace_ = 10.0;
+    string source_;
+
+    std::mutex mutex_;
+    vector<IloCplex::Aborter*> aborters_;
+    std::thread monitor_;
+};
+
+extern InterruptController g_interrupt;
+
+// 在作用域内登记 Aborter (不经环境池的求解使用)
+class InterruptScope {
+public:
+    explicit InterruptScope(IloCplex::Aborter* aborter) : aborter_(aborter) {
+        g_interrupt.Register(aborter_);
+    }
+    ~InterruptScope() { g_interrupt.Unregister(aborter_); }
+
+    InterruptScope(const InterruptScope&) = delete;
+    InterruptScope& operator=(const InterruptScope&) = delete;
+
+private:
+    IloCplex::Aborter* aborter_;
+};
+
+#endif  // INTERRUPT_H_
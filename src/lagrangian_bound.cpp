@@ -0,0 +1,325 @@
+// lagrangian_bound.cpp - Lagrangian 下界实现
+//
+// 松弛模型 (每一步都只放松约束，因此对偶值是原 MILP 的合法下界):
+//   1. 对偶化产能约束   sum_i s_i x_it + sum_g s_g y_gt <= C            乘子 mu_t >= 0
+//   2. 对偶化 carryover  sum_g lambda_gt <= 1                           乘子 nu_t >= 0
+//   3. 对偶化订单总量   sum_t x_it <= d_i (由 B_{i,T-1} >= 0 推出)       乘子 pi_i >= 0
+//   4. 去掉下游流平衡/能力约束 (库存成本非负) 和约束9
+//   5. u_i 放松为连续，此时 u_i = (d_i - sum_t x_it) / d_i
+//
+// 代入欠交定义后，订单 i 的成本为
+//   cb_i d_i (T - l_i) + cu_i + sum_{t>=e_i} x_it [cx_i - cb_i (T - max(t, l_i)) - cu_i / d_i]
+// 于是每个大类 g 的子问题是:
+//   每期状态 {关闭, 启动(y), 跨期(lambda)}，跨期要求上一期处于启动或跨期
+//   开放周期内大类生产受 Big-M 上限 C 约束，最优生产为分数背包 (贪心)
+// 用 3 状态动态规划精确求解
+
+#include "lagrangian_bound.h"
+#include "logger.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include <array>
+#include <thread>
+
+namespace {
+
+constexpr double kInf = 1e30;
+
+// 子问题输入 (与乘子无关的部分)
+struct LRData {
+    int N = 0;
+    int T = 0;
+    int G = 0;
+    double capacity = 0.0;
+    double constant = 0.0;            // sum_i [cb_i d_i (T - l_i) + cu_i]
+    vector<vector<int>> group_items;  // [g] 大类包含的订单 (g == G 为无大类订单)
+    vector<int> item_group;           // [i]
+};
+
+// 大类子问题的解
+struct GroupSolution {
+    double value = 0.0;               // 子问题最优值 (不含常数项)
+    vector<int> y;                    // [t]
+    vector<int> lambda;               // [t]
+    vector<double> usage;             // [t] sum_i s_i x_it
+    vector<double> item_total;        // [k] 对应 group_items[g][k] 的 sum_t x_it
+};
+
+// 订单 i 在周期 t 的单位生产系数 (含乘子)
+inline double ItemCoef(const AllLists& lists, const LRData& data, int i, int t,
+                       const vector<double>& mu, const vector<double>& pi) {
+    double d = lists.final_demand[i];
+    double late = data.T - max(t, lists.lw_x[i]);
+    return lists.cost_x[i] - lists.cost_b[i] * late - lists.cost_u[i] / d
+         + mu[t] * lists.usage_x[i] + pi[i];
+}
+
+// 开放周期 t 内大类 g 的最优生产 (分数背包)
+// 返回生产部分的最优值 (<= 0)；take 非空时写出各订单产量
+double SolvePeriodKnapsack(const AllLists& lists, const LRData& data, int g, int t,
+                           const vector<double>& mu, const vector<double>& pi,
+                           vector<double>* take) {
+    const vector<int>& items = data.group_items[g];
+    if (take) take->assign(items.size(), 0.0);
+
+    // 收集系数为负的订单
+    vector<pair<double, int>> candidates;  // (单位产能收益, k)
+    double total_usage = 0.0;
+    for (int k = 0; k < static_cast<int>(items.size()); k++) {
+        int i = items[k];
+        if (lists.final_demand[i] <= 0 || t < lists.ew_x[i]) continue;
+        double coef = ItemCoef(lists, data, i, t, mu, pi);
+        if (coef >= 0) continue;
+        double usage = lists.usage_x[i];
+        candidates.push_back({usage > 0 ? coef / usage : -kInf, k});
+        total_usage += usage * lists.final_demand[i];
+    }
+
+    // Big-M 上限: 开放周期大类生产占用不超过 C (无大类订单不受限)
+    double budget = (g < data.G) ? data.capacity : kInf;
+    if (total_usage > budget) {
+        sort(candidates.begin(), candidates.end());
+    }
+
+    double value = 0.0;
+    for (const auto& cand : candidates) {
+        int i = items[cand.second];
+        double usage = lists.usage_x[i];
+        double demand = lists.final_demand[i];
+        double amount = demand;
+        if (usage > 0) {
+            if (budget <= 0) break;
+            amount = min(demand, budget / usage);
+            budget -= amount * usage;
+        }
+        value += ItemCoef(lists, data, i, t, mu, pi) * amount;
+        if (take) (*take)[cand.second] = amount;
+    }
+    return value;
+}
+
+// 大类 g 的子问题: 3 状态动态规划
+void SolveGroupSubproblem(const AllLists& lists, const LRData& data, int g,
+                          const vector<double>& mu, const vector<double>& nu,
+                          const vector<double>& pi, GroupSolution& sol) {
+    int T = data.T;
+    const vector<int>& items = data.group_items[g];
+
+    sol.y.assign(T, 0);
+    sol.lambda.assign(T, 0);
+    sol.usage.assign(T, 0.0);
+    sol.item_total.assign(items.size(), 0.0);
+    sol.value = 0.0;
+    if (items.empty() && g == data.G) return;
+
+    vector<double> open_value(T, 0.0);
+    for (int t = 0; t < T; t++) {
+        open_value[t] = items.empty() ? 0.0
+                      : SolvePeriodKnapsack(lists, data, g, t, mu, pi, nullptr);
+    }
+
+    vector<int> open(T, 0);
+    if (g == data.G) {
+        // 无大类订单: 所有周期开放且无启动成本
+        for (int t = 0; t < T; t++) {
+            open[t] = 1;
+            sol.value += open_value[t];
+        }
+    } else {
+        // 状态: 0=关闭 1=启动 2=跨期
+        vector<array<double, 3>> cost(T);
+        vector<array<int, 3>> parent(T);
+        for (int t = 0; t < T; t++) {
+            double setup = lists.cost_y[g] + mu[t] * lists.usage_y[g] + open_value[t];
+            double carry = nu[t] + open_value[t];
+            if (t == 0) {
+                cost[t] = {0.0, setup, kInf};
+                parent[t] = {-1, -1, -1};
+                continue;
+            }
+            int best_any = 0;
+            for (int s = 1; s < 3; s++) {
+                if (cost[t-1][s] < cost[t-1][best_any]) best_any = s;
+            }
+            int best_active = (cost[t-1][1] <= cost[t-1][2]) ? 1 : 2;
+
+            cost[t][0] = cost[t-1][best_any];
+            parent[t][0] = best_any;
+            cost[t][1] = cost[t-1][best_any] + setup;
+            parent[t][1] = best_any;
+            cost[t][2] = cost[t-1][best_active] + carry;
+            parent[t][2] = best_active;
+        }
+
+        int state = 0;
+        for (int s = 1; s < 3; s++) {
+            if (cost[T-1][s] < cost[T-1][state]) state = s;
+        }
+        sol.value = cost[T-1][state];
+
+        for (int t = T - 1; t >= 0; t--) {
+            if (state == 1) sol.y[t] = 1;
+            if (state == 2) sol.lambda[t] = 1;
+            open[t] = (state != 0);
+            state = parent[t][state];
+        }
+    }
+
+    // 回溯开放周期的生产量，用于次梯度
+    vector<double> take;
+    for (int t = 0; t < T; t++) {
+        if (!open[t] || items.empty()) continue;
+        SolvePeriodKnapsack(lists, data, g, t, mu, pi, &take);
+        for (int k = 0; k < static_cast<int>(items.size()); k++) {
+            if (take[k] <= 0) continue;
+            sol.usage[t] += lists.usage_x[items[k]] * take[k];
+            sol.item_total[k] += take[k];
+        }
+    }
+}
+
+}  // namespace
+
+double RelativeGap(double upper_bound, double lower_bound) {
+    if (upper_bound < 0 || lower_bound < 0) return -1.0;
+    double gap = (upper_bound - lower_bound) / (1e-10 + fabs(upper_bound));
+    return max(0.0, gap);
+}
+
+LagrangianResult SolveLagrangianBound(const AllValues& values,
+                                      const AllLists& lists,
+                                      double upper_bound) {
+    LagrangianResult result;
+    auto start = chrono::steady_clock::now();
+
+    LRData data;
+    data.N = values.number_of_items;
+    data.T = values.number_of_periods;
+    data.G = values.number_of_groups;
+    data.capacity = values.machine_capacity;
+    int N = data.N;
+    int T = data.T;
+    int G = data.G;
+    if (N <= 0 || T <= 0 || G <= 0) return result;
+
+    data.group_items.assign(G + 1, vector<int>());
+    data.item_group.assign(N, G);
+    for (int i = 0; i < N; i++) {
+        for (int g = 0; g < G; g++) {
+            if (lists.group_flag[i][g]) {
+                data.item_group[i] = g;
+                break;
+            }
+        }
+        if (lists.final_demand[i] <= 0) continue;
+        data.group_items[data.item_group[i]].push_back(i);
+        data.constant += lists.cost_b[i] * lists.final_demand[i] * (T - lists.lw_x[i])
+                       + lists.cost_u[i];
+    }
+
+    int threads = values.lr_threads > 0 ? values.lr_threads
+                : static_cast<int>(thread::hardware_concurrency());
+    threads = max(1, min(threads, G + 1));
+    result.threads = threads;
+
+    vector<double> mu(T, 0.0), nu(T, 0.0), pi(N, 0.0);
+    vector<GroupSolution> solutions(G + 1);
+
+    double best = -kInf;
+    double theta = 2.0;
+    int no_improve = 0;
+    const int kPatience = 20;
+
+    LOG_FMT("[下界] Lagrangian 下界: 迭代上限=%d 线程=%d\n", values.lr_iterations, threads);
+
+    for (int iter = 0; iter < values.lr_iterations; iter++) {
+        // 截止时间已到或收到中断: 保留当前最好下界
+        if (g_deadline.Remaining() <= 0.0 || g_interrupt.Requested()) {
+            LOG_FMT("[下界] 截止时间已到或已中断，迭代 %d 次后停止\n", iter);
+            break;
+        }
+        result.iterations = iter + 1;
+
+        // 各大类子问题相互独立，按线程分片并行求解
+        auto worker = [&](int w) {
+            for (int g = w; g <= G; g += threads) {
+                SolveGroupSubproblem(lists, data, g, mu, nu, pi, solutions[g]);
+            }
+        };
+        if (threads > 1) {
+            vector<thread> pool;
+            for (int w = 0; w < threads; w++) pool.emplace_back(worker, w);
+            for (auto& th : pool) th.join();
+        } else {
+            worker(0);
+        }
+
+        // 对偶函数值
+        double dual = data.constant;
+        for (int g = 0; g <= G; g++) dual += solutions[g].value;
+        for (int t = 0; t < T; t++) dual -= mu[t] * data.capacity + nu[t];
+        for (int i = 0; i < N; i++) dual -= pi[i] * lists.final_demand[i];
+
+        if (dual > best + kEpsilon) {
+            best = dual;
+            no_improve = 0;
+        } else if (++no_improve >= kPatience) {
+            theta *= 0.5;
+            no_improve = 0;
+        }
+
+        // 次梯度
+        vector<double> grad_mu(T, -data.capacity), grad_nu(T, -1.0), grad_pi(N, 0.0);
+        for (int i = 0; i < N; i++) grad_pi[i] = -lists.final_demand[i];
+        for (int g = 0; g <= G; g++) {
+            const GroupSolution& sol = solutions[g];
+            for (int t = 0; t < T; t++) {
+                grad_mu[t] += sol.usage[t];
+                if (g < G) {
+                    grad_mu[t] += lists.usage_y[g] * sol.y[t];
+                    grad_nu[t] += sol.lambda[t];
+                }
+            }
+            for (int k = 0; k < static_cast<int>(data.group_items[g].size()); k++) {
+                grad_pi[data.group_items[g][k]] += sol.item_total[k];
+            }
+        }
+
+        // 投影后的次梯度范数 (乘子为 0 且梯度为负的分量不移动)
+        double norm2 = 0.0;
+        for (int t = 0; t < T; t++) {
+            if (mu[t] > 0 || grad_mu[t] > 0) norm2 += grad_mu[t] * grad_mu[t];
+            if (nu[t] > 0 || grad_nu[t] > 0) norm2 += grad_nu[t] * grad_nu[t];
+        }
+        for (int i = 0; i < N; i++) {
+            if (pi[i] > 0 || grad_pi[i] > 0) norm2 += grad_pi[i] * grad_pi[i];
+        }
+        if (norm2 < 1e-12) break;  // 次梯度为 0: 当前乘子最优
+
+        if (upper_bound >= 0 && upper_bound - best <= 1e-6 * max(1.0, fabs(upper_bound))) break;
+        if (theta < 1e-4) break;
+
+        // Polyak 步长
+        double target = upper_bound >= 0 ? upper_bound : fabs(best) * 1.05 + 1.0;
+        double step = theta * max(target - dual, 1e-6 * max(1.0, fabs(target))) / norm2;
+
+        for (int t = 0; t < T; t++) {
+            mu[t] = max(0.0, mu[t] + step * grad_mu[t]);
+            nu[t] = max(0.0, nu[t] + step * grad_nu[t]);
+        }
+        for (int i = 0; i < N; i++) {
+            pi[i] = max(0.0, pi[i] + step * grad_pi[i]);
+        }
+    }
+
+    // 所有成本非负，0 为平凡下界
+    result.bound = max(0.0, best);
+    result.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    LOG_FMT("[下界] 完成: 下界=%.2f 迭代=%d 耗时=%.3fs\n",
+            result.bound, result.iterations, result.time);
+    if (upper_bound >= 0) {
+        LOG_FMT("[下界] 上界=%.2f 间隙=%.4f\n", upper_bound, RelativeGap(upper_bound, result.bound));
+    }
+    return result;
+}
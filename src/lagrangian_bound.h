@@ -0,0 +1,28 @@
+// lagrangian_bound.h - Lagrangian 下界
+// 对共享机器产能约束 (及每期单一 carryover 约束) 进行对偶化，
+// 按产品大类分解为单资源子问题，用动态规划求解，次梯度法更新乘子
+// 不依赖 CPLEX，给启发式算法提供可证明的下界
+
+#ifndef LAGRANGIAN_BOUND_H_
+#define LAGRANGIAN_BOUND_H_
+
+#include "optimizer.h"
+
+// Lagrangian 下界计算结果
+struct LagrangianResult {
+    double bound = -1.0;      // 最优下界 (所有迭代中的最大对偶值)
+    int iterations = 0;       // 次梯度迭代次数
+    double time = 0.0;        // 计算耗时 (秒)
+    int threads = 1;          // 并行线程数
+};
+
+// 计算 Lagrangian 下界
+// upper_bound: 启发式目标值 (Polyak 步长目标)，<0 表示未知
+LagrangianResult SolveLagrangianBound(const AllValues& values,
+                                      const AllLists& lists,
+                                      double upper_bound);
+
+// 相对间隙 (与 CPLEX getMIPRelativeGap 口径一致)，任一值无效时返回 -1
+double RelativeGap(double upper_bound, double lower_bound);
+
+#endif  // LAGRANGIAN_BOUND_H_
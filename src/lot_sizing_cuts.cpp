@@ -0,0 +1,501 @@
+// lot_sizing_cuts.cpp - 批量生产模型用户割平面实现
+//
+// 有效性 (z_gt = y_gt + lambda_gt，均在整数周期上):
+//   VUB:       sum_t x_it <= d_i 且 x_it > 0 要求 z_gt >= 1
+//   SETUP:     y_gt = 1 时产能行给出 F_gt <= C - s_g
+//   ITEM_LS:   若 [e_i,l]\S 中某期 z = 1，左端 >= d_i；否则 [e_i,l] 内生产全在 S 中，
+//              sum_{t in S} x_it = d_i - b_il (欠交定义行)
+//   FAMILY_LS: 对大类内 l_i <= l 的订单按 s_i 加权，同理
+//   CHAIN:     [k,l] 内无 setup 且 lambda_gk = 0 时，由可行性行 lambda_gt <= y_{g,t-1} + lambda_{g,t-1}
+//              逐期推出 lambda_gt = 0，区间内无生产；否则区间总产量不超过 M_gkl
+// ITEM_LS / FAMILY_LS 的 S 取 {t : 产量 < 系数 * z_gt}，对给定 l 为精确分离
+
+#include "lot_sizing_cuts.h"
+#include "model_bounds.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <sstream>
+
+namespace {
+
+constexpr double kCutTolerance = 1e-4;   // 相对违反量阈值
+constexpr size_t kMaxCutsPerRound = 200; // 每次回调最多加入的割数
+
+struct CutScopeEntry {
+    const char* name;
+    int bit;
+};
+
+constexpr CutScopeEntry kCutScopeEntries[] = {
+    {"direct", kCutScopeDirect},
+    {"rf", kCutScopeRF},
+    {"fo", kCutScopeFO},
+    {"rr", kCutScopeRR},
+};
+
+}  // namespace
+
+const char* CutFamilyName(int family) {
+    switch (family) {
+        case kCutVub:      return "VUB";
+        case kCutSetup:    return "SETUP";
+        case kCutItemLS:   return "ITEM_LS";
+        case kCutFamilyLS: return "FAMILY_LS";
+        case kCutChain:    return "CHAIN";
+        default: return "Unknown";
+    }
+}
+
+bool ParseCutScope(const string& text, int& scope) {
+    if (text == "off") {
+        scope = 0;
+        return true;
+    }
+    if (text == "all") {
+        scope = kCutScopeAll;
+        return true;
+    }
+
+    int result = 0;
+    std::stringstream ss(text);
+    string token;
+    while (std::getline(ss, token, ',')) {
+        bool found = false;
+        for (const auto& entry : kCutScopeEntries) {
+            if (token == entry.name) {
+                result |= entry.bit;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    scope = result;
+    return true;
+}
+
+string CutScopeName(int scope) {
+    if (scope == 0) {
+        return "off";
+    }
+    string name;
+    for (const auto& entry : kCutScopeEntries) {
+        if (scope & entry.bit) {
+            if (!name.empty()) name += ",";
+            name += entry.name;
+        }
+    }
+    return name;
+}
+
+long CutStats::Total() const {
+    long total = 0;
+    for (int f = 0; f < kCutFamilyCount; ++f) {
+        total += added[f];
+    }
+    return total;
+}
+
+double CutStats::RootGain() const {
+    return root_calls > 0 ? root_last - root_first : 0.0;
+}
+
+LotSizingCutCallback::LotSizingCutCallback(
+    IloEnv env, const AllValues& values, const AllLists& lists,
+    const IloArray<IloNumVarArray>& X, const IloArray<IloNumVarArray>& Y,
+    const IloArray<IloNumVarArray>& Lambda, const IloArray<IloNumVarArray>& B,
+    double capacity, int integral_periods)
+    : N_(values.number_of_items),
+      T_(values.number_of_periods),
+      G_(values.number_of_groups),
+      integral_periods_(min(integral_periods, values.number_of_periods)),
+      capacity_(capacity),
+      has_lambda_(Lambda.getImpl() != 0),
+      item_vub_(values.item_vub),
+      ew_(lists.ew_x),
+      lw_(lists.lw_x),
+      demand_(lists.final_demand),
+      usage_x_(lists.usage_x),
+      usage_y_(lists.usage_y),
+      vars_(env) {
+    x_idx_.assign(N_, vector<int>(T_, -1));
+    b_idx_.assign(N_, vector<int>(T_, -1));
+    y_idx_.assign(G_, vector<int>(T_, -1));
+    l_idx_.assign(G_, vector<int>(T_, -1));
+
+    for (int i = 0; i < N_; ++i) {
+        for (int t = 0; t < T_; ++t) {
+            if (X[i][t].getImpl()) x_idx_[i][t] = VarIndex(X[i][t]);
+            if (B[i][t].getImpl()) b_idx_[i][t] = VarIndex(B[i][t]);
+        }
+    }
+    for (int g = 0; g < G_; ++g) {
+        for (int t = 0; t < T_; ++t) {
+            y_idx_[g][t] = VarIndex(Y[g][t]);
+            if (has_lambda_) l_idx_[g][t] = VarIndex(Lambda[g][t]);
+        }
+    }
+
+    item_group_.assign(N_, -1);
+    group_items_.assign(G_, vector<int>());
+    for (int i = 0; i < N_; ++i) {
+        for (int g = 0; g < G_; ++g) {
+            if (lists.group_flag[i][g]) {
+                item_group_[i] = g;
+                group_items_[g].push_back(i);
+                break;
+            }
+        }
+    }
+
+    big_m_ = ComputeFamilyBigM(values, lists, capacity);
+
+    released_.assign(G_, vector<double>(T_, 0.0));
+    for (int i = 0; i < N_; ++i) {
+        int g = item_group_[i];
+        int ew = max(0, ew_[i]);
+        if (g < 0 || ew >= T_) continue;
+        released_[g][ew] += static_cast<double>(usage_x_[i]) * demand_[i];
+    }
+    for (int g = 0; g < G_; ++g) {
+        for (int t = 1; t < T_; ++t) {
+            released_[g][t] += released_[g][t-1];
+        }
+    }
+}
+
+LotSizingCutCallback::~LotSizingCutCallback() {
+    vars_.end();
+}
+
+int LotSizingCutCallback::VarIndex(const IloNumVar& var) {
+    vars_.add(var);
+    return static_cast<int>(vars_.getSize()) - 1;
+}
+
+double LotSizingCutCallback::Z(const vector<double>& v, int g, int t) const {
+    double z = v[y_idx_[g][t]];
+    if (has_lambda_) z += v[l_idx_[g][t]];
+    return z;
+}
+
+void LotSizingCutCallback::AddZ(vector<std::pair<int, double>>& terms,
+                                int g, int t, double coef) const {
+    terms.emplace_back(y_idx_[g][t], coef);
+    if (has_lambda_) terms.emplace_back(l_idx_[g][t], coef);
+}
+
+void LotSizingCutCallback::AddFamilyProduction(vector<std::pair<int, double>>& terms,
+                                               int g, int t, double coef,
+                                               int max_lw) const {
+    for (int i : group_items_[g]) {
+        if (x_idx_[i][t] >= 0 && lw_[i] <= max_lw) {
+            terms.emplace_back(x_idx_[i][t], coef * usage_x_[i]);
+        }
+    }
+}
+
+// x_it <= d_i z_gt
+void LotSizingCutCallback::SeparateVub(const vector<double>& v, vector<Cut>& cuts) const {
+    for (int i = 0; i < N_; ++i) {
+        int g = item_group_[i];
+        double d = demand_[i];
+        if (g < 0 || d <= 0) continue;
+        for (int t = max(0, ew_[i]); t < integral_periods_; ++t) {
+            double violation = v[x_idx_[i][t]] - d * Z(v, g, t);
+            if (violation <= kCutTolerance * d) continue;
+
+            Cut cut{kCutVub, violation / d, {}, 0.0};
+            cut.terms.emplace_back(x_idx_[i][t], 1.0);
+            AddZ(cut.terms, g, t, -d);
+            cuts.push_back(std::move(cut));
+        }
+    }
+}
+
+// F_gt <= min(M_gt, C - s_g) y_gt + M_gt lambda_gt，仅在比模型行更紧时分离
+void LotSizingCutCallback::SeparateSetup(const vector<double>& v,
+                                         const vector<vector<double>>& family,
+                                         vector<Cut>& cuts) const {
+    for (int g = 0; g < G_; ++g) {
+        double setup_capacity = max(0.0, capacity_ - usage_y_[g]);
+        for (int t = 0; t < integral_periods_; ++t) {
+            double big_m = big_m_[g][t];
+            double y_coef = min(big_m, setup_capacity);
+            if (big_m <= 0 || y_coef >= big_m - kCutTolerance) continue;
+
+            double rhs = y_coef * v[y_idx_[g][t]];
+            if (has_lambda_) rhs += big_m * v[l_idx_[g][t]];
+            double violation = family[g][t] - rhs;
+            if (violation <= kCutTolerance * big_m) continue;
+
+            Cut cut{kCutSetup, violation / big_m, {}, 0.0};
+            AddFamilyProduction(cut.terms, g, t, 1.0, INT_MAX);
+            cut.terms.emplace_back(y_idx_[g][t], -y_coef);
+            if (has_lambda_) cut.terms.emplace_back(l_idx_[g][t], -big_m);
+            cuts.push_back(std::move(cut));
+        }
+    }
+}
+
+// sum_{t in S} x_it + sum_{t in [e_i,l]\S} d_i z_gt + b_il >= d_i，每个订单取违反最大的 l
+void LotSizingCutCallback::SeparateItemLS(const vector<double>& v, vector<Cut>& cuts) const {
+    for (int i = 0; i < N_; ++i) {
+        int g = item_group_[i];
+        double d = demand_[i];
+        int first = max(0, ew_[i]);
+        if (g < 0 || d <= 0 || lw_[i] >= integral_periods_) continue;
+
+        double partial = 0.0;
+        double best_violation = kCutTolerance * d;
+        int best_l = -1;
+        for (int l = first; l < integral_periods_; ++l) {
+            partial += min(v[x_idx_[i][l]], d * Z(v, g, l));
+            if (b_idx_[i][l] < 0) continue;
+            double violation = d - partial - v[b_idx_[i][l]];
+            if (violation > best_violation) {
+                best_violation = violation;
+                best_l = l;
+            }
+        }
+        if (best_l < 0) continue;
+
+        // 取负号写成 <= 形式
+        Cut cut{kCutItemLS, best_violation / d, {}, -d};
+        for (int t = first; t <= best_l; ++t) {
+            if (v[x_idx_[i][t]] < d * Z(v, g, t)) {
+                cut.terms.emplace_back(x_idx_[i][t], -1.0);
+            } else {
+                AddZ(cut.terms, g, t, -d);
+            }
+        }
+        cut.terms.emplace_back(b_idx_[i][best_l], -1.0);
+        cuts.push_back(std::move(cut));
+    }
+}
+
+// 大类版本: 订单集合为 {i in g : l_i <= l}，D_gl = sum s_i d_i，每个大类取违反最大的 l
+void LotSizingCutCallback::SeparateFamilyLS(const vector<double>& v, vector<Cut>& cuts) const {
+    for (int g = 0; g < G_; ++g) {
+        vector<double> production(T_, 0.0);  // 已纳入订单的加权产量
+        vector<int> members;
+        double demand = 0.0;
+        int first = T_;
+
+        double best_violation = 0.0;
+        int best_l = -1;
+        double best_demand = 0.0;
+        int best_first = T_;
+
+        for (int l = 0; l < integral_periods_; ++l) {
+            for (int i : group_items_[g]) {
+                if (max(0, lw_[i]) != l) continue;
+                members.push_back(i);
+                demand += static_cast<double>(usage_x_[i]) * demand_[i];
+                first = min(first, max(0, ew_[i]));
+                for (int t = max(0, ew_[i]); t < T_; ++t) {
+                    production[t] += usage_x_[i] * v[x_idx_[i][t]];
+                }
+            }
+            if (demand <= 0) continue;
+
+            double lhs = 0.0;
+            for (int i : members) {
+                lhs += usage_x_[i] * v[b_idx_[i][l]];
+            }
+            for (int t = first; t <= l; ++t) {
+                lhs += min(production[t], demand * Z(v, g, t));
+            }
+            double violation = demand - lhs;
+            if (violation > kCutTolerance * demand &&
+                violation / demand > best_violation) {
+                best_violation = violation / demand;
+                best_l = l;
+                best_demand = demand;
+                best_first = first;
+            }
+        }
+        if (best_l < 0) continue;
+
+        Cut cut{kCutFamilyLS, best_violation, {}, -best_demand};
+        for (int t = best_first; t <= best_l; ++t) {
+            double weighted = 0.0;
+            for (int i : group_items_[g]) {
+                if (lw_[i] <= best_l && x_idx_[i][t] >= 0) {
+                    weighted += usage_x_[i] * v[x_idx_[i][t]];
+                }
+            }
+            if (weighted < best_demand * Z(v, g, t)) {
+                AddFamilyProduction(cut.terms, g, t, -1.0, best_l);
+            } else {
+                AddZ(cut.terms, g, t, -best_demand);
+            }
+        }
+        for (int i : group_items_[g]) {
+            if (lw_[i] <= best_l) {
+                cut.terms.emplace_back(b_idx_[i][best_l], -usage_x_[i]);
+            }
+        }
+        cuts.push_back(std::move(cut));
+    }
+}
+
+// sum_{t=k..l} F_gt <= M_gkl (sum_{t=k..l} y_gt + lambda_gk)，每个大类取违反最大的 (k,l)
+void LotSizingCutCallback::SeparateChain(const vector<double>& v,
+                                         const vector<vector<double>>& family,
+                                         vector<Cut>& cuts) const {
+    for (int g = 0; g < G_; ++g) {
+        double best_violation = 0.0;
+        int best_k = -1;
+        int best_l = -1;
+        double best_m = 0.0;
+
+        for (int k = 0; k < integral_periods_; ++k) {
+            double sum_family = family[g][k];
+            double sum_y = v[y_idx_[g][k]];
+            double lambda_k = v[l_idx_[g][k]];
+            for (int l = k + 1; l < integral_periods_; ++l) {
+                sum_family += family[g][l];
+                sum_y += v[y_idx_[g][l]];
+                double big_m = min((l - k + 1) * capacity_, released_[g][l]);
+                if (big_m <= 0) continue;
+
+                double violation = sum_family - big_m * (sum_y + lambda_k);
+                if (violation > kCutTolerance * big_m &&
+                    violation / big_m > best_violation) {
+                    best_violation = violation / big_m;
+                    best_k = k;
+                    best_l = l;
+                    best_m = big_m;
+                }
+            }
+        }
+        if (best_k < 0) continue;
+
+        Cut cut{kCutChain, best_violation, {}, 0.0};
+        for (int t = best_k; t <= best_l; ++t) {
+            AddFamilyProduction(cut.terms, g, t, 1.0, INT_MAX);
+            cut.terms.emplace_back(y_idx_[g][t], -best_m);
+        }
+        cut.terms.emplace_back(l_idx_[g][best_k], -best_m);
+        cuts.push_back(std::move(cut));
+    }
+}
+
+void LotSizingCutCallback::invoke(const IloCplex::Callback::Context& context) {
+    if (!context.inRelaxation()) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    IloEnv env = context.getEnv();
+    IloNumArray point(env);
+    context.getRelaxationPoint(vars_, point);
+    vector<double> v(vars_.getSize());
+    for (IloInt j = 0; j < vars_.getSize(); ++j) {
+        v[j] = point[j];
+    }
+    point.end();
+
+    // F_gt = sum_{i in g} s_i x_it
+    vector<vector<double>> family(G_, vector<double>(T_, 0.0));
+    for (int i = 0; i < N_; ++i) {
+        int g = item_group_[i];
+        if (g < 0) continue;
+        for (int t = max(0, ew_[i]); t < T_; ++t) {
+            family[g][t] += usage_x_[i] * v[x_idx_[i][t]];
+        }
+    }
+
+    vector<Cut> cuts;
+    if (!item_vub_) {
+        SeparateVub(v, cuts);
+    }
+    SeparateSetup(v, family, cuts);
+    SeparateItemLS(v, cuts);
+    SeparateFamilyLS(v, cuts);
+    if (has_lambda_) {
+        SeparateChain(v, family, cuts);
+    }
+
+    if (cuts.size() > kMaxCutsPerRound) {
+        std::partial_sort(cuts.begin(), cuts.begin() + kMaxCutsPerRound, cuts.end(),
+                          [](const Cut& a, const Cut& b) { return a.violation > b.violation; });
+        cuts.resize(kMaxCutsPerRound);
+    }
+
+    bool at_root = context.getLongInfo(IloCplex::Callback::Context::Info::NodeCount) == 0;
+    double objective = context.getRelaxationObjective();
+
+    // 回调可能被多个线程并发调用，Concert 对象构建与统计串行化
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Cut& cut : cuts) {
+        IloExpr expr(env);
+        for (const auto& term : cut.terms) {
+            expr += term.second * vars_[term.first];
+        }
+        IloRange range(env, -IloInfinity, expr, cut.rhs);
+        context.addUserCut(range, IloCplex::UseCutPurge, IloFalse);
+        range.end();
+        expr.end();
+        stats_.added[cut.family]++;
+    }
+
+    stats_.calls++;
+    if (at_root) {
+        if (stats_.root_calls == 0) {
+            stats_.root_first = objective;
+        }
+        stats_.root_last = objective;
+        stats_.root_calls++;
+    }
+    stats_.time += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+CutStats LotSizingCutCallback::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::unique_ptr<LotSizingCutCallback> AttachLotSizingCuts(
+    IloCplex& cplex, int scope, IloEnv env,
+    const AllValues& values, const AllLists& lists,
+    const IloArray<IloNumVarArray>& X, const IloArray<IloNumVarArray>& Y,
+    const IloArray<IloNumVarArray>& Lambda, const IloArray<IloNumVarArray>& B,
+    double capacity, int integral_periods) {
+    if ((values.user_cut_scope & scope) == 0) {
+        return nullptr;
+    }
+    auto callback = std::make_unique<LotSizingCutCallback>(
+        env, values, lists, X, Y, Lambda, B, capacity, integral_periods);
+    cplex.use(callback.get(), IloCplex::Callback::Context::Id::Relaxation);
+    return callback;
+}
+
+void RecordCutStats(AllValues& values, const char* tag,
+                    const LotSizingCutCallback* callback) {
+    if (callback == nullptr) {
+        return;
+    }
+    CutStats stats = callback->Stats();
+
+    // RF 并行重试时多个子问题同时汇总
+    static std::mutex record_mutex;
+    std::lock_guard<std::mutex> lock(record_mutex);
+    auto& m = values.metrics;
+    m.cut_calls += stats.calls;
+    m.cuts_added += stats.Total();
+    m.cut_time += stats.time;
+    m.cut_root_gain += stats.RootGain();
+
+    LOG_FMT("%s 用户割: 调用=%ld 加入=%ld (VUB=%ld SETUP=%ld ITEM_LS=%ld FAMILY_LS=%ld CHAIN=%ld) "
+            "根节点LP提升=%.2f 分离耗时=%.3fs\n",
+            tag, stats.calls, stats.Total(),
+            stats.added[kCutVub], stats.added[kCutSetup], stats.added[kCutItemLS],
+            stats.added[kCutFamilyLS], stats.added[kCutChain],
+            stats.RootGain(), stats.time);
+}
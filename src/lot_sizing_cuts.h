@@ -0,0 +1,121 @@
+// lot_sizing_cuts.h - 批量生产模型用户割平面
+// 通过 CPLEX 通用回调 (Relaxation 上下文) 分离模型专用有效不等式，
+// 补充 CPLEX 通用割对大类 Big-M 松弛的不足:
+//   VUB      订单级上界        x_it <= d_i (y_gt + lambda_gt)
+//   SETUP    setup 产能        F_gt <= min(M_gt, C - s_g) y_gt + M_gt lambda_gt
+//   ITEM_LS  订单 (l,S)        sum_{t in S} x_it + sum_{t in [e_i,l]\S} d_i z_gt + b_il >= d_i
+//   FAMILY_LS 大类 (l,S)       同上，按 s_i 加权聚合大类内 l_i <= l 的订单
+//   CHAIN    carryover 链      sum_{t=k..l} F_gt <= M_gkl (sum_{t=k..l} y_gt + lambda_gk)
+// 其中 F_gt = sum_{i in g} s_i x_it，z_gt = y_gt + lambda_gt，
+// M_gkl = min((l-k+1) C, sum_{i in g, e_i <= l} s_i d_i)
+
+#ifndef LOT_SIZING_CUTS_H_
+#define LOT_SIZING_CUTS_H_
+
+#include "optimizer.h"
+#include <memory>
+#include <mutex>
+
+// 割族
+enum CutFamily {
+    kCutVub = 0,
+    kCutSetup,
+    kCutItemLS,
+    kCutFamilyLS,
+    kCutChain,
+    kCutFamilyCount
+};
+
+const char* CutFamilyName(int family);
+
+// 作用范围解析: "off" | "all" | 逗号分隔的 direct,rf,fo,rr
+bool ParseCutScope(const string& text, int& scope);
+string CutScopeName(int scope);
+
+// 分离统计
+struct CutStats {
+    long calls = 0;                        // 回调调用次数
+    long added[kCutFamilyCount] = {};      // 各割族加入数
+    double time = 0.0;                     // 分离耗时 (秒，各线程累加)
+    long root_calls = 0;                   // 根节点调用次数
+    double root_first = 0.0;               // 根节点首轮 LP 目标
+    double root_last = 0.0;                // 根节点末轮 LP 目标
+
+    long Total() const;
+    double RootGain() const;               // 根节点 LP 目标提升
+};
+
+// 用户割回调
+// 只使用 t < integral_periods 的周期: RF 子问题放松段的 y/lambda 为连续变量，
+// 这些不等式对其不成立，不能参与
+class LotSizingCutCallback : public IloCplex::Callback::Function {
+public:
+    // Lambda 为空句柄时按无 carryover 模型分离 (RR 阶段1)，跳过 CHAIN
+    LotSizingCutCallback(IloEnv env, const AllValues& values, const AllLists& lists,
+                         const IloArray<IloNumVarArray>& X,
+                         const IloArray<IloNumVarArray>& Y,
+                         const IloArray<IloNumVarArray>& Lambda,
+                         const IloArray<IloNumVarArray>& B,
+                         double capacity, int integral_periods);
+    // 结束变量索引数组 (变量本身属于模型的所有者)，须在环境 end() 之前析构
+    ~LotSizingCutCallback() override;
+
+    void invoke(const IloCplex::Callback::Context& context) override;
+
+    CutStats Stats() const;
+
+private:
+    struct Cut {
+        int family;
+        double violation;                  // 按右端规模归一化的违反量
+        vector<std::pair<int, double>> terms;
+        double rhs;                        // sum terms <= rhs
+    };
+
+    int VarIndex(const IloNumVar& var);
+    double Z(const vector<double>& v, int g, int t) const;
+    void AddZ(vector<std::pair<int, double>>& terms, int g, int t, double coef) const;
+    void AddFamilyProduction(vector<std::pair<int, double>>& terms, int g, int t,
+                             double coef, int max_lw) const;
+
+    void SeparateVub(const vector<double>& v, vector<Cut>& cuts) const;
+    void SeparateSetup(const vector<double>& v, const vector<vector<double>>& family,
+                       vector<Cut>& cuts) const;
+    void SeparateItemLS(const vector<double>& v, vector<Cut>& cuts) const;
+    void SeparateFamilyLS(const vector<double>& v, vector<Cut>& cuts) const;
+    void SeparateChain(const vector<double>& v, const vector<vector<double>>& family,
+                       vector<Cut>& cuts) const;
+
+    int N_, T_, G_;
+    int integral_periods_;
+    double capacity_;
+    bool has_lambda_;
+    bool item_vub_;                        // 模型已含订单级上界时不再分离 VUB
+    vector<int> ew_, lw_, demand_, usage_x_, usage_y_;
+
+    IloNumVarArray vars_;                  // 回调读取的全部变量
+    vector<vector<int>> x_idx_, b_idx_;    // 窗口外为 -1
+    vector<vector<int>> y_idx_, l_idx_;
+    vector<int> item_group_;               // 订单所属大类 (-1 表示无)
+    vector<vector<int>> group_items_;
+    vector<vector<double>> big_m_;         // 与模型一致的 M_gt
+    vector<vector<double>> released_;      // sum_{i in g, e_i <= t} s_i d_i (不截断)
+
+    mutable std::mutex mutex_;
+    CutStats stats_;
+};
+
+// 按作用范围挂载割回调，scope 未在 values.user_cut_scope 中启用时返回空指针
+// 返回的回调须在 cplex.solve() 结束前保持存活
+std::unique_ptr<LotSizingCutCallback> AttachLotSizingCuts(
+    IloCplex& cplex, int scope, IloEnv env,
+    const AllValues& values, const AllLists& lists,
+    const IloArray<IloNumVarArray>& X, const IloArray<IloNumVarArray>& Y,
+    const IloArray<IloNumVarArray>& Lambda, const IloArray<IloNumVarArray>& B,
+    double capacity, int integral_periods);
+
+// 统计并入 values.metrics 并输出日志 (callback 为空时不做任何事)
+void RecordCutStats(AllValues& values, const char* tag,
+                    const LotSizingCutCallback* callback);
+
+#endif  // LOT_SIZING_CUTS_H_
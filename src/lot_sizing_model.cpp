@@ -0,0 +1,296 @@
+/**
+ * @file lot_sizing_model.cpp
+ * @brief 完整批量生产 MILP 模型构建
+ */
+
+#include "lot_sizing_model.h"
+#include "model_bounds.h"
+#include "cplex_pool.h"
+
+// 决策变量: x_it, y_gt, lambda_gt, I_ft, P_ft, b_it, u_i
+void BuildLotSizingModel(IloEnv env, IloModel model,
+                         const AllValues& values, const AllLists& lists,
+                         LotSizingVars& vars, LotSizingRows* rows) {
+    // 决策变量定义；X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+    IloArray<IloNumVarArray> X = CreateWindowVars(env, lists.ew_x, values.number_of_periods);  // x_it: 生产量
+    IloArray<IloNumVarArray> Y(env, values.number_of_groups);     // y_gt: setup
+    IloArray<IloNumVarArray> Lambda(env, values.number_of_groups); // lambda_gt: carryover
+    IloArray<IloNumVarArray> I(env, values.number_of_flows);      // I_ft: 库存
+    IloArray<IloNumVarArray> P(env, values.number_of_flows);      // P_ft: 处理量
+    IloArray<IloNumVarArray> B = CreateWindowVars(env, lists.lw_x, values.number_of_periods);  // b_it: 欠交量
+    IloNumVarArray U(env, values.number_of_items, 0, 1, ILOBOOL); // u_i: 未满足
+
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        Y[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
+        Lambda[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
+    }
+
+    for (int f = 0; f < values.number_of_flows; ++f) {
+        I[f] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
+        P[f] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
+    }
+
+    // 目标函数: 最小化总成本
+    IloExpr objective(env);
+
+    for (int i = 0; i < values.number_of_items; ++i) {
+        for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; ++t) {
+            objective += lists.cost_x[i] * X[i][t];
+        }
+    }
+
+    for (int i = 0; i < values.number_of_items; ++i) {
+        for (int t = lists.lw_x[i]; t < values.number_of_periods; ++t) {
+            objective += lists.cost_b[i] * B[i][t];
+        }
+    }
+
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        for (int t = 0; t < values.number_of_periods; ++t) {
+            objective += lists.cost_y[g] * Y[g][t];
+        }
+    }
+
+    for (int f = 0; f < values.number_of_flows; ++f) {
+        for (int t = 0; t < values.number_of_periods; ++t) {
+            objective += lists.cost_i[f] * I[f][t];
+        }
+    }
+
+    for (int i = 0; i < values.number_of_items; ++i) {
+        objective += lists.cost_u[i] * U[i];
+    }
+
+    IloObjective minimize = IloMinimize(env, objective);
+    model.add(minimize);
+    objective.end();
+    if (rows) {
+        rows->objective = minimize;
+        rows->capacity = IloRangeArray(env, values.number_of_periods);
+        rows->family_setup = IloArray<IloRangeArray>(env, values.number_of_groups);
+        rows->flow_limit = IloArray<IloRangeArray>(env, values.number_of_flows);
+    }
+
+    // 约束(2): 流程平衡 - sum k_if*x_it + I_f,t-1 - P_ft - I_ft = 0
+    for (int f = 0; f < values.number_of_flows; ++f) {
+        for (int t = 0; t < values.number_of_periods; ++t) {
+            IloExpr production_flow(env);
+            for (int i = 0; i < values.number_of_items; ++i) {
+                if (t >= lists.ew_x[i]) {
+                    production_flow += lists.flow_flag[i][f] * X[i][t];
+                }
+            }
+
+            if (t == 0) {
+                model.add(production_flow - P[f][t] - I[f][t] == 0);
+            } else {
+                model.add(I[f][t-1] + production_flow - P[f][t] - I[f][t] == 0);
+            }
+            production_flow.end();
+        }
+    }
+
+    // 约束(3): 下游工序处理能力 - P_ft <= D_ft
+    for (int f = 0; f < values.number_of_flows; ++f) {
+        if (rows) rows->flow_limit[f] = IloRangeArray(env, values.number_of_periods);
+        for (int t = 0; t < values.number_of_periods; ++t) {
+            IloRange flow_row = (P[f][t] <= lists.period_demand[f][t]);
+            model.add(flow_row);
+            if (rows) rows->flow_limit[f][t] = flow_row;
+        }
+    }
+
+    // 约束(4.1): 终期欠交与未满足指示 - d_i * u_i >= b_i,T
+    for (int i = 0; i < values.number_of_items; ++i) {
+        int T_final = values.number_of_periods - 1;
+        model.add(lists.final_demand[i] * U[i] >= B[i][T_final]);
+    }
+
+    // 约束(5): 产能约束 - sum s_x[i]*x_it + sum s_y[g]*y_gt <= C_t
+    for (int t = 0; t < values.number_of_periods; ++t) {
+        IloExpr capacity(env);
+        for (int i = 0; i < values.number_of_items; ++i) {
+            if (t < lists.ew_x[i]) continue;  // 窗口外无变量
+            capacity += lists.usage_x[i] * X[i][t];
+        }
+        for (int g = 0; g < values.number_of_groups; ++g) {
+            capacity += lists.usage_y[g] * Y[g][t];
+        }
+        IloRange capacity_row = (capacity <= values.machine_capacity);
+        model.add(capacity_row);
+        if (rows) rows->capacity[t] = capacity_row;
+        capacity.end();
+    }
+
+    // 约束(6.1): 产品大类生产需要setup或carryover
+    // sum_{i:h_ig=1} s_x[i]*x_it <= M_gt*(y_gt + lambda_gt), M_gt 见 model_bounds.h
+    AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                              values.machine_capacity,
+                              rows ? &rows->family_setup : nullptr);
+
+    // 约束(7): 每期最多一个carryover - sum_g lambda_gt <= 1
+    for (int t = 0; t < values.number_of_periods; ++t) {
+        IloExpr sum_lambda(env);
+        for (int g = 0; g < values.number_of_groups; ++g) {
+            sum_lambda += Lambda[g][t];
+        }
+        model.add(sum_lambda <= 1);
+        sum_lambda.end();
+    }
+
+    // 约束(8): Carryover可行性 - y_{g,t-1} + lambda_{g,t-1} - lambda_gt >= 0
+    // 含义: 如果周期t要有carryover，则周期t-1必须有setup或carryover
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        for (int t = 1; t < values.number_of_periods; ++t) {
+            model.add(Y[g][t-1] + Lambda[g][t-1] - Lambda[g][t] >= 0);
+        }
+    }
+
+    // 约束(9): Carryover排他性 - lambda_gt + lambda_{g,t-1} + y_gt - sum_{g'!=g} y_{g't} <= 2
+    // 含义: 防止carryover与其他组的setup冲突
+    vars.S = AddCarryoverExclusivity(env, model, values, Y, Lambda,
+                                     values.number_of_groups, values.number_of_periods);
+
+    // 约束(10): 初始状态 - lambda_g0 = 0 (第一周期无跨期，因为没有前序周期)
+    // 注意: Y[g][0] 不约束为0，第一周期允许启动
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        model.add(Lambda[g][0] == 0);
+    }
+
+    // 约束(13): 最早生产期约束 - t < e_i 的 x_it 不创建 (时间窗稀疏变量)
+    // 注意: t > l_i 后仍可生产，通过欠交惩罚控制
+
+    // 约束(14): 欠交动态定义 - d_i - sum_{tau<=t} x_itau = b_it for t >= l_i
+    for (int i = 0; i < values.number_of_items; ++i) {
+        for (int t = lists.lw_x[i]; t < values.number_of_periods; ++t) {
+            IloExpr cumulative_production(env);
+            for (int tau = max(0, lists.ew_x[i]); tau <= t; ++tau) {
+                cumulative_production += X[i][tau];
+            }
+            model.add(lists.final_demand[i] - cumulative_production == B[i][t]);
+            cumulative_production.end();
+        }
+    }
+
+    vars.X = X;
+    vars.Y = Y;
+    vars.Lambda = Lambda;
+    vars.I = I;
+    vars.P = P;
+    vars.B = B;
+    vars.U = U;
+}
+
+IloArray<IloNumVarArray> CreateWindowVars(IloEnv env, const vector<int>& first,
+                                          int num_periods) {
+    const int n = static_cast<int>(first.size());
+    IloArray<IloNumVarArray> vars(env, n);
+    for (int i = 0; i < n; ++i) {
+        vars[i] = IloNumVarArray(env, num_periods);
+        for (int t = max(0, first[i]); t < num_periods; ++t) {
+            vars[i][t] = IloNumVar(env, 0, IloInfinity);
+        }
+    }
+    return vars;
+}
+
+double WindowValue(IloCplex& cplex, const IloArray<IloNumVarArray>& vars, int i, int t) {
+    if (!vars[i][t].getImpl()) {
+        return 0.0;
+    }
+    return cplex.getValue(vars[i][t]);
+}
+
+void OwnLotSizingVars(CplexLease& lease, const LotSizingVars& vars) {
+    for (auto array : {vars.X, vars.Y, vars.Lambda, vars.I, vars.P, vars.B}) lease.Own(array);
+    lease.Own(vars.U);
+    lease.Own(vars.S);
+}
+
+void AddFamilySetupConstraints(IloEnv env, IloModel model,
+                               const AllValues& values, const AllLists& lists,
+                               const IloArray<IloNumVarArray>& X,
+                               const IloArray<IloNumVarArray>& Y,
+                               const IloArray<IloNumVarArray>& Lambda,
+                               double capacity,
+                               IloArray<IloRangeArray>* rows,
+                               bool late_window_closed) {
+    vector<vector<double>> big_m = ComputeFamilyBigM(values, lists, capacity, late_window_closed);
+
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        if (rows) (*rows)[g] = IloRangeArray(env, values.number_of_periods);
+        for (int t = 0; t < values.number_of_periods; ++t) {
+            IloExpr family_production(env);
+            for (int i = 0; i < values.number_of_items; ++i) {
+                if (lists.group_flag[i][g] && t >= lists.ew_x[i]) {
+                    family_production += lists.usage_x[i] * X[i][t];
+                }
+            }
+            IloRange row = (family_production <= big_m[g][t] * (Y[g][t] + Lambda[g][t]));
+            model.add(row);
+            if (rows) (*rows)[g][t] = row;
+            family_production.end();
+        }
+    }
+
+    if (!values.item_vub) {
+        return;
+    }
+
+    // 订单级上界: x_it <= d_i (y_gt + lambda_gt)，t < e_i (及窗口关闭后) 的变量已固定为 0，跳过
+    for (int i = 0; i < values.number_of_items; ++i) {
+        int close = late_window_closed ? min(values.number_of_periods, lists.lw_x[i] + 1)
+                                       : values.number_of_periods;
+        for (int g = 0; g < values.number_of_groups; ++g) {
+            if (!lists.group_flag[i][g]) continue;
+            for (int t = max(0, lists.ew_x[i]); t < close; ++t) {
+                model.add(X[i][t] <= lists.final_demand[i] * (Y[g][t] + Lambda[g][t]));
+            }
+        }
+    }
+}
+
+IloNumVarArray AddSetupCount(IloEnv env, IloModel model,
+                             const IloArray<IloNumVarArray>& Y,
+                             int num_groups, int num_periods) {
+    IloNumVarArray S(env, num_periods, 0, num_groups, ILOFLOAT);
+    for (int t = 0; t < num_periods; ++t) {
+        IloExpr sum_y(env);
+        for (int g = 0; g < num_groups; ++g) {
+            sum_y += Y[g][t];
+        }
+        model.add(S[t] == sum_y);
+        sum_y.end();
+    }
+    return S;
+}
+
+IloNumVarArray AddCarryoverExclusivity(IloEnv env, IloModel model, const AllValues& values,
+                                       const IloArray<IloNumVarArray>& Y,
+                                       const IloArray<IloNumVarArray>& Lambda,
+                                       int num_groups, int num_periods) {
+    if (values.aggregate_exclusivity) {
+        // -sum_{g'!=g} y_g't = y_gt - S_t
+        IloNumVarArray S = AddSetupCount(env, model, Y, num_groups, num_periods);
+        for (int g = 0; g < num_groups; ++g) {
+            for (int t = 1; t < num_periods; ++t) {
+                model.add(Lambda[g][t] + Lambda[g][t-1] + 2 * Y[g][t] - S[t] <= 2);
+            }
+        }
+        return S;
+    }
+
+    for (int g = 0; g < num_groups; ++g) {
+        for (int t = 1; t < num_periods; ++t) {
+            IloExpr sum_other_y(env);
+            for (int g2 = 0; g2 < num_groups; ++g2) {
+                if (g2 != g) {
+                    sum_other_y += Y[g2][t];
+                }
+            }
+            model.add(Lambda[g][t] + Lambda[g][t-1] + Y[g][t] - sum_other_y <= 2);
+            sum_other_y.end();
+        }
+    }
+    return IloNumVarArray();
+}
@@ -0,0 +1,76 @@
+// lot_sizing_model.h - 完整批量生产 MILP 模型构建
+// 供 CPLEX 直接求解与后台根节点下界共用，保证两者模型口径一致
+
+#ifndef LOT_SIZING_MODEL_H_
+#define LOT_SIZING_MODEL_H_
+
+#include "optimizer.h"
+
+class CplexLease;
+
+// 完整模型决策变量
+struct LotSizingVars {
+    IloArray<IloNumVarArray> X;       // x_it: 生产量
+    IloArray<IloNumVarArray> Y;       // y_gt: setup
+    IloArray<IloNumVarArray> Lambda;  // lambda_gt: carryover
+    IloArray<IloNumVarArray> I;       // I_ft: 库存
+    IloArray<IloNumVarArray> P;       // P_ft: 处理量
+    IloArray<IloNumVarArray> B;       // b_it: 欠交量
+    IloNumVarArray U;                 // u_i: 未满足
+    IloNumVarArray S;                 // S_t: 每期 setup 总数 (仅聚合排他写法，否则为空句柄)
+};
+
+// 需要原地修改或读取对偶的行与目标 (见 sweep.h、sensitivity.h)
+struct LotSizingRows {
+    IloObjective objective;                 // 目标函数 (b_it, u_i 系数为 cost_b / cost_u)
+    IloRangeArray capacity;                 // 约束(5) [t]，上界为 C
+    IloArray<IloRangeArray> family_setup;   // 约束(6.1) [g][t]，y_gt / lambda_gt 系数为 -M_gt
+    IloArray<IloRangeArray> flow_limit;     // 约束(3) [f][t]，上界为 D_ft
+};
+
+// 时间窗稀疏变量
+// vars[i] 长度仍为 num_periods，但只为 t >= first[i] 创建变量，其余位置为空句柄；
+// 约束与目标中跳过窗口外位置，等价于原来的 x_it = 0 (t < e_i) / b_it = 0 (t < l_i) 固定行
+IloArray<IloNumVarArray> CreateWindowVars(IloEnv env, const vector<int>& first,
+                                          int num_periods);
+
+// 读取时间窗稀疏变量取值，窗口外 (空句柄) 返回 0
+double WindowValue(IloCplex& cplex, const IloArray<IloNumVarArray>& vars, int i, int t);
+
+// 构建完整模型 (目标函数与全部约束) 并加入 model；rows 非空时记录可修改的行
+void BuildLotSizingModel(IloEnv env, IloModel model,
+                         const AllValues& values, const AllLists& lists,
+                         LotSizingVars& vars, LotSizingRows* rows = nullptr);
+
+// 把完整模型的全部变量登记到环境池借用 (归还时结束，见 cplex_pool.h)
+void OwnLotSizingVars(CplexLease& lease, const LotSizingVars& vars);
+
+// 约束3: 产品大类 setup 约束 sum_{i in g} s_i x_it <= M_gt (y_gt + lambda_gt)
+// M_gt 由 ComputeFamilyBigM 按 capacity 计算；values.item_vub 开启时
+// 额外加入订单级上界 x_it <= d_i (y_gt + lambda_gt)。rows 非空时记录 [g][t] 行。
+// late_window_closed 表示模型禁止 t > l_i 的生产 (见 ComputeFamilyBigM)
+void AddFamilySetupConstraints(IloEnv env, IloModel model,
+                               const AllValues& values, const AllLists& lists,
+                               const IloArray<IloNumVarArray>& X,
+                               const IloArray<IloNumVarArray>& Y,
+                               const IloArray<IloNumVarArray>& Lambda,
+                               double capacity,
+                               IloArray<IloRangeArray>* rows = nullptr,
+                               bool late_window_closed = false);
+
+// 每期 setup 总数 S_t = sum_g y_gt (连续变量，由等式行定义)
+IloNumVarArray AddSetupCount(IloEnv env, IloModel model,
+                             const IloArray<IloNumVarArray>& Y,
+                             int num_groups, int num_periods);
+
+// 约束9: Carryover排他性 (t >= 1)
+//   逐对写法: lambda_gt + lambda_{g,t-1} + y_gt - sum_{g'!=g} y_g't <= 2，非零元 O(G^2 T)
+//   聚合写法: lambda_gt + lambda_{g,t-1} + 2 y_gt - S_t <= 2，非零元 O(G T)
+// 两种写法只差 S_t 的代入，LP 松弛与整数最优解完全相同，由 values.aggregate_exclusivity 选择
+// 返回聚合写法新建的 S_t (逐对写法为空句柄)，供环境池归还时结束 (CplexLease::Own)
+IloNumVarArray AddCarryoverExclusivity(IloEnv env, IloModel model, const AllValues& values,
+                                       const IloArray<IloNumVarArray>& Y,
+                                       const IloArray<IloNumVarArray>& Lambda,
+                                       int num_groups, int num_periods);
+
+#endif  // LOT_SIZING_MODEL_H_
@@ -0,0 +1,41 @@
+// model_bounds.cpp - 模型预处理: 紧 Big-M
+
+#include "model_bounds.h"
+
+vector<vector<double>> ComputeFamilyBigM(const AllValues& values,
+                                         const AllLists& lists,
+                                         double capacity,
+                                         bool late_window_closed) {
+    const int N = values.number_of_items;
+    const int T = values.number_of_periods;
+    const int G = values.number_of_groups;
+
+    vector<vector<double>> big_m(G, vector<double>(T, capacity));
+    if (!values.tight_big_m) {
+        return big_m;
+    }
+
+    // 按生产窗口差分: released[g][t] = sum_{i in g, e_i = t} s_i d_i - sum_{i in g, 关闭期 = t} s_i d_i
+    vector<vector<double>> released(G, vector<double>(T, 0.0));
+    for (int i = 0; i < N; i++) {
+        int ew = max(0, lists.ew_x[i]);
+        int close = late_window_closed ? lists.lw_x[i] + 1 : T;   // 第一个不可生产的周期
+        if (ew >= T || close <= ew) continue;
+        double usage = static_cast<double>(lists.usage_x[i]) * lists.final_demand[i];
+        for (int g = 0; g < G; g++) {
+            if (lists.group_flag[i][g]) {
+                released[g][ew] += usage;
+                if (close < T) released[g][close] -= usage;
+            }
+        }
+    }
+
+    for (int g = 0; g < G; g++) {
+        double cumulative = 0.0;
+        for (int t = 0; t < T; t++) {
+            cumulative += released[g][t];
+            big_m[g][t] = min(capacity, max(0.0, cumulative));
+        }
+    }
+    return big_m;
+}
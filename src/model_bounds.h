@@ -0,0 +1,23 @@
+// model_bounds.h - 模型预处理: 紧 Big-M
+// 大类 setup 约束 sum_{i in g} s_i x_it <= M_gt (y_gt + lambda_gt) 中，
+// M_gt 取产能与该大类在 t 期可生产订单总占用的较小者，收紧 LP 松弛
+
+#ifndef MODEL_BOUNDS_H_
+#define MODEL_BOUNDS_H_
+
+#include "optimizer.h"
+
+// 每个 (g,t) 的 Big-M
+// M_gt = min(capacity, sum_{i in g, e_i <= t} s_i d_i)
+// 由 sum_t x_it <= d_i (终期欠交非负) 与 x_it = 0 (t < e_i) 推出，对任意可行解成立。
+// late_window_closed: 模型另以 x_it = 0 禁止 t > l_i 的生产时 (FO 最终求解、RR 第三步)，
+// 只累加 e_i <= t <= l_i 的订单，即 t 期仍可生产的订单的需求。
+// 各模型只固定 y/lambda 而不固定 x，订单的剩余需求即 d_i；y/lambda 已固定的 (g,t) 行
+// 退化为 x = 0 或普通上界，M 的取值不影响松弛，因此不按固定前缀另行收紧。
+// values.tight_big_m 关闭时全部返回 capacity
+vector<vector<double>> ComputeFamilyBigM(const AllValues& values,
+                                         const AllLists& lists,
+                                         double capacity,
+                                         bool late_window_closed = false);
+
+#endif  // MODEL_BOUNDS_H_
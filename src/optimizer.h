@@ -58,6 +58,45 @@ inline const char* AlgorithmName(AlgorithmType algo) {
     }
 }
 
+// 后台根节点下界模式
+enum class RootBoundMode {
+    Off,    // 关闭
+    LP,     // 完整模型 LP 松弛
+    Root    // 完整模型根节点 MIP (含割平面)
+};
+
+inline const char* RootBoundModeName(RootBoundMode mode) {
+    switch (mode) {
+        case RootBoundMode::Off:  return "off";
+        case RootBoundMode::LP:   return "lp";
+        case RootBoundMode::Root: return "root";
+        default: return "unknown";
+    }
+}
+
+// RF 窗口扩展重试方式
+enum class RFRetryMode {
+    Sequential,        // W+1, W+2, ... 逐个尝试
+    Parallel,          // 全部重试窗口并发求解，取最小可行窗口
+    ParallelRollback   // 同上，并同时求解回滚后的候选子问题
+};
+
+inline const char* RFRetryModeName(RFRetryMode mode) {
+    switch (mode) {
+        case RFRetryMode::Sequential:       return "seq";
+        case RFRetryMode::Parallel:         return "par";
+        case RFRetryMode::ParallelRollback: return "par-rollback";
+        default: return "unknown";
+    }
+}
+
+// 用户割平面作用范围 (AllValues::user_cut_scope 按位组合)
+constexpr int kCutScopeDirect = 1 << 0;  // 完整模型直接求解与后台根节点下界
+constexpr int kCutScopeRF = 1 << 1;      // RF 子问题 (含 RFO 的 RF 阶段)
+constexpr int kCutScopeFO = 1 << 2;      // FO 窗口与 FO 最终求解
+constexpr int kCutScopeRR = 1 << 3;      // RR 阶段1
+constexpr int kCutScopeAll = kCutScopeDirect | kCutScopeRF | kCutScopeFO | kCutScopeRR;
+
 // ============================================================================
 // 业务常量
 // ============================================================================
@@ -142,8 +181,34 @@ struct SolutionMetrics {
     vector<double> capacity_util_by_period;  // 各周期产能利用率
 
     // CPLEX 求解器指标
-    long cplex_nodes = 0;              // 探索节点数
-    int cplex_iterations = 0;          // MIP迭代次数
+    long cplex_nodes = 0;              // 探索节点数 (算法内全部 MIP 求解累计，见 RecordSolveEffort)
+    long cplex_iterations = 0;         // 单纯形迭代数 (同上)
+
+    // CPLEX 环境池 (见 cplex_pool.h)
+    int pool_envs_created = 0;         // 创建的环境数
+    long pool_leases = 0;              // 借出次数 (= 子问题求解次数)
+    long pool_warm_leases = 0;         // 复用已有环境的借出次数
+    double pool_startup_time = 0.0;    // 环境创建耗时 (初始化 + 许可证 + 通用参数)
+    double pool_overhead_time = 0.0;   // 借出/装载/归还耗时
+
+    // 下界与间隙
+    double lower_bound = -1.0;         // 最优下界 (-1 表示无)
+    double lr_bound = -1.0;            // Lagrangian 下界
+    int lr_iterations = 0;             // Lagrangian 次梯度迭代次数
+    double lr_time = 0.0;              // Lagrangian 计算耗时
+    double root_bound = -1.0;          // 后台根节点/LP 下界
+    double root_time = 0.0;            // 后台下界求解耗时
+
+    // 用户割平面 (各次求解累加)
+    long cut_calls = 0;                // 分离回调次数
+    long cuts_added = 0;               // 加入割数
+    double cut_time = 0.0;             // 分离耗时
+    double cut_root_gain = 0.0;        // 根节点 LP 目标提升
+
+    // 子问题预筛 (见 prescreen.h)
+    long prescreen_checks = 0;         // 预筛次数
+    long prescreen_rejects = 0;        // 判定必然不可行而跳过求解的次数
+    double prescreen_time = 0.0;       // 预筛耗时
 
     // ========== RF 算法特有指标 ==========
     int rf_iterations = 0;             // RF主循环迭代次数
@@ -152,6 +217,12 @@ struct SolutionMetrics {
     int rf_subproblems = 0;            // 求解的子问题数
     double rf_avg_subproblem_time = 0.0;  // 子问题平均求解时间
     double rf_final_solve_time = 0.0;  // 最终求解时间
+    long rf_cache_hits = 0;            // 子问题缓存命中数 (RF/RFO 的 RF 阶段)
+    long rf_cache_misses = 0;          // 子问题缓存未命中数
+    int rf_parallel_batches = 0;       // 并行重试批次数
+    int rf_parallel_cancelled = 0;     // 被更小可行窗口淘汰而中止的子问题数
+    int rf_spec_launched = 0;          // 推测求解启动数
+    int rf_spec_hits = 0;              // 推测结论被采用数 (临时固定值与实际一致)
 
     // ========== RFO 算法特有指标 ==========
     double rfo_rf_objective = 0.0;     // RF阶段目标值
@@ -173,6 +244,48 @@ struct SolutionMetrics {
     double rr_step3_time = 0.0;        // 阶段3耗时
     double rr_step3_gap_to_step1 = 0.0;   // Step3与Step1的gap
     double rr_carryover_utilization = 0.0; // carryover利用率
+
+    // ========== 滚动重排程 (见 replan.h) ==========
+    bool replan = false;               // 本次为重排程
+    int replan_shift = 0;              // 计划期前移周期数
+    int replan_frozen = 0;             // 冻结周期数 (沿用旧计划)
+    int replan_affected_periods = 0;   // 重新优化的周期数
+    int replan_orders_added = 0;       // 新增订单数
+    int replan_orders_removed = 0;     // 删除 (完工/取消) 订单数
+    int replan_orders_expired = 0;     // 移出计划期而丢弃的订单数
+    int replan_orders_completed = 0;   // 已执行周期内生产完毕的订单数
+    bool replan_fallback = false;      // 旧计划不可行，退回完整 RFO
+    double replan_warm_objective = -1.0;  // 映射后旧计划的目标值
+    int replan_overlap_periods = 0;    // 新旧计划重叠的周期数
+    int replan_setup_changes = 0;      // 重叠周期内 y 变化的 (g,t) 数
+    int replan_carryover_changes = 0;  // 重叠周期内 lambda 变化的 (g,t) 数
+    int replan_periods_changed = 0;    // 有任何变化的周期数
+    int replan_first_changed = -1;     // 第一个变化周期 (-1 表示无)
+    double replan_volume_change = 0.0;     // 各周期生产总量变化绝对值之和
+    double replan_volume_change_pct = 0.0; // 相对旧计划生产总量的比例
+    string replan_instance_file;       // 写出的新算例 (供下一次重排程)
+
+    // ========== 灵敏度 (见 sensitivity.h) ==========
+    // 对偶值为目标对右端项的导数: 多 1 单位产能/下游能力时目标的变化 (<= 0)
+    bool sensitivity = false;          // 已求解固定整数变量的 LP
+    double sensitivity_objective = -1.0;   // 固定 LP 目标值 (应与最终目标一致)
+    double sensitivity_time = 0.0;     // 固定 LP 求解耗时
+    vector<double> capacity_dual;      // 产能行对偶 [t]
+    vector<double> capacity_slack;     // 产能余量 [t]
+    vector<double> capacity_rhs_low;   // 对偶不变的产能下限 [t]
+    vector<double> capacity_rhs_high;  // 对偶不变的产能上限 [t]
+    vector<vector<double>> flow_limit_dual;      // 下游能力行对偶 [f][t]
+    vector<vector<double>> flow_limit_slack;     // 下游能力余量 [f][t]
+    vector<vector<double>> flow_limit_rhs_low;   // 对偶不变的 D_ft 下限 [f][t]
+    vector<vector<double>> flow_limit_rhs_high;  // 对偶不变的 D_ft 上限 [f][t]
+    vector<vector<double>> setup_reduced_cost;      // y_gt 检验数 [g][t]
+    vector<vector<double>> carryover_reduced_cost;  // lambda_gt 检验数 [g][t]
+    vector<double> unmet_reduced_cost; // u_i 检验数 [i]
+    vector<vector<double>> production_reduced_cost; // x_it 检验数 [i][t] (窗口外为 0)
+    vector<vector<double>> production_cost_low;     // 最优基不变的 x_it 目标系数下限 [i][t]
+    vector<vector<double>> production_cost_high;    // 同上，上限 (窗口外或无界为 +-1e20)
+    vector<vector<double>> backlog_cost_low;        // 最优基不变的 b_it 目标系数下限 [i][t]
+    vector<vector<double>> backlog_cost_high;       // 同上，上限 (窗口外或无界为 +-1e20)
 };
 
 // RF 算法状态
@@ -193,6 +306,16 @@ struct FOState {
     double current_objective;            // 当前目标值
     int rounds_completed;                // 已完成轮数
     int windows_improved;                // 改进的窗口数
+    int frozen_until = 0;                // 周期 [0, frozen_until) 不进入窗口 (重排程)
+    vector<bool> period_active;          // 只优化核心窗口含活跃周期的窗口，空表示全部
+};
+
+// 重排程暖启动: 旧计划映射到新计划期后的 (y, lambda) 与需要重新优化的周期
+struct ReplanWarmStart {
+    vector<vector<int>> y;               // [g][t]
+    vector<vector<int>> lambda;          // [g][t]
+    int frozen = 0;                      // 冻结周期数
+    vector<bool> active;                 // 受影响周期 [t]
 };
 
 // 大订单结构体
@@ -208,6 +331,12 @@ struct BigOrder {
     double production_cost = -1.0;
 };
 
+// 一个求解阶段使用的 CPLEX 参数配置 (见 cplex_params.h)
+struct CplexPhaseProfile {
+    std::string name;                                          // 配置文件中的节名
+    std::vector<std::pair<std::string, std::string>> params;   // 参数名与值
+};
+
 // 全局参数配置
 struct AllValues {
     // 算法求解结果
@@ -248,6 +377,9 @@ struct AllValues {
     int rf_step = kRFFixStep;             // RF固定步长
     double rf_time = kRFSubproblemTimeLimit;  // RF子问题时限
     int rf_retries = kRFMaxRetries;       // RF最大重试
+    bool rf_cache = true;                 // 缓存 RF 子问题结果 (回滚后不重复求解)
+    RFRetryMode rf_retry_mode = RFRetryMode::Sequential;  // RF 窗口扩展重试方式
+    int rf_speculate = 0;                 // 推测 RF 链长 (0=关闭)
 
     // FO算法参数 (用于RFO)
     int fo_window = kFOWindowSize;        // FO窗口大小
@@ -260,6 +392,27 @@ struct AllValues {
     double rr_capacity = 1.2;             // RR产能放大系数
     double rr_bonus = 50.0;               // RR连续启动奖励
 
+    // 下界参数
+    int lr_iterations = 200;              // Lagrangian 次梯度迭代上限 (0=关闭)
+    int lr_threads = 0;                   // Lagrangian 并行线程数 (0=自动)
+    RootBoundMode root_bound_mode = RootBoundMode::Off;  // 后台根节点下界模式
+    double root_time = 60.0;              // 后台下界求解时限
+    int root_threads = 0;                 // 后台下界线程数 (0=空闲核数)
+    double root_wait = 0.0;               // 启发式结束后等待后台下界的最长时间
+
+    // 模型构建参数
+    bool aggregate_exclusivity = true;    // 约束9 使用每期 setup 总数的聚合写法
+    bool tight_big_m = true;              // 大类 setup 约束使用逐 (g,t) 紧 Big-M
+    bool item_vub = false;                // 加入订单级上界 x_it <= d_i (y_gt + lambda_gt)
+    int user_cut_scope = 0;               // 用户割平面作用范围 (kCutScope* 组合，0=关闭)
+
+    // 子问题转储 (见 subproblem_dump.h)
+    std::string dump_dir = "";            // 转储目录，空表示不转储
+    std::string dump_format = "lp";       // 模型文件格式: lp / mps / sav
+
+    // 分阶段 CPLEX 参数配置 (阶段名 -> 配置，见 cplex_params.h)，没有配置的阶段用 CPLEX 默认值
+    std::map<std::string, CplexPhaseProfile> cplex_phase_profiles;
+
     // 解的质量指标
     SolutionMetrics metrics;
 
@@ -384,6 +537,9 @@ void SolveRF(AllValues& values, AllLists& lists);
 // RFO (RF + Fix-and-Optimize) 算法
 void SolveRFO(AllValues& values, AllLists& lists);
 
+// 滚动重排程: 以映射后的旧计划代替 RF 初始解，只对受影响周期做 FO (见 replan.h)
+void SolveReplan(AllValues& values, AllLists& lists, const ReplanWarmStart& warm);
+
 // ============================================================================
 // 大订单处理
 // ============================================================================
@@ -4,6 +4,7 @@
  */
 
 #include "optimizer.h"
+#include "lot_sizing_model.h"
 #include "common.h"
 #include <filesystem>
 #include <fstream>
@@ -12,22 +13,6 @@
 
 using namespace std;
 
-// JSON string escaping helper
-static string JsonEscape(const string& s) {
-    string result;
-    for (char c : s) {
-        switch (c) {
-            case '"': result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default: result += c;
-        }
-    }
-    return result;
-}
-
 // Output solution to JSON file
 void OutputSolutionJSON(const string& filepath,
                         const string& algorithm,
@@ -124,7 +109,7 @@ void OutputSolutionJSON(const string& filepath,
     for (int i = 0; i < values.number_of_items; i++) {
         fout << "        [";
         for (int t = 0; t < values.number_of_periods; t++) {
-            double val = cplex.getValue(X[i][t]);
+            double val = WindowValue(cplex, X, i, t);
             fout << setprecision(0) << val;
             if (t + 1 < values.number_of_periods) fout << ", ";
         }
@@ -200,7 +185,7 @@ void OutputSolutionJSON(const string& filepath,
     for (int i = 0; i < values.number_of_items; i++) {
         fout << "        [";
         for (int t = 0; t < values.number_of_periods; t++) {
-            double val = cplex.getValue(B[i][t]);
+            double val = WindowValue(cplex, B, i, t);
             fout << setprecision(0) << val;
             if (t + 1 < values.number_of_periods) fout << ", ";
         }
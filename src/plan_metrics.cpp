@@ -0,0 +1,138 @@
+// plan_metrics.cpp - 最终计划的提取与指标实现
+
+#include "plan_metrics.h"
+#include "lot_sizing_model.h"
+#include <mutex>
+
+void ExtractFinalPlan(IloCplex& cplex, const AllValues& values, AllLists& lists,
+                      const IloArray<IloNumVarArray>& X, const IloArray<IloNumVarArray>& B,
+                      const IloArray<IloNumVarArray>& I, const IloNumVarArray& U) {
+    int N = values.number_of_items;
+    int T = values.number_of_periods;
+    int F = values.number_of_flows;
+
+    lists.small_x.resize(N);
+    lists.small_b.resize(N);
+    lists.small_u.resize(N);
+    lists.small_i.resize(F);
+
+    for (int i = 0; i < N; i++) {
+        lists.small_x[i].resize(T);
+        lists.small_b[i].resize(T);
+        for (int t = 0; t < T; t++) {
+            lists.small_x[i][t] = WindowValue(cplex, X, i, t);
+            lists.small_b[i][t] = WindowValue(cplex, B, i, t);
+        }
+        lists.small_u[i] = cplex.getValue(U[i]);
+    }
+
+    for (int f = 0; f < F; f++) {
+        lists.small_i[f].resize(T);
+        for (int t = 0; t < T; t++) {
+            lists.small_i[f][t] = cplex.getValue(I[f][t]);
+        }
+    }
+}
+
+void RecordSolveEffort(AllValues& values, IloCplex& cplex) {
+    long nodes = static_cast<long>(cplex.getNnodes());
+    long iterations = static_cast<long>(cplex.getNiterations());
+
+    static std::mutex record_mutex;
+    std::lock_guard<std::mutex> lock(record_mutex);
+    values.metrics.cplex_nodes += nodes;
+    values.metrics.cplex_iterations += iterations;
+}
+
+void ComputePlanMetrics(AllValues& values, const AllLists& lists) {
+    auto& m = values.metrics;
+    int T = values.number_of_periods;
+
+    // Cost breakdown (from saved variables)
+    m.cost_production = 0.0;
+    m.cost_setup = 0.0;
+    m.cost_inventory = 0.0;
+    m.cost_backorder = 0.0;
+    m.cost_unmet = 0.0;
+
+    for (int i = 0; i < values.number_of_items; ++i) {
+        for (int t = 0; t < T; ++t) {
+            m.cost_production += lists.cost_x[i] * lists.small_x[i][t];
+            m.cost_backorder += lists.cost_b[i] * lists.small_b[i][t];
+        }
+        m.cost_unmet += lists.cost_u[i] * lists.small_u[i];
+    }
+
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        for (int t = 0; t < T; ++t) {
+            m.cost_setup += lists.cost_y[g] * lists.small_y[g][t];
+        }
+    }
+
+    for (int f = 0; f < values.number_of_flows; ++f) {
+        for (int t = 0; t < T; ++t) {
+            m.cost_inventory += lists.cost_i[f] * lists.small_i[f][t];
+        }
+    }
+
+    // Setup/Carryover statistics
+    m.total_setups = 0;
+    m.total_carryovers = 0;
+    m.saved_setup_cost = 0.0;
+
+    for (int g = 0; g < values.number_of_groups; ++g) {
+        for (int t = 0; t < T; ++t) {
+            if (lists.small_y[g][t] == 1) m.total_setups++;
+            if (lists.small_l[g][t] == 1) {
+                m.total_carryovers++;
+                m.saved_setup_cost += lists.cost_y[g];
+            }
+        }
+    }
+
+    // Demand fulfillment
+    m.unmet_count = 0;
+    m.total_backorder = 0.0;
+    m.total_demand = 0.0;
+    int on_time_count = 0;
+
+    for (int i = 0; i < values.number_of_items; ++i) {
+        m.total_demand += lists.final_demand[i];
+        if (lists.small_u[i] > 0.5) {
+            m.unmet_count++;
+        } else {
+            int lw = lists.lw_x[i];
+            if (lw < T && lists.small_b[i][lw] < 0.5) {
+                on_time_count++;
+            }
+        }
+        int T_last = T - 1;
+        m.total_backorder += lists.small_b[i][T_last];
+    }
+
+    m.unmet_rate = values.number_of_items > 0
+        ? (double)m.unmet_count / values.number_of_items : 0.0;
+    m.on_time_rate = values.number_of_items > 0
+        ? (double)on_time_count / values.number_of_items : 0.0;
+
+    // Capacity utilization
+    m.capacity_util_by_period.resize(T);
+    m.capacity_util_avg = 0.0;
+    m.capacity_util_max = 0.0;
+
+    for (int t = 0; t < T; ++t) {
+        double usage = 0.0;
+        for (int i = 0; i < values.number_of_items; ++i) {
+            usage += lists.usage_x[i] * lists.small_x[i][t];
+        }
+        for (int g = 0; g < values.number_of_groups; ++g) {
+            usage += lists.usage_y[g] * lists.small_y[g][t];
+        }
+        double util = values.machine_capacity > 0
+            ? usage / values.machine_capacity : 0.0;
+        m.capacity_util_by_period[t] = util;
+        m.capacity_util_avg += util;
+        if (util > m.capacity_util_max) m.capacity_util_max = util;
+    }
+    m.capacity_util_avg /= T;
+}
@@ -0,0 +1,22 @@
+// plan_metrics.h - 最终计划的提取与指标
+// RF/RFO/RR 最终求解后共用: 从求解器读出 x, b, u, I 写入 lists.small_*，
+// 再由 lists 中的计划计算成本分解、setup/carryover、需求满足与产能利用指标 (values.metrics)。
+// 各子问题求解的节点数与迭代数累计到 metrics.cplex_nodes / cplex_iterations (回归基线使用)
+
+#ifndef PLAN_METRICS_H_
+#define PLAN_METRICS_H_
+
+#include "optimizer.h"
+
+// 读出最终求解的 x_it, b_it (时间窗稀疏变量)、u_i 与 I_ft
+void ExtractFinalPlan(IloCplex& cplex, const AllValues& values, AllLists& lists,
+                      const IloArray<IloNumVarArray>& X, const IloArray<IloNumVarArray>& B,
+                      const IloArray<IloNumVarArray>& I, const IloNumVarArray& U);
+
+// 累计一次求解的节点数与迭代数 (RF 并行重试时多个子问题同时汇总)
+void RecordSolveEffort(AllValues& values, IloCplex& cplex);
+
+// 由 lists.small_x/b/u/i 与 small_y/l 计算指标；算法专属指标由各求解器另行填写
+void ComputePlanMetrics(AllValues& values, const AllLists& lists);
+
+#endif  // PLAN_METRICS_H_
@@ -0,0 +1,386 @@
+// plan_state.cpp - 增量计划状态实现
+//
+// 约束实例的归属:
+//   (g,t) 单元格变化只影响 y_gt/lambda_gt 自身以及 t+1 上以 lambda_gt 为前驱的实例
+//   约束7:  sum_g lambda_gt <= 1           -> 周期 t 的 sum_lambda
+//   约束8:  lambda_gt <= y_{g,t-1} + lambda_{g,t-1} (t=0 时前驱视为 0，即约束10)
+//   约束9:  lambda_gt + lambda_{g,t-1} + y_gt - sum_{g'!=g} y_g't <= 2
+//           仅当 y_gt=lambda_gt=lambda_{g,t-1}=1 且 sum_y_t=1 时违反
+//   覆盖:   大类 g 在 t 有生产时需 y_gt + lambda_gt >= 1
+
+#include "plan_state.h"
+#include "logger.h"
+
+PlanState::PlanState(const AllValues& values, const AllLists& lists)
+    : values_(values), lists_(lists) {
+    G_ = values.number_of_groups;
+    T_ = values.number_of_periods;
+    capacity_ = values.machine_capacity;
+    penalty_ = values.u_penalty;
+}
+
+void PlanState::Load(const vector<vector<int>>& y, const vector<vector<int>>& lambda) {
+    int N = values_.number_of_items;
+    int F = values_.number_of_flows;
+
+    y_.assign(G_, vector<int>(T_, 0));
+    lambda_.assign(G_, vector<int>(T_, 0));
+    for (int g = 0; g < G_ && g < static_cast<int>(y.size()); g++) {
+        for (int t = 0; t < T_ && t < static_cast<int>(y[g].size()); t++) {
+            y_[g][t] = y[g][t] ? 1 : 0;
+        }
+    }
+    for (int g = 0; g < G_ && g < static_cast<int>(lambda.size()); g++) {
+        for (int t = 0; t < T_ && t < static_cast<int>(lambda[g].size()); t++) {
+            lambda_[g][t] = lambda[g][t] ? 1 : 0;
+        }
+    }
+
+    // X 计划决定的固定量
+    family_usage_.assign(G_, vector<double>(T_, 0.0));
+    prod_usage_.assign(T_, 0.0);
+    cost_ = PlanCost();
+
+    bool has_x = static_cast<int>(lists_.small_x.size()) >= N;
+    for (int i = 0; i < N && has_x; i++) {
+        int group = -1;
+        for (int g = 0; g < G_; g++) {
+            if (lists_.group_flag[i][g]) {
+                group = g;
+                break;
+            }
+        }
+        for (int t = 0; t < T_ && t < static_cast<int>(lists_.small_x[i].size()); t++) {
+            double x = lists_.small_x[i][t];
+            double usage = lists_.usage_x[i] * x;
+            prod_usage_[t] += usage;
+            if (group >= 0) family_usage_[group][t] += usage;
+            cost_.fixed += lists_.cost_x[i] * x;
+        }
+    }
+    for (int i = 0; i < N && i < static_cast<int>(lists_.small_b.size()); i++) {
+        for (int t = lists_.lw_x[i]; t < T_ && t < static_cast<int>(lists_.small_b[i].size()); t++) {
+            cost_.fixed += lists_.cost_b[i] * lists_.small_b[i][t];
+        }
+    }
+    for (int i = 0; i < N && i < static_cast<int>(lists_.small_u.size()); i++) {
+        cost_.fixed += lists_.cost_u[i] * lists_.small_u[i];
+    }
+    for (int f = 0; f < F && f < static_cast<int>(lists_.small_i.size()); f++) {
+        for (int t = 0; t < T_ && t < static_cast<int>(lists_.small_i[f].size()); t++) {
+            cost_.fixed += lists_.cost_i[f] * lists_.small_i[f][t];
+        }
+    }
+
+    // 聚合量
+    setup_usage_.assign(T_, 0.0);
+    sum_y_.assign(T_, 0);
+    sum_lambda_.assign(T_, 0);
+    rule8_count_.assign(T_, 0);
+    triple_count_.assign(T_, 0);
+    uncovered_count_.assign(T_, 0);
+    active_count_.assign(G_, 0);
+
+    for (int g = 0; g < G_; g++) {
+        for (int t = 0; t < T_; t++) {
+            Account(g, t, +1);
+        }
+    }
+    for (int t = 0; t < T_; t++) {
+        cost_.chain_violations += PeriodViolations(t);
+        cost_.capacity_overflow += PeriodOverflow(t);
+    }
+
+    undo_stack_.clear();
+}
+
+void PlanState::Account(int g, int t, int sign) {
+    int y = y_[g][t];
+    int lambda = lambda_[g][t];
+    int prev_active = (t > 0) ? (y_[g][t-1] | lambda_[g][t-1]) : 0;
+    int prev_lambda = (t > 0) ? lambda_[g][t-1] : 0;
+
+    cost_.setup += sign * lists_.cost_y[g] * y;
+    setup_usage_[t] += sign * lists_.usage_y[g] * y;
+    sum_y_[t] += sign * y;
+    sum_lambda_[t] += sign * lambda;
+
+    if (lambda && !prev_active) rule8_count_[t] += sign;
+    if (y && lambda && prev_lambda) triple_count_[t] += sign;
+
+    if (!y && !lambda && family_usage_[g][t] > kEpsilon) {
+        uncovered_count_[t] += sign;
+        cost_.uncovered += sign;
+    }
+    if (y || lambda) active_count_[g] += sign;
+}
+
+int PlanState::PeriodViolations(int t) const {
+    int violations = rule8_count_[t];
+    if (sum_lambda_[t] > 1) violations += sum_lambda_[t] - 1;
+    if (sum_y_[t] == 1) violations += triple_count_[t];
+    return violations;
+}
+
+double PlanState::PeriodOverflow(int t) const {
+    double usage = setup_usage_[t] + prod_usage_[t];
+    return usage > capacity_ ? usage - capacity_ : 0.0;
+}
+
+void PlanState::SetCell(int var, int g, int t, int value) {
+    int& cell = (var == 0) ? y_[g][t] : lambda_[g][t];
+    if (cell == value) return;
+
+    int last = min(t + 1, T_ - 1);
+
+    for (int p = t; p <= last; p++) {
+        cost_.chain_violations -= PeriodViolations(p);
+    }
+    cost_.capacity_overflow -= PeriodOverflow(t);
+
+    Account(g, t, -1);
+    if (last > t) Account(g, last, -1);
+
+    cell = value;
+
+    Account(g, t, +1);
+    if (last > t) Account(g, last, +1);
+
+    for (int p = t; p <= last; p++) {
+        cost_.chain_violations += PeriodViolations(p);
+    }
+    cost_.capacity_overflow += PeriodOverflow(t);
+}
+
+bool PlanState::Expand(const PlanMove& move, UndoRecord& record) const {
+    record.count = 0;
+    auto in_range = [this](int g, int t) {
+        return g >= 0 && g < G_ && t >= 0 && t < T_;
+    };
+
+    switch (move.type) {
+        case MoveType::FlipY:
+            if (!in_range(move.g, move.t)) return false;
+            record.cells[record.count++] = {0, move.g, move.t,
+                                            y_[move.g][move.t], 1 - y_[move.g][move.t]};
+            return true;
+
+        case MoveType::FlipLambda:
+            if (!in_range(move.g, move.t)) return false;
+            record.cells[record.count++] = {1, move.g, move.t,
+                                            lambda_[move.g][move.t], 1 - lambda_[move.g][move.t]};
+            return true;
+
+        case MoveType::Swap: {
+            if (!in_range(move.g, move.t) || !in_range(move.g2, move.t)) return false;
+            if (move.g == move.g2) return false;
+            int t = move.t;
+            int y1 = y_[move.g][t], y2 = y_[move.g2][t];
+            int l1 = lambda_[move.g][t], l2 = lambda_[move.g2][t];
+            if (y1 != y2) {
+                record.cells[record.count++] = {0, move.g, t, y1, y2};
+                record.cells[record.count++] = {0, move.g2, t, y2, y1};
+            }
+            if (l1 != l2) {
+                record.cells[record.count++] = {1, move.g, t, l1, l2};
+                record.cells[record.count++] = {1, move.g2, t, l2, l1};
+            }
+            return record.count > 0;
+        }
+
+        case MoveType::Shift:
+            if (!in_range(move.g, move.t) || !in_range(move.g, move.t2)) return false;
+            if (move.t == move.t2) return false;
+            if (y_[move.g][move.t] != 1 || y_[move.g][move.t2] != 0) return false;
+            record.cells[record.count++] = {0, move.g, move.t, 1, 0};
+            record.cells[record.count++] = {0, move.g, move.t2, 0, 1};
+            return true;
+    }
+    return false;
+}
+
+void PlanState::ApplyRecord(const UndoRecord& record, bool forward) {
+    if (forward) {
+        for (int c = 0; c < record.count; c++) {
+            const CellChange& cell = record.cells[c];
+            SetCell(cell.var, cell.g, cell.t, cell.new_value);
+        }
+    } else {
+        for (int c = record.count - 1; c >= 0; c--) {
+            const CellChange& cell = record.cells[c];
+            SetCell(cell.var, cell.g, cell.t, cell.old_value);
+        }
+    }
+}
+
+MoveDelta PlanState::Evaluate(const PlanMove& move) {
+    MoveDelta delta;
+    UndoRecord record;
+    if (!Expand(move, record)) return delta;
+
+    PlanCost before = cost_;
+    ApplyRecord(record, true);
+    PlanCost after = cost_;
+    ApplyRecord(record, false);
+    cost_ = before;  // 消除浮点累积误差
+
+    delta.valid = true;
+    delta.setup = after.setup - before.setup;
+    delta.capacity_overflow = after.capacity_overflow - before.capacity_overflow;
+    delta.uncovered = after.uncovered - before.uncovered;
+    delta.chain_violations = after.chain_violations - before.chain_violations;
+    delta.total = after.Total(penalty_) - before.Total(penalty_);
+    return delta;
+}
+
+bool PlanState::Apply(const PlanMove& move) {
+    UndoRecord record;
+    if (!Expand(move, record)) return false;
+    ApplyRecord(record, true);
+    undo_stack_.push_back(record);
+    return true;
+}
+
+bool PlanState::Undo() {
+    if (undo_stack_.empty()) return false;
+    ApplyRecord(undo_stack_.back(), false);
+    undo_stack_.pop_back();
+    return true;
+}
+
+PlanCost PlanState::EvaluateFull() const {
+    PlanCost full;
+    full.fixed = cost_.fixed;
+
+    for (int t = 0; t < T_; t++) {
+        double usage = prod_usage_[t];
+        int sum_y = 0;
+        int sum_lambda = 0;
+        for (int g = 0; g < G_; g++) {
+            usage += lists_.usage_y[g] * y_[g][t];
+            full.setup += lists_.cost_y[g] * y_[g][t];
+            sum_y += y_[g][t];
+            sum_lambda += lambda_[g][t];
+        }
+        if (usage > capacity_) full.capacity_overflow += usage - capacity_;
+
+        // 约束7
+        if (sum_lambda > 1) full.chain_violations += sum_lambda - 1;
+
+        for (int g = 0; g < G_; g++) {
+            // 约束10 / 约束8
+            if (t == 0) {
+                if (lambda_[g][t]) full.chain_violations++;
+            } else if (lambda_[g][t] > y_[g][t-1] + lambda_[g][t-1]) {
+                full.chain_violations++;
+            }
+            // 约束9
+            if (t > 0) {
+                int other_y = sum_y - y_[g][t];
+                if (lambda_[g][t] + lambda_[g][t-1] + y_[g][t] - other_y > 2) {
+                    full.chain_violations++;
+                }
+            }
+            // 生产覆盖
+            if (family_usage_[g][t] > kEpsilon && y_[g][t] + lambda_[g][t] == 0) {
+                full.uncovered++;
+            }
+        }
+    }
+    return full;
+}
+
+bool PlanState::CheckConsistency(string* report) const {
+    PlanCost full = EvaluateFull();
+    ostringstream oss;
+    bool ok = true;
+
+    auto check = [&](const char* name, double incremental, double expected) {
+        double tolerance = 1e-6 * max(1.0, fabs(expected));
+        if (fabs(incremental - expected) > tolerance) {
+            oss << name << ": 增量=" << incremental << " 全量=" << expected << "; ";
+            ok = false;
+        }
+    };
+
+    check("setup", cost_.setup, full.setup);
+    check("capacity_overflow", cost_.capacity_overflow, full.capacity_overflow);
+    check("uncovered", cost_.uncovered, full.uncovered);
+    check("chain_violations", cost_.chain_violations, full.chain_violations);
+
+    for (int g = 0; g < G_; g++) {
+        int active = 0;
+        for (int t = 0; t < T_; t++) {
+            if (y_[g][t] || lambda_[g][t]) active++;
+        }
+        if (active != active_count_[g]) {
+            oss << "active[" << g << "]: 增量=" << active_count_[g] << " 全量=" << active << "; ";
+            ok = false;
+        }
+    }
+
+    if (!ok && report) *report = oss.str();
+    return ok;
+}
+
+PlanStateBenchmarkResult BenchmarkPlanState(const AllValues& values,
+                                            const AllLists& lists,
+                                            long num_moves,
+                                            unsigned int seed) {
+    PlanStateBenchmarkResult result;
+    int G = values.number_of_groups;
+    int T = values.number_of_periods;
+    if (G <= 0 || T <= 0 || num_moves <= 0) return result;
+
+    PlanState state(values, lists);
+    state.Load(lists.small_y, lists.small_l);
+    result.start_objective = state.Objective();
+
+    mt19937 rng(seed);
+    uniform_int_distribution<int> pick_type(0, 3);
+    uniform_int_distribution<int> pick_g(0, G - 1);
+    uniform_int_distribution<int> pick_t(0, T - 1);
+
+    const long kCheckInterval = 4096;
+    auto start = chrono::steady_clock::now();
+
+    for (long m = 0; m < num_moves; m++) {
+        PlanMove move;
+        move.type = static_cast<MoveType>(pick_type(rng));
+        move.g = pick_g(rng);
+        move.t = pick_t(rng);
+        move.g2 = pick_g(rng);
+        move.t2 = (move.t + 1 < T && (rng() & 1)) ? move.t + 1 : max(0, move.t - 1);
+
+        MoveDelta delta = state.Evaluate(move);
+        result.moves++;
+
+        if (delta.valid && delta.total < -kEpsilon) {
+            state.Apply(move);
+            state.Commit();
+            result.applied++;
+        }
+
+        if ((m + 1) % kCheckInterval == 0 && !state.CheckConsistency()) {
+            result.consistent = false;
+        }
+    }
+
+    auto end = chrono::steady_clock::now();
+    result.seconds = chrono::duration<double>(end - start).count();
+    result.moves_per_second = result.seconds > 0 ? result.moves / result.seconds : 0.0;
+
+    string report;
+    if (!state.CheckConsistency(&report)) {
+        result.consistent = false;
+        LOG_FMT("[邻域] 增量状态与全量评价不一致: %s\n", report.c_str());
+    }
+    result.end_objective = state.Objective();
+
+    LOG_FMT("[邻域] 评价 %ld 次移动，接受 %ld 次，耗时 %.3fs (%.0f 次/秒)\n",
+            result.moves, result.applied, result.seconds, result.moves_per_second);
+    LOG_FMT("[邻域] 评价值: %.2f -> %.2f，一致性: %s\n",
+            result.start_objective, result.end_objective,
+            result.consistent ? "通过" : "失败");
+    return result;
+}
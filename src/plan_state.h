@@ -0,0 +1,173 @@
+// plan_state.h - 增量计划状态
+// 维护 (y, lambda) 计划的产能松弛、大类活跃周期、carryover 链有效性和成本分量
+// 支持 flip/swap/shift 邻域移动的增量评估、应用与撤销，供局部搜索使用
+
+#ifndef PLAN_STATE_H_
+#define PLAN_STATE_H_
+
+#include "optimizer.h"
+
+// 邻域移动类型
+enum class MoveType {
+    FlipY,       // 翻转 y[g][t]
+    FlipLambda,  // 翻转 lambda[g][t]
+    Swap,        // 交换周期 t 内大类 g 与 g2 的 (y, lambda)
+    Shift        // 将大类 g 的启动从周期 t 移到 t2
+};
+
+// 邻域移动
+struct PlanMove {
+    MoveType type = MoveType::FlipY;
+    int g = -1;
+    int t = -1;
+    int g2 = -1;   // Swap: 第二个大类
+    int t2 = -1;   // Shift: 目标周期
+};
+
+// 计划评价分量
+// setup 随 (y, lambda) 变化；fixed 为当前 X 计划下的生产/库存/欠交/未满足成本
+struct PlanCost {
+    double setup = 0.0;              // 启动成本
+    double fixed = 0.0;              // 固定部分成本
+    double capacity_overflow = 0.0;  // 产能超出量 (sum_t max(0, 用量 - C))
+    int uncovered = 0;               // 有生产但无 setup/carryover 的 (g,t) 数
+    int chain_violations = 0;        // carryover 规则违反数 (约束7-10)
+
+    // 带罚项的总评价值
+    double Total(double penalty) const {
+        return setup + fixed + penalty * (capacity_overflow + uncovered + chain_violations);
+    }
+};
+
+// 移动的增量评价结果
+struct MoveDelta {
+    bool valid = false;              // 移动是否合法 (如 Shift 要求源周期有启动)
+    double setup = 0.0;
+    double capacity_overflow = 0.0;
+    int uncovered = 0;
+    int chain_violations = 0;
+    double total = 0.0;              // 带罚项总评价的变化量
+};
+
+// 增量计划状态
+// 单个 (g,t) 变化只影响周期 t 与 t+1 上与 g 相关的约束实例，
+// 各周期聚合量 (sum_y, sum_lambda, 产能用量, 违反计数) 均可 O(1) 更新
+class PlanState {
+public:
+    PlanState(const AllValues& values, const AllLists& lists);
+
+    // 载入计划 (X 计划取自 lists.small_x，为空时视为不生产)
+    void Load(const vector<vector<int>>& y, const vector<vector<int>>& lambda);
+
+    // 增量评价 (不改变状态)
+    MoveDelta Evaluate(const PlanMove& move);
+
+    // 应用移动并压入撤销栈，非法移动返回 false
+    bool Apply(const PlanMove& move);
+
+    // 撤销最近一次移动
+    bool Undo();
+
+    // 清空撤销栈 (接受当前计划)
+    void Commit() { undo_stack_.clear(); }
+
+    // 全量重算并与增量状态比对，不一致时写入 report
+    bool CheckConsistency(string* report = nullptr) const;
+
+    // 全量评价 (与求解器末尾的统计口径一致)
+    PlanCost EvaluateFull() const;
+
+    const PlanCost& Cost() const { return cost_; }
+    double Objective() const { return cost_.Total(penalty_); }
+    bool IsFeasible() const {
+        return cost_.capacity_overflow < kEpsilon && cost_.uncovered == 0 &&
+               cost_.chain_violations == 0;
+    }
+
+    void SetPenalty(double penalty) { penalty_ = penalty; }
+    double Penalty() const { return penalty_; }
+
+    int Y(int g, int t) const { return y_[g][t]; }
+    int Lambda(int g, int t) const { return lambda_[g][t]; }
+    double Slack(int t) const { return capacity_ - setup_usage_[t] - prod_usage_[t]; }
+    int ActivePeriods(int g) const { return active_count_[g]; }
+    bool IsActive(int g, int t) const { return y_[g][t] || lambda_[g][t]; }
+
+    const vector<vector<int>>& YPlan() const { return y_; }
+    const vector<vector<int>>& LambdaPlan() const { return lambda_; }
+
+    int NumGroups() const { return G_; }
+    int NumPeriods() const { return T_; }
+
+private:
+    // 单元格变化: var 0=y 1=lambda
+    struct CellChange {
+        int var;
+        int g;
+        int t;
+        int old_value;
+        int new_value;
+    };
+
+    struct UndoRecord {
+        int count = 0;
+        CellChange cells[4];
+    };
+
+    // 将移动展开为单元格变化，非法返回 false
+    bool Expand(const PlanMove& move, UndoRecord& record) const;
+
+    // 设置单元格值并维护聚合量
+    void SetCell(int var, int g, int t, int value);
+
+    // 大类 g 在周期 t 上的约束实例贡献 (加入 sign=+1 / 移除 sign=-1)
+    void Account(int g, int t, int sign);
+
+    // 周期 t 的聚合违反数 / 产能超出量
+    int PeriodViolations(int t) const;
+    double PeriodOverflow(int t) const;
+
+    void ApplyRecord(const UndoRecord& record, bool forward);
+
+    const AllValues& values_;
+    const AllLists& lists_;
+    int G_ = 0;
+    int T_ = 0;
+    double capacity_ = 0.0;
+    double penalty_ = 0.0;
+
+    vector<vector<int>> y_;
+    vector<vector<int>> lambda_;
+    vector<vector<double>> family_usage_;  // [g][t] 大类生产占用 (随 X 计划固定)
+
+    vector<double> setup_usage_;  // [t]
+    vector<double> prod_usage_;   // [t]
+    vector<int> sum_y_;           // [t]
+    vector<int> sum_lambda_;      // [t]
+    vector<int> rule8_count_;     // [t] lambda_gt=1 但 t-1 无 setup/carryover 的大类数
+    vector<int> triple_count_;    // [t] y_gt=lambda_gt=lambda_{g,t-1}=1 的大类数
+    vector<int> uncovered_count_; // [t]
+    vector<int> active_count_;    // [g]
+
+    PlanCost cost_;
+    vector<UndoRecord> undo_stack_;
+};
+
+// 邻域移动评价基准结果
+struct PlanStateBenchmarkResult {
+    long moves = 0;             // 增量评价次数
+    long applied = 0;           // 接受的移动数
+    double seconds = 0.0;
+    double moves_per_second = 0.0;
+    double start_objective = 0.0;
+    double end_objective = 0.0;
+    bool consistent = true;     // 全量校验是否一致
+};
+
+// 以当前解 (lists.small_y/small_l/small_x) 为起点，随机邻域下降测量评价吞吐
+PlanStateBenchmarkResult BenchmarkPlanState(const AllValues& values,
+                                            const AllLists& lists,
+                                            long num_moves,
+                                            unsigned int seed = 1);
+
+#endif  // PLAN_STATE_H_
@@ -0,0 +1,111 @@
+// prescreen.cpp - 子问题可行性预筛实现
+
+#include "prescreen.h"
+#include "logger.h"
+#include <mutex>
+
+namespace {
+
+std::mutex g_prescreen_mutex;  // 保护 values.metrics 中的预筛统计
+
+// 在固定/自由取值下逐条检查必要条件，返回首个违反项
+PrescreenResult Check(const AllValues& values, const AllLists& lists,
+                      const vector<vector<int>>& y_fixed,
+                      const vector<vector<int>>& lambda_fixed,
+                      const vector<bool>& fixed) {
+    PrescreenResult result;
+    int G = values.number_of_groups;
+    int T = values.number_of_periods;
+
+    // 自由变量的取值区间为 [0,1]
+    auto y_min = [&](int g, int t) { return fixed[t] ? y_fixed[g][t] : 0; };
+    auto y_max = [&](int g, int t) { return fixed[t] ? y_fixed[g][t] : 1; };
+    auto l_min = [&](int g, int t) { return fixed[t] ? lambda_fixed[g][t] : 0; };
+    auto l_max = [&](int g, int t) { return fixed[t] ? lambda_fixed[g][t] : 1; };
+
+    for (int t = 0; t < T; t++) {
+        double setup_load = 0.0;
+        int lambda_count = 0;
+        int y_max_total = 0;
+        for (int g = 0; g < G; g++) {
+            setup_load += lists.usage_y[g] * y_min(g, t);
+            lambda_count += l_min(g, t);
+            y_max_total += y_max(g, t);
+        }
+
+        // 约束2: 产能 (x_it >= 0，只剩固定 setup 时间)
+        if (setup_load > values.machine_capacity) {
+            result.feasible = false;
+            result.reason = "周期 " + to_string(t) + ": 固定 setup 时间 " +
+                            to_string(static_cast<long>(setup_load)) + " > 产能 " +
+                            to_string(values.machine_capacity);
+            return result;
+        }
+
+        // 约束7: sum_g lambda_gt <= 1
+        if (lambda_count > 1) {
+            result.feasible = false;
+            result.reason = "周期 " + to_string(t) + ": 固定 carryover 数 " +
+                            to_string(lambda_count) + " > 1";
+            return result;
+        }
+
+        for (int g = 0; g < G; g++) {
+            // 约束10: lambda_g0 = 0
+            if (t == 0) {
+                if (l_min(g, 0) > 0) {
+                    result.feasible = false;
+                    result.reason = "大类 " + to_string(g) + ": 周期 0 固定了 carryover";
+                    return result;
+                }
+                continue;
+            }
+
+            // 约束8: lambda_gt <= y_{g,t-1} + lambda_{g,t-1}
+            if (l_min(g, t) > y_max(g, t - 1) + l_max(g, t - 1)) {
+                result.feasible = false;
+                result.reason = "大类 " + to_string(g) + " 周期 " + to_string(t) +
+                                ": carryover 前一周期既无 setup 也无 carryover";
+                return result;
+            }
+
+            // 约束9: lambda_gt + lambda_{g,t-1} + y_gt - sum_{g'!=g} y_g't <= 2
+            int others = y_max_total - y_max(g, t);
+            if (l_min(g, t) + l_min(g, t - 1) + y_min(g, t) - others > 2) {
+                result.feasible = false;
+                result.reason = "大类 " + to_string(g) + " 周期 " + to_string(t) +
+                                ": 连续 carryover 期间启动且无其他大类 setup (排他性)";
+                return result;
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+PrescreenResult PrescreenSubproblem(AllValues& values, const AllLists& lists,
+                                    const vector<vector<int>>& y_fixed,
+                                    const vector<vector<int>>& lambda_fixed,
+                                    const vector<bool>& fixed,
+                                    const char* tag) {
+    auto start = chrono::steady_clock::now();
+    PrescreenResult result = Check(values, lists, y_fixed, lambda_fixed, fixed);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(g_prescreen_mutex);
+        auto& m = values.metrics;
+        m.prescreen_checks++;
+        m.prescreen_time += elapsed;
+        if (!result.feasible) {
+            m.prescreen_rejects++;
+        }
+    }
+
+    if (!result.feasible) {
+        LOG_FMT("[警告] %s 预筛: 固定的 (y, lambda) 不一致，跳过求解 - %s\n",
+                tag, result.reason.c_str());
+    }
+    return result;
+}
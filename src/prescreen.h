@@ -0,0 +1,33 @@
+// prescreen.h - 子问题可行性预筛
+// 在调用 CPLEX 前用必要条件检查 RF/FO 子问题: 固定周期的 (y, lambda) 取已存值，
+// 其余周期的 y/lambda 视为 [0,1] 内任意取值，逐条检查与 (y, lambda) 相关的约束
+// 在最有利取值下能否满足:
+//   约束2   固定 setup 时间 sum_g s_g y_gt <= C
+//   约束7   每期最多一个 carryover
+//   约束8   carryover 链 lambda_gt <= y_{g,t-1} + lambda_{g,t-1}
+//   约束9   carryover 排他性
+//   约束10  lambda_g0 = 0
+// 其余约束在 x = 0、u = 1 时总能满足，子问题是否可行只取决于以上几条。
+// 固定值都来自先前可行的求解，正常运行时预筛不会拒绝，它是调试断言:
+// 拒绝说明上游固定了不一致的 (y, lambda)，此时跳过求解并写警告日志。通过时不写日志
+
+#ifndef PRESCREEN_H_
+#define PRESCREEN_H_
+
+#include "optimizer.h"
+
+// 预筛结论
+struct PrescreenResult {
+    bool feasible = true;    // false 表示子问题必然不可行
+    string reason;           // 首个违反项 (feasible 为 false 时)
+};
+
+// fixed[t] 为 true 的周期 y/lambda 取 y_fixed/lambda_fixed 的值，其余周期自由；
+// 结论以 tag 为前缀写入日志，并累计到 values.metrics (线程安全)
+PrescreenResult PrescreenSubproblem(AllValues& values, const AllLists& lists,
+                                    const vector<vector<int>>& y_fixed,
+                                    const vector<vector<int>>& lambda_fixed,
+                                    const vector<bool>& fixed,
+                                    const char* tag);
+
+#endif  // PRESCREEN_H_
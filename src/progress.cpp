@@ -0,0 +1,124 @@
+// progress.cpp - 求解进度流实现
+
+#include "progress.h"
+#include "logger.h"
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#define PROGRESS_WRITE _write
+#else
+#include <csignal>
+#include <unistd.h>
+#define PROGRESS_WRITE ::write
+#endif
+
+ProgressReporter g_progress;
+
+void ProgressReporter::Open(int fd, double interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+#ifndef _WIN32
+    // 读取端关闭后 write 返回 EPIPE 而不是以 SIGPIPE 终止进程
+    if (fd >= 0) std::signal(SIGPIPE, SIG_IGN);
+#endif
+    fd_ = fd;
+    interval_ = max(0.0, interval);
+    start_ = chrono::steady_clock::now();
+    last_emit_ = -1e9;
+}
+
+void ProgressReporter::SetPhase(const char* phase) {
+    if (!Enabled()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        phase_ = phase;
+        k_ = -1;
+        W_ = -1;
+        round_ = 0;
+    }
+    Emit("phase", true);
+}
+
+void ProgressReporter::SetWindow(int k, int W) {
+    if (!Enabled()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    k_ = k;
+    W_ = W;
+}
+
+void ProgressReporter::SetRound(int round) {
+    if (!Enabled()) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    round_ = round;
+}
+
+void ProgressReporter::Emit(const char* event, bool force) {
+    if (!Enabled()) return;
+    Write(event, false, -1.0, -1.0, 0, force);
+}
+
+void ProgressReporter::EmitSolver(const char* event, double incumbent, double bound,
+                                  long nodes, bool force) {
+    if (!Enabled()) return;
+    Write(event, true, incumbent, bound, nodes, force);
+}
+
+void ProgressReporter::Write(const char* event, bool has_solver, double incumbent,
+                             double bound, long nodes, bool force) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) return;   // 另一线程已因 EPIPE 关闭
+    double t = chrono::duration<double>(chrono::steady_clock::now() - start_).count();
+    // 强制事件不占用限频窗口
+    if (!force) {
+        if (t - last_emit_ < interval_) {
+            return;
+        }
+        last_emit_ = t;
+    }
+
+    char line[512];
+    int len = snprintf(line, sizeof(line),
+                       "{\"event\":\"%s\",\"t\":%.3f,\"phase\":\"%s\",\"k\":%d,\"W\":%d,\"round\":%d",
+                       event, t, phase_.c_str(), k_, W_, round_);
+    if (has_solver && len > 0 && len < static_cast<int>(sizeof(line))) {
+        double gap = (incumbent > 1e-10 && bound >= 0)
+                   ? max(0.0, (incumbent - bound) / incumbent) : -1.0;
+        len += snprintf(line + len, sizeof(line) - len,
+                        ",\"incumbent\":%.2f,\"bound\":%.2f,\"gap\":%.4f,\"nodes\":%ld",
+                        incumbent, bound, gap, nodes);
+    }
+    if (len <= 0 || len >= static_cast<int>(sizeof(line)) - 2) {
+        return;
+    }
+    line[len++] = '}';
+    line[len++] = '\n';
+    // 写入失败时放弃本条，不影响求解；读取端已关闭则停止后续输出
+    if (PROGRESS_WRITE(fd_, line, len) < 0 && errno == EPIPE) {
+        fd_ = -1;
+        LOG("[进度] 读取端已关闭，停止输出进度");
+    }
+}
+
+void ProgressCallback::invoke(const IloCplex::Callback::Context& context) {
+    if (!context.inGlobalProgress()) {
+        if (inner_ != nullptr) inner_->invoke(context);
+        return;
+    }
+    using Info = IloCplex::Callback::Context::Info;
+    bool feasible = context.getIntInfo(Info::Feasible) != 0;
+    double incumbent = feasible ? context.getIncumbentObjective() : -1.0;
+    double bound = context.getDoubleInfo(Info::BestBound);
+    long nodes = static_cast<long>(context.getLongInfo(Info::NodeCount));
+    g_progress.EmitSolver("progress", incumbent, bound, nodes);
+}
+
+std::unique_ptr<ProgressCallback> AttachProgress(IloCplex& cplex,
+                                                 IloCplex::Callback::Function* inner,
+                                                 CPXLONG inner_contexts) {
+    if (!g_progress.Enabled()) {
+        return nullptr;
+    }
+    auto callback = std::make_unique<ProgressCallback>(inner, inner != nullptr ? inner_contexts : 0);
+    cplex.use(callback.get(), callback->Contexts());
+    return callback;
+}
@@ -0,0 +1,79 @@
+// progress.h - 求解进度流
+// --progress-fd <fd> 打开后，求解过程以单行紧凑 JSON 写入该文件描述符 (与日志、EmitStatus 分开):
+//   {"event":"progress","t":12.345,"phase":"RF","k":3,"W":6,"round":0,
+//    "incumbent":1234.50,"bound":1100.00,"gap":0.1087,"nodes":420}
+// event 取值:
+//   phase    阶段切换 (总是输出)
+//   window   RF 窗口 / FO 窗口开始 (限频)
+//   improve  FO 窗口改进 (总是输出)
+//   progress CPLEX GlobalProgress 回调 (限频)，incumbent/bound/gap/nodes 为当前子问题的值
+// incumbent/bound 为 -1 表示尚无 (improve 事件只有 incumbent)，此时 gap 为 -1
+// 限频间隔由 --progress-interval 设置；未打开时各接口不做任何事
+
+#ifndef PROGRESS_H_
+#define PROGRESS_H_
+
+#include "optimizer.h"
+#include <atomic>
+#include <mutex>
+
+class ProgressReporter {
+public:
+    // fd < 0 表示关闭；打开时忽略 SIGPIPE，读取端关闭 (EPIPE) 后自动关闭进度流
+    void Open(int fd, double interval);
+    bool Enabled() const { return fd_ >= 0; }
+
+    // 循环状态 (写入之后的每条事件)
+    void SetPhase(const char* phase);
+    void SetWindow(int k, int W);
+    void SetRound(int round);
+
+    // 不含求解器数据的事件；force 为 true 时不受限频
+    void Emit(const char* event, bool force = false);
+
+    // 带求解器数据的事件 (incumbent < 0 表示尚无可行解)
+    void EmitSolver(const char* event, double incumbent, double bound, long nodes,
+                    bool force = false);
+
+private:
+    void Write(const char* event, bool has_solver, double incumbent, double bound,
+               long nodes, bool force);
+
+    std::atomic<int> fd_{-1};
+    double interval_ = 0.5;
+    chrono::steady_clock::time_point start_ = chrono::steady_clock::now();
+    double last_emit_ = -1e9;
+
+    std::mutex mutex_;
+    string phase_ = "INIT";
+    int k_ = -1;
+    int W_ = -1;
+    int round_ = 0;
+};
+
+extern ProgressReporter g_progress;
+
+// CPLEX 进度回调: GlobalProgress 上下文上报进度，其余上下文转发给 inner (割回调等)
+class ProgressCallback : public IloCplex::Callback::Function {
+public:
+    ProgressCallback(IloCplex::Callback::Function* inner, CPXLONG inner_contexts)
+        : inner_(inner), inner_contexts_(inner_contexts) {}
+
+    void invoke(const IloCplex::Callback::Context& context) override;
+
+    CPXLONG Contexts() const {
+        return inner_contexts_ | IloCplex::Callback::Context::Id::GlobalProgress;
+    }
+
+private:
+    IloCplex::Callback::Function* inner_;
+    CPXLONG inner_contexts_;
+};
+
+// 进度流打开时挂载进度回调并替换 cplex 上已有的 inner 回调；关闭时返回空指针、不改动 cplex。
+// inner 为空时 inner_contexts 被忽略。返回的回调须在 cplex.solve() 结束前保持存活
+std::unique_ptr<ProgressCallback> AttachProgress(IloCplex& cplex,
+                                                 IloCplex::Callback::Function* inner,
+                                                 CPXLONG inner_contexts);
+
+#endif  // PROGRESS_H_
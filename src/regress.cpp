@@ -0,0 +1,331 @@
+// regress.cpp - 端到端性能回归套件实现
+
+#include "regress.h"
+#include "child_solve.h"
+#include "config_file.h"
+#include "logger.h"
+#include "interrupt.h"
+#include <filesystem>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct RegressSuite {
+    vector<string> algorithms = {"RF", "RFO", "RR"};
+    double time_limit = 60.0;
+    int cplex_threads = 2;
+    string options;
+    fs::path baseline;
+    double tolerance_objective = 0.0;
+    double tolerance_time = 0.30;
+    double tolerance_nodes = 0.50;
+    double min_time = 2.0;
+    long min_nodes = 200;
+};
+
+struct RegressInstance {
+    string name;
+    string path;
+    string instance_class;
+};
+
+// 基线中的一个用例 (-1 表示缺项)
+struct RegressBaseline {
+    double objective_min = -1.0;
+    double objective_max = -1.0;
+    double time = -1.0;
+    long nodes = -1;
+};
+
+struct RegressCase {
+    const RegressInstance* instance = nullptr;
+    string algorithm;
+    ChildSolveResult result;
+    RegressBaseline baseline;
+    bool has_baseline = false;
+    vector<string> flags;       // 判定项，空为 ok
+    bool regression = false;
+};
+
+string CaseKey(const string& instance, const string& algorithm) {
+    return instance + "/" + algorithm;
+}
+
+double NumberOr(const ConfigSection& section, const string& key, double fallback) {
+    const string* value = section.Find(key);
+    return value != nullptr ? atof(value->c_str()) : fallback;
+}
+
+bool ReadSuite(const string& path, RegressSuite& suite, vector<RegressInstance>& instances) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) {
+        return false;
+    }
+    fs::path base = fs::path(path).parent_path();
+    suite.baseline = base / "baseline.ini";
+
+    for (const auto& section : sections) {
+        if (section.name == "suite") {
+            if (const string* value = section.Find("algorithms")) {
+                SplitString(*value, suite.algorithms, ",");
+            }
+            if (const string* value = section.Find("options")) suite.options = *value;
+            if (const string* value = section.Find("baseline")) suite.baseline = base / *value;
+            suite.time_limit = NumberOr(section, "time_limit", suite.time_limit);
+            suite.cplex_threads = static_cast<int>(NumberOr(section, "cplex_threads", suite.cplex_threads));
+            suite.tolerance_objective = NumberOr(section, "tolerance_objective", suite.tolerance_objective);
+            suite.tolerance_time = NumberOr(section, "tolerance_time", suite.tolerance_time);
+            suite.tolerance_nodes = NumberOr(section, "tolerance_nodes", suite.tolerance_nodes);
+            suite.min_time = NumberOr(section, "min_time", suite.min_time);
+            suite.min_nodes = static_cast<long>(NumberOr(section, "min_nodes", suite.min_nodes));
+        } else if (!section.name.empty()) {
+            const string* file = section.Find("file");
+            if (file == nullptr) {
+                cerr << "[回归] 实例 [" << section.name << "] 缺少 file\n";
+                return false;
+            }
+            RegressInstance instance;
+            instance.name = section.name;
+            fs::path file_path(*file);
+            instance.path = (file_path.is_relative() ? base / file_path : file_path).string();
+            const string* instance_class = section.Find("class");
+            instance.instance_class = instance_class != nullptr ? *instance_class : "default";
+            instances.push_back(instance);
+        }
+    }
+    return !instances.empty();
+}
+
+map<string, RegressBaseline> ReadBaseline(const vector<ConfigSection>& sections) {
+    map<string, RegressBaseline> baselines;
+    for (const auto& section : sections) {
+        if (section.name.empty()) continue;
+        RegressBaseline b;
+        b.objective_min = NumberOr(section, "objective_min", -1.0);
+        b.objective_max = NumberOr(section, "objective_max", -1.0);
+        b.time = NumberOr(section, "time", -1.0);
+        b.nodes = static_cast<long>(NumberOr(section, "nodes", -1.0));
+        baselines[section.name] = b;
+    }
+    return baselines;
+}
+
+// 本次结果写入基线；未运行的用例保持原值与原顺序
+bool WriteBaseline(const fs::path& path, vector<ConfigSection> sections,
+                   const vector<RegressCase>& cases) {
+    for (const auto& c : cases) {
+        if (c.result.objective < 0) continue;
+        string key = CaseKey(c.instance->name, c.algorithm);
+        ConfigSection updated;
+        updated.name = key;
+        ostringstream obj, time;
+        obj << fixed << setprecision(2) << c.result.objective;
+        time << fixed << setprecision(2) << c.result.time;
+        updated.entries = {{"objective_min", obj.str()}, {"objective_max", obj.str()},
+                           {"time", time.str()}, {"nodes", to_string(max(c.result.nodes, 0L))}};
+        auto it = std::find_if(sections.begin(), sections.end(),
+                               [&](const ConfigSection& s) { return s.name == key; });
+        if (it != sections.end()) {
+            *it = updated;
+        } else {
+            sections.push_back(updated);
+        }
+    }
+
+    ofstream fout(path);
+    if (!fout) {
+        LOG_FMT("[错误] 无法写入基线: %s\n", path.string().c_str());
+        return false;
+    }
+    fout << "; LS-NTGF-All --regress-record 生成 (参考机器上记录)\n"
+         << "; objective_min/objective_max 可手工放宽，time 为子进程墙钟秒数\n";
+    for (const auto& section : sections) {
+        if (section.name.empty()) continue;
+        fout << "\n[" << section.name << "]\n";
+        for (const auto& [key, value] : section.entries) {
+            fout << key << " = " << value << "\n";
+        }
+    }
+    return static_cast<bool>(fout);
+}
+
+void Judge(const RegressSuite& suite, bool strict, RegressCase& c) {
+    const auto& r = c.result;
+    const auto& b = c.baseline;
+    auto flag = [&](const string& name, bool regression) {
+        c.flags.push_back(name);
+        c.regression = c.regression || regression;
+    };
+
+    if (r.objective < 0) {
+        flag("failed", true);
+        return;
+    }
+    if (!c.has_baseline) {
+        flag("new", strict);
+        return;
+    }
+    if (b.objective_max >= 0 && r.objective > b.objective_max * (1.0 + suite.tolerance_objective) + kEpsilon) {
+        flag("worse", true);
+    }
+    if (b.time >= 0 && r.time > max(b.time, suite.min_time) * (1.0 + suite.tolerance_time)) {
+        flag("slower", true);
+    }
+    if (b.nodes >= 0 && r.nodes > max(b.nodes, suite.min_nodes) * (1.0 + suite.tolerance_nodes)) {
+        flag("nodes", true);
+    }
+    bool better_objective = b.objective_min >= 0 && r.objective < b.objective_min - kEpsilon;
+    bool faster = b.time > suite.min_time && r.time < b.time / (1.0 + suite.tolerance_time);
+    if (!c.regression && (better_objective || faster)) {
+        flag("improved", false);
+    }
+}
+
+string FlagText(const RegressCase& c) {
+    if (c.flags.empty()) return "ok";
+    string text;
+    for (const auto& f : c.flags) text += (text.empty() ? "" : "+") + f;
+    return text;
+}
+
+void WriteReport(const fs::path& path, const vector<RegressCase>& cases) {
+    ofstream fout(path);
+    fout << "instance,class,algorithm,status,objective,objective_min,objective_max,root_bound,"
+         << "time,base_time,nodes,base_nodes,result\n";
+    fout << fixed << setprecision(2);
+    for (const auto& c : cases) {
+        fout << c.instance->name << "," << c.instance->instance_class << "," << c.algorithm << ","
+             << c.result.status << "," << c.result.objective << ","
+             << c.baseline.objective_min << "," << c.baseline.objective_max << ","
+             << c.result.root_bound << ","
+             << c.result.time << "," << c.baseline.time << ","
+             << c.result.nodes << "," << c.baseline.nodes << "," << FlagText(c) << "\n";
+    }
+}
+
+// 缺项 (负值) 显示为 "-"
+string Cell(double value, int precision) {
+    if (value < 0) return "-";
+    ostringstream ss;
+    ss << fixed << setprecision(precision) << value;
+    return ss.str();
+}
+
+void PrintTable(const vector<RegressCase>& cases) {
+    ostringstream out;
+    out << "\n" << left << setw(16) << "instance" << setw(5) << "algo" << right
+        << setw(14) << "objective" << setw(14) << "obj_max"
+        << setw(9) << "time" << setw(9) << "base"
+        << setw(10) << "nodes" << setw(10) << "base" << "  result\n"
+        << string(96, '-') << "\n";
+    for (const auto& c : cases) {
+        out << left << setw(16) << c.instance->name << setw(5) << c.algorithm << right
+            << setw(14) << Cell(c.result.objective, 2) << setw(14) << Cell(c.baseline.objective_max, 2)
+            << setw(9) << Cell(c.result.time, 1) << setw(9) << Cell(c.baseline.time, 1)
+            << setw(10) << Cell(static_cast<double>(c.result.nodes), 0)
+            << setw(10) << Cell(static_cast<double>(c.baseline.nodes), 0)
+            << "  " << FlagText(c) << "\n";
+    }
+    LOG(out.str());
+}
+
+}  // namespace
+
+int RunRegression(const CommandLineArgs& args, const string& program) {
+    RegressSuite suite;
+    vector<RegressInstance> instances;
+    if (!ReadSuite(args.regress, suite, instances)) {
+        LOG_FMT("[错误] 无法读取回归套件: %s\n", args.regress.c_str());
+        return 1;
+    }
+
+    // --regress-algo 只运行列出的算法
+    vector<string> algorithms = suite.algorithms;
+    if (!args.regress_algo.empty()) {
+        vector<string> wanted;
+        SplitString(args.regress_algo, wanted, ",");
+        std::erase_if(algorithms, [&](const string& a) {
+            return std::find(wanted.begin(), wanted.end(), a) == wanted.end();
+        });
+        if (algorithms.empty()) {
+            LOG_FMT("[错误] 套件中没有算法 %s\n", args.regress_algo.c_str());
+            return 1;
+        }
+    }
+
+    vector<ConfigSection> baseline_sections;
+    std::error_code ec;
+    if (fs::exists(suite.baseline, ec) && !ReadConfigFile(suite.baseline.string(), baseline_sections)) {
+        LOG_FMT("[错误] 无法读取基线: %s\n", suite.baseline.string().c_str());
+        return 1;
+    }
+    map<string, RegressBaseline> baselines = ReadBaseline(baseline_sections);
+    if (baselines.empty() && !args.regress_record) {
+        LOG_FMT("[回归] 基线 %s 为空，%s (用 --regress-record 记录)\n",
+                suite.baseline.string().c_str(),
+                args.regress_strict ? "全部用例视为回归" : "只检查可行性");
+    }
+
+    fs::path root = fs::path(args.output_dir) / ("regress_" + GetCurrentTimestamp());
+    fs::create_directories(root, ec);
+    if (ec) {
+        LOG_FMT("[错误] 无法创建回归目录: %s\n", root.string().c_str());
+        return 1;
+    }
+
+    string self = ResolveProgram(program);
+    LOG_FMT("[回归] 实例 %zu 个 x 算法 %zu 个，时间限制 %.1fs，CPLEX 线程 %d\n",
+            instances.size(), algorithms.size(), suite.time_limit, suite.cplex_threads);
+
+    vector<RegressCase> cases;
+    for (const auto& instance : instances) {
+        for (const auto& algorithm : algorithms) {
+            if (g_interrupt.Requested()) break;
+            RegressCase c;
+            c.instance = &instance;
+            c.algorithm = algorithm;
+            auto it = baselines.find(CaseKey(instance.name, algorithm));
+            if (it != baselines.end()) {
+                c.baseline = it->second;
+                c.has_baseline = true;
+            }
+
+            fs::path run_dir = root / (instance.name + "_" + algorithm);
+            fs::create_directories(run_dir, ec);
+            ostringstream options;
+            options << "--algo=" << algorithm << " -t " << suite.time_limit
+                    << " --cplex-threads " << suite.cplex_threads;
+            if (!suite.options.empty()) options << " " << suite.options;
+            if (!args.regress_options.empty()) options << " " << args.regress_options;
+            c.result = RunChildSolve(ChildSolveCommand(self, SplitOptions(options.str()), run_dir,
+                                                       instance.path), run_dir);
+            Judge(suite, args.regress_strict && !args.regress_record, c);
+
+            LOG_FMT("[回归] %s %s: %s 目标=%.2f 时间=%.1fs 节点=%ld -> %s\n",
+                    instance.name.c_str(), algorithm.c_str(), c.result.status.c_str(),
+                    c.result.objective, c.result.time, c.result.nodes, FlagText(c).c_str());
+            cases.push_back(c);
+        }
+    }
+
+    WriteReport(root / "report.csv", cases);
+    PrintTable(cases);
+
+    int regressions = 0;
+    for (const auto& c : cases) {
+        if (c.regression) regressions++;
+    }
+    LOG_FMT("[回归] 用例 %zu 个，回归 %d 个，报告: %s\n",
+            cases.size(), regressions, (root / "report.csv").string().c_str());
+
+    if (args.regress_record) {
+        if (!WriteBaseline(suite.baseline, baseline_sections, cases)) {
+            return 1;
+        }
+        LOG_FMT("[回归] 基线已写入: %s\n", suite.baseline.string().c_str());
+        return 0;
+    }
+    return regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,33 @@
+// regress.h - 端到端性能回归套件
+// --regress <suite.ini> 对固定实例集逐个启动本程序的子进程求解 (顺序执行，计时不受并行干扰)，
+// 与仓库中保存的基线比较目标值、墙钟时间与 CPLEX 节点数。
+//
+// 套件文件 (INI，见 regress/suite.ini):
+//   [suite]    algorithms (逗号分隔)、time_limit、cplex_threads、options (附加命令行参数，按空白切分)、
+//              baseline (基线文件，相对套件文件所在目录)、容差 tolerance_objective/time/nodes
+//              与下限 min_time/min_nodes (基线低于下限时按下限比较，避免极短用例的抖动误报)
+//   [<实例名>] file (相对套件文件所在目录)、class (实例类别，仅用于报告)
+//
+// 基线文件每个用例一节 [<实例名>/<算法>]: objective_min、objective_max、time (秒)、nodes。
+// --regress-record 以本次结果写入基线 (目标范围取本次目标值，可手工放宽)，其余用例的基线保留。
+//
+// 判定 (可同时出现多项):
+//   failed   无可行解或子进程失败
+//   worse    目标 > objective_max * (1 + tolerance_objective)
+//   slower   时间 > max(基线, min_time) * (1 + tolerance_time)
+//   nodes    节点 > max(基线, min_nodes) * (1 + tolerance_nodes)
+//   improved 目标低于 objective_min 或时间低于基线 / (1 + tolerance_time)，提示更新基线
+//   new      基线中没有该用例 (--regress-strict 时视为回归，CTest 目标据此在基线未记录时失败)
+// --regress-options 在套件 options 之后追加子进程参数 (如 "--big-m cap" 对比建模选项)，
+// report.csv 同时列出子进程的 root_bound (需 --root-bound lp|root)。
+// 报告写入 <输出目录>/regress_<时间>/report.csv 并输出对照表；有 failed/worse/slower/nodes 时退出码为 2
+
+#ifndef REGRESS_H_
+#define REGRESS_H_
+
+#include "solve_driver.h"
+
+// 执行回归套件，program 为本程序路径 (启动子进程)；返回进程退出码
+int RunRegression(const CommandLineArgs& args, const string& program);
+
+#endif  // REGRESS_H_
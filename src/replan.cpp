@@ -0,0 +1,518 @@
+// replan.cpp - 滚动重排程实现
+//
+// 增量应用在合并前的订单上；暖启动只映射 (y, lambda)，生产量由 FO 收尾 LP 重新确定。
+// 移出计划期的周期 [0, shift) 视为已执行，其生产量从保留订单的需求中扣除。
+// 冻结周期固定 setup 决策，生产量仍可在 LP 中调整
+
+#include "replan.h"
+#include "logger.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// 读取上次结果
+// ============================================================================
+
+// 读取 variables.<name>.data 二维数组
+static bool ReadResultMatrix(const string& text, const string& name,
+                             vector<vector<double>>& rows) {
+    size_t pos = text.find("\"variables\"");
+    if (pos == string::npos) return false;
+    pos = text.find("\"" + name + "\"", pos);
+    if (pos == string::npos) return false;
+    pos = text.find("\"data\"", pos);
+    if (pos == string::npos) return false;
+    pos = text.find('[', pos);
+    if (pos == string::npos) return false;
+
+    rows.clear();
+    int depth = 0;
+    const char* base = text.c_str();
+    for (size_t i = pos; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '[') {
+            depth++;
+            if (depth == 2) rows.emplace_back();
+        } else if (c == ']') {
+            depth--;
+            if (depth == 0) return true;
+        } else if (depth == 2 && (isdigit(static_cast<unsigned char>(c)) || c == '-' || c == '.')) {
+            char* end = nullptr;
+            rows.back().push_back(strtod(base + i, &end));
+            i = static_cast<size_t>(end - base) - 1;
+        }
+    }
+    return false;
+}
+
+bool ReadPreviousPlan(const string& path, PreviousPlan& plan) {
+    ifstream fin(path);
+    if (!fin) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << fin.rdbuf();
+    string text = buffer.str();
+
+    vector<vector<double>> y, lambda;
+    if (!ReadResultMatrix(text, "Y", y) || !ReadResultMatrix(text, "L", lambda) ||
+        !ReadResultMatrix(text, "X", plan.x) || !ReadResultMatrix(text, "B", plan.b)) {
+        return false;
+    }
+
+    auto to_binary = [](const vector<vector<double>>& rows) {
+        vector<vector<int>> out(rows.size());
+        for (size_t r = 0; r < rows.size(); r++) {
+            for (double v : rows[r]) out[r].push_back(v > 0.5 ? 1 : 0);
+        }
+        return out;
+    };
+    plan.y = to_binary(y);
+    plan.lambda = to_binary(lambda);
+    return true;
+}
+
+// ============================================================================
+// 读取增量
+// ============================================================================
+bool ReadReplanDelta(const string& path, ReplanDelta& delta) {
+    ifstream fin(path);
+    if (!fin) {
+        return false;
+    }
+
+    string line;
+    vector<string> tokens;
+    vector<double> numbers;
+    while (getline(fin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        SplitString(line, tokens, ",");
+        const string& label = tokens[0];
+        try {
+            if (label == "shift" && tokens.size() > 1) {
+                delta.shift = stoi(tokens[1]);
+            } else if (label == "frozen" && tokens.size() > 1) {
+                delta.frozen = max(0, stoi(tokens[1]));
+            } else if (label == "horizon" && tokens.size() > 1) {
+                delta.horizon = stoi(tokens[1]);
+            } else if (label == "remove") {
+                ParseCommaSeparatedValues(line, numbers, 0);
+                for (double k : numbers) delta.removed.push_back(static_cast<int>(k) - 1);
+            } else if (label.rfind("demand_f", 0) == 0) {
+                int f = stoi(label.substr(8)) - 1;
+                if (f < 0) continue;
+                if (static_cast<int>(delta.tail_demand.size()) <= f) delta.tail_demand.resize(f + 1);
+                ParseCommaSeparatedValues(line, numbers, 0);
+                for (double v : numbers) delta.tail_demand[f].push_back(static_cast<int>(v));
+            } else if (label.rfind("order_", 0) == 0) {
+                delta.added_orders.push_back(line);
+            } else {
+                LOG_FMT("[重排程] 忽略增量行: %s\n", line.c_str());
+            }
+        } catch (const exception&) {
+            LOG_FMT("[重排程] 增量行格式无效: %s\n", line.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// 应用增量
+// ============================================================================
+
+// 追加一个订单 (列同输入 CSV)，失败时返回 false
+static bool AppendOrder(const vector<string>& cols, int T, int F, int G,
+                        const AllValues& values, AllLists& lists) {
+    if (cols.size() < 9) return false;
+    int g = stoi(cols[2]) - 1;
+    int f = stoi(cols[3]) - 1;
+    int ew = stoi(cols[5]);
+    int lw = stoi(cols[6]);
+    if (f < 0 || f >= F || g < 0 || g >= G || ew < 0 || lw >= T || ew > lw) {
+        return false;
+    }
+
+    vector<int> flow_row(F, 0), group_row(G, 0);
+    flow_row[f] = 1;
+    group_row[g] = 1;
+    lists.flow_flag.push_back(flow_row);
+    lists.group_flag.push_back(group_row);
+    lists.final_demand.push_back(static_cast<int>(stod(cols[4])));
+    lists.ew_x.push_back(ew);
+    lists.lw_x.push_back(lw);
+    lists.usage_x.push_back(stoi(cols[7]));
+    lists.cost_x.push_back(stod(cols[8]));
+    lists.cost_b.push_back(values.b_penalty);
+    lists.cost_u.push_back(values.u_penalty);
+    return true;
+}
+
+// 行数为 rows、每行 cols 列
+template <typename V>
+static bool HasShape(const vector<vector<V>>& m, size_t rows, size_t cols) {
+    if (m.size() != rows) return false;
+    for (const auto& row : m) {
+        if (row.size() != cols) return false;
+    }
+    return true;
+}
+
+// 旧周期 [0, shift) 内各原订单已执行的生产量。上次结果的 X 行数等于订单数时按行对应；
+// 等于流向-分组组合数时为合并后的结果，按 UpdateBigOrderFG 的键序还原到组内订单，交期早的先分。
+// 两者都不符时返回 false
+static bool ExecutedProduction(const PreviousPlan& prev, int shift, const AllValues& values,
+                               const AllLists& lists, vector<int>& executed) {
+    int N = values.number_of_items;
+    executed.assign(N, 0);
+    auto row_sum = [&](size_t r) {
+        double sum = 0.0;
+        for (int t = 0; t < shift; t++) sum += prev.x[r][t];
+        return static_cast<int>(lround(sum));
+    };
+
+    if (static_cast<int>(prev.x.size()) == N) {
+        for (int i = 0; i < N; i++) executed[i] = row_sum(i);
+        return true;
+    }
+
+    map<pair<int, int>, vector<int>> fg_groups;
+    for (int i = 0; i < N; i++) {
+        auto f = find(lists.flow_flag[i].begin(), lists.flow_flag[i].end(), 1);
+        auto g = find(lists.group_flag[i].begin(), lists.group_flag[i].end(), 1);
+        if (f == lists.flow_flag[i].end() || g == lists.group_flag[i].end()) continue;
+        fg_groups[{static_cast<int>(f - lists.flow_flag[i].begin()),
+                   static_cast<int>(g - lists.group_flag[i].begin())}].push_back(i);
+    }
+    if (fg_groups.size() != prev.x.size()) {
+        return false;
+    }
+
+    size_t r = 0;
+    for (auto& group : fg_groups) {
+        vector<int>& orders = group.second;
+        stable_sort(orders.begin(), orders.end(),
+                    [&](int a, int b) { return lists.lw_x[a] < lists.lw_x[b]; });
+        int remaining = row_sum(r++);
+        for (int i : orders) {
+            int take = min(remaining, lists.final_demand[i]);
+            executed[i] = take;
+            remaining -= take;
+        }
+    }
+    return true;
+}
+
+bool PrepareReplan(const CommandLineArgs& args, AllValues& values, AllLists& lists,
+                   ReplanContext& context) {
+    LOG("\n[重排程] 准备滚动重排程");
+
+    if (!ReadPreviousPlan(args.replan, context.previous)) {
+        LOG_FMT("[错误] 无法读取上次结果: %s\n", args.replan.c_str());
+        return false;
+    }
+    ReplanDelta& delta = context.delta;
+    if (!args.replan_delta.empty() && !ReadReplanDelta(args.replan_delta, delta)) {
+        LOG_FMT("[错误] 无法读取增量文件: %s\n", args.replan_delta.c_str());
+        return false;
+    }
+    if (args.replan_frozen >= 0) {
+        delta.frozen = args.replan_frozen;
+    }
+
+    int N_old = values.number_of_items;
+    int T_old = values.number_of_periods;
+    int F = values.number_of_flows;
+    int G = values.number_of_groups;
+    const PreviousPlan& prev = context.previous;
+
+    if (!HasShape(prev.y, G, T_old) || !HasShape(prev.lambda, G, T_old)) {
+        LOG_FMT("[错误] 上次结果 Y/L 维度 (G=%zu T=%zu) 与算例 (G=%d T=%d) 不一致\n",
+                prev.y.size(), prev.y.empty() ? size_t(0) : prev.y[0].size(), G, T_old);
+        return false;
+    }
+    if (!HasShape(prev.x, prev.x.size(), T_old) || !HasShape(prev.b, prev.x.size(), T_old) ||
+        prev.x.empty() || static_cast<int>(prev.x.size()) > N_old) {
+        LOG_FMT("[错误] 上次结果 X/B 维度 (%zu/%zu 行) 与算例 (N=%d T=%d) 不一致\n",
+                prev.x.size(), prev.b.size(), N_old, T_old);
+        return false;
+    }
+    if (delta.shift < 0 || delta.shift >= T_old) {
+        LOG_FMT("[错误] 前移周期数 %d 超出计划期 %d\n", delta.shift, T_old);
+        return false;
+    }
+
+    int shift = delta.shift;
+    int T_new = delta.horizon > 0 ? delta.horizon : T_old;
+    int overlap = max(0, min(T_new, T_old - shift));
+    context.overlap = overlap;
+
+    vector<bool> active(T_new, false);
+    auto mark = [&](int from, int to) {
+        for (int t = max(0, from); t <= min(T_new - 1, to); t++) active[t] = true;
+    };
+    for (int t = overlap; t < T_new; t++) active[t] = true;  // 新增尾部周期
+
+    // 周期数据平移，尾部取增量或重复最后一期
+    AllLists next;
+    next.cost_y = lists.cost_y;
+    next.cost_i = lists.cost_i;
+    next.usage_y = lists.usage_y;
+    next.period_demand.assign(F, vector<int>(T_new, 0));
+    for (int f = 0; f < F; f++) {
+        for (int t = 0; t < T_new; t++) {
+            int old_t = t + shift;
+            if (old_t < T_old) {
+                next.period_demand[f][t] = lists.period_demand[f][old_t];
+            } else if (f < static_cast<int>(delta.tail_demand.size()) &&
+                       t - overlap < static_cast<int>(delta.tail_demand[f].size())) {
+                next.period_demand[f][t] = delta.tail_demand[f][t - overlap];
+            } else {
+                next.period_demand[f][t] = lists.period_demand[f][T_old - 1];
+            }
+        }
+    }
+
+    // 保留的旧订单: 时间窗平移，移出计划期的丢弃
+    vector<bool> removed(N_old, false);
+    for (int k : delta.removed) {
+        if (k < 0 || k >= N_old) {
+            LOG_FMT("[重排程] 忽略不存在的订单 order_%d\n", k + 1);
+            continue;
+        }
+        removed[k] = true;
+    }
+
+    vector<int> executed;
+    if (!ExecutedProduction(prev, shift, values, lists, executed)) {
+        LOG_FMT("[重排程] 上次结果 X 的 %zu 行无法对应到 %d 个订单，不扣除已执行的生产量\n",
+                prev.x.size(), N_old);
+    }
+
+    int orders_removed = 0;
+    int orders_expired = 0;
+    int orders_completed = 0;
+    for (int i = 0; i < N_old; i++) {
+        int ew = lists.ew_x[i] - shift;
+        int lw = lists.lw_x[i] - shift;
+        if (removed[i]) {
+            orders_removed++;
+            mark(ew, lw);
+            continue;
+        }
+        if (lw < 0) {
+            orders_expired++;
+            continue;
+        }
+        int demand = lists.final_demand[i] - executed[i];
+        if (demand <= 0) {
+            orders_completed++;
+            continue;
+        }
+        if (lw >= T_new) {
+            // 计划期缩短: 交期截到最后一期，该订单的时间窗视为受影响
+            lw = T_new - 1;
+            mark(ew, lw);
+        }
+        ew = min(max(0, ew), lw);
+
+        next.flow_flag.push_back(lists.flow_flag[i]);
+        next.group_flag.push_back(lists.group_flag[i]);
+        next.final_demand.push_back(demand);
+        next.ew_x.push_back(ew);
+        next.lw_x.push_back(lw);
+        next.usage_x.push_back(lists.usage_x[i]);
+        next.cost_x.push_back(lists.cost_x[i]);
+        next.cost_b.push_back(lists.cost_b[i]);
+        next.cost_u.push_back(lists.cost_u[i]);
+    }
+
+    int orders_added = 0;
+    vector<string> cols;
+    for (const string& line : delta.added_orders) {
+        SplitString(line, cols, ",");
+        bool ok = false;
+        try {
+            ok = AppendOrder(cols, T_new, F, G, values, next);
+        } catch (const exception&) {
+            ok = false;
+        }
+        if (!ok) {
+            LOG_FMT("[重排程] 新增订单无效，已忽略: %s\n", line.c_str());
+            continue;
+        }
+        mark(next.ew_x.back(), next.lw_x.back());
+        orders_added++;
+    }
+
+    if (next.final_demand.empty()) {
+        LOG("[错误] 重排程后没有订单");
+        return false;
+    }
+
+    values.number_of_periods = T_new;
+    values.number_of_items = static_cast<int>(next.final_demand.size());
+    values.original_number_of_items = values.number_of_items;
+    lists = std::move(next);
+
+    // 旧计划平移为暖启动；约束10 要求 lambda_g0 = 0，跨入首期的 carryover 改为 setup
+    ReplanWarmStart& warm = context.warm;
+    warm.y.assign(G, vector<int>(T_new, 0));
+    warm.lambda.assign(G, vector<int>(T_new, 0));
+    int converted = 0;
+    for (int g = 0; g < G; g++) {
+        for (int t = 0; t < overlap; t++) {
+            warm.y[g][t] = prev.y[g][t + shift];
+            warm.lambda[g][t] = prev.lambda[g][t + shift];
+        }
+        if (warm.lambda[g][0] == 1) {
+            warm.lambda[g][0] = 0;
+            warm.y[g][0] = 1;
+            converted++;
+        }
+    }
+
+    warm.frozen = min(delta.frozen, overlap);
+    if (warm.frozen < delta.frozen) {
+        LOG_FMT("[重排程] 冻结周期数 %d 超过有旧计划的周期数，截为 %d\n", delta.frozen, warm.frozen);
+    }
+    for (int t = 0; t < warm.frozen; t++) active[t] = false;
+    warm.active = active;
+
+    auto& m = values.metrics;
+    m.replan = true;
+    m.replan_shift = shift;
+    m.replan_frozen = warm.frozen;
+    m.replan_affected_periods = static_cast<int>(std::count(active.begin(), active.end(), true));
+    m.replan_orders_added = orders_added;
+    m.replan_orders_removed = orders_removed;
+    m.replan_orders_expired = orders_expired;
+    m.replan_orders_completed = orders_completed;
+    m.replan_overlap_periods = overlap;
+
+    LOG_FMT("[重排程] 前移 %d 期: T %d -> %d, 订单 %d -> %d (新增 %d, 删除 %d, 移出 %d, 已完成 %d)\n",
+            shift, T_old, T_new, N_old, values.number_of_items,
+            orders_added, orders_removed, orders_expired, orders_completed);
+    LOG_FMT("[重排程] 冻结 %d 期, 受影响 %d 期, 首期 carryover 转 setup %d 个\n",
+            warm.frozen, m.replan_affected_periods, converted);
+
+    // 新算例供下一次重排程使用
+    std::error_code ec;
+    fs::create_directories(args.output_dir, ec);
+    string instance_file = args.output_dir + "/replan_instance_" + GetCurrentTimestamp() + ".csv";
+    if (WriteInstanceCSV(instance_file, values, lists)) {
+        m.replan_instance_file = instance_file;
+        LOG_FMT("[重排程] 新算例已保存: %s\n", instance_file.c_str());
+    } else {
+        LOG_FMT("[重排程] 无法写入新算例: %s\n", instance_file.c_str());
+    }
+    return true;
+}
+
+// ============================================================================
+// 计划变化量
+// ============================================================================
+void EvaluateReplanChanges(const ReplanContext& context, AllValues& values, const AllLists& lists) {
+    auto& m = values.metrics;
+    int G = values.number_of_groups;
+    int shift = context.delta.shift;
+    const ReplanWarmStart& warm = context.warm;
+    const PreviousPlan& prev = context.previous;
+
+    m.replan_setup_changes = 0;
+    m.replan_carryover_changes = 0;
+    m.replan_periods_changed = 0;
+    m.replan_first_changed = -1;
+    m.replan_volume_change = 0.0;
+    m.replan_volume_change_pct = 0.0;
+
+    if (static_cast<int>(lists.small_y.size()) != G || static_cast<int>(lists.small_l.size()) != G) {
+        LOG("[重排程] 无最终计划，跳过变化统计");
+        return;
+    }
+
+    // 与暖启动比较 (首期 carryover 转 setup 是模型要求，不计为变化)；
+    // 生产量按周期总量比较，与订单是否合并无关
+    double old_total = 0.0;
+    for (int t = 0; t < context.overlap; t++) {
+        bool changed = false;
+        for (int g = 0; g < G; g++) {
+            if (lists.small_y[g][t] != warm.y[g][t]) {
+                m.replan_setup_changes++;
+                changed = true;
+            }
+            if (lists.small_l[g][t] != warm.lambda[g][t]) {
+                m.replan_carryover_changes++;
+                changed = true;
+            }
+        }
+
+        double old_volume = 0.0;
+        for (const auto& row : prev.x) {
+            if (t + shift < static_cast<int>(row.size())) old_volume += row[t + shift];
+        }
+        double new_volume = 0.0;
+        for (const auto& row : lists.small_x) {
+            if (t < static_cast<int>(row.size())) new_volume += row[t];
+        }
+        old_total += old_volume;
+        m.replan_volume_change += fabs(new_volume - old_volume);
+        if (fabs(new_volume - old_volume) > 0.5) {
+            changed = true;
+        }
+
+        if (changed) {
+            m.replan_periods_changed++;
+            if (m.replan_first_changed < 0) m.replan_first_changed = t;
+        }
+    }
+    m.replan_volume_change_pct = old_total > 0 ? m.replan_volume_change / old_total : 0.0;
+
+    LOG_FMT("[重排程] 计划变化: 重叠 %d 期中 %d 期变化 (首个 %d), y 变化 %d, lambda 变化 %d, "
+            "生产量变化 %.0f (%.2f%%)\n",
+            context.overlap, m.replan_periods_changed, m.replan_first_changed,
+            m.replan_setup_changes, m.replan_carryover_changes,
+            m.replan_volume_change, m.replan_volume_change_pct * 100.0);
+}
+
+// ============================================================================
+// 写出算例
+// ============================================================================
+bool WriteInstanceCSV(const string& path, const AllValues& values, const AllLists& lists) {
+    ofstream fout(path);
+    if (!fout) {
+        return false;
+    }
+
+    auto write_row = [&](const string& label, const auto& row) {
+        fout << label;
+        for (const auto& v : row) fout << "," << v;
+        fout << "\n";
+    };
+
+    fout << "case_id,replan\n";
+    fout << "T," << values.number_of_periods << "\n";
+    fout << "F," << values.number_of_flows << "\n";
+    fout << "G," << values.number_of_groups << "\n";
+    write_row("cost_y", lists.cost_y);
+    write_row("cost_i", lists.cost_i);
+    write_row("usage_y", lists.usage_y);
+    fout << "N," << values.number_of_items << "\n";
+    for (int f = 0; f < values.number_of_flows; f++) {
+        write_row("demand_f" + to_string(f + 1), lists.period_demand[f]);
+    }
+
+    for (int i = 0; i < values.number_of_items; i++) {
+        int g = static_cast<int>(std::find(lists.group_flag[i].begin(), lists.group_flag[i].end(), 1)
+                                 - lists.group_flag[i].begin());
+        int f = static_cast<int>(std::find(lists.flow_flag[i].begin(), lists.flow_flag[i].end(), 1)
+                                 - lists.flow_flag[i].begin());
+        fout << "order_" << (i + 1) << "," << (i + 1) << "," << (g + 1) << "," << (f + 1) << ","
+             << lists.final_demand[i] << "," << lists.ew_x[i] << "," << lists.lw_x[i] << ","
+             << lists.usage_x[i] << "," << lists.cost_x[i] << "\n";
+    }
+    return static_cast<bool>(fout);
+}
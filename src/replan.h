@@ -0,0 +1,65 @@
+// replan.h - 滚动重排程
+// 计划期前移时以上一次的计划为暖启动，只重新优化受影响的周期:
+//   -f <上次算例.csv> --replan <上次结果.json> --replan-delta <增量.csv>
+// 增量文件与输入 CSV 相同 (按行、逗号分隔，第一列为标签):
+//   shift,1                     计划期前移的周期数 (旧周期 t 对应新周期 t-shift)
+//   frozen,2                    新计划期前若干周期沿用旧计划，不再优化
+//   horizon,30                  新计划期长度 (缺省沿用旧值)
+//   remove,3,17                 删除的订单 (旧算例中第 k 个订单行，即 order_k)
+//   demand_f1,<v1>,<v2>,...     流向 1 在新增尾部周期的周期需求 (缺省重复旧计划期最后一期)
+//   order_1,<编号>,<分组>,...    新增订单 (列同输入 CSV，时间窗为新计划期坐标)
+// 时间窗整体移出计划期的订单视为已结束并丢弃；旧周期 [0, shift) 视为已执行，
+// 上次结果中这些周期的生产量从保留订单的需求中扣除，扣完的订单视为已完成。
+//
+// 旧计划的 (y, lambda) 平移到新计划期作为暖启动；受影响周期为新增尾部周期与增删订单的时间窗，
+// FO 只在核心窗口含受影响周期处求解。新算例写入输出目录 (replan_instance_<时间>.csv)，
+// 作为下一次重排程的 -f；结果 JSON 的 metrics.replan 报告计划变化量
+
+#ifndef REPLAN_H_
+#define REPLAN_H_
+
+#include "solve_driver.h"
+
+// 上次结果中的计划
+struct PreviousPlan {
+    vector<vector<int>> y;          // [g][t]
+    vector<vector<int>> lambda;     // [g][t]
+    vector<vector<double>> x;       // [i][t] (行为上次求解的订单，可能已合并)
+    vector<vector<double>> b;       // [i][t] (行同 x)
+};
+
+// 算例增量
+struct ReplanDelta {
+    int shift = 0;
+    int frozen = 0;
+    int horizon = -1;                       // < 0 表示沿用旧计划期长度
+    vector<int> removed;                    // 旧订单下标 (0 起)
+    vector<vector<int>> tail_demand;        // [f] 新增尾部周期的周期需求，空表示重复最后一期
+    vector<string> added_orders;            // 新增订单行 (原样)
+};
+
+// 重排程上下文 (求解前准备，求解后计算变化量)
+struct ReplanContext {
+    PreviousPlan previous;
+    ReplanDelta delta;
+    ReplanWarmStart warm;
+    int overlap = 0;                        // 新计划期中有旧计划的周期数 [0, overlap)
+};
+
+// 读取上次结果 JSON 的 variables.Y/L/X/B
+bool ReadPreviousPlan(const string& path, PreviousPlan& plan);
+
+// 读取增量文件
+bool ReadReplanDelta(const string& path, ReplanDelta& delta);
+
+// 在已读取的旧算例上应用增量 (合并前调用)，映射旧计划并写出新算例
+bool PrepareReplan(const CommandLineArgs& args, AllValues& values, AllLists& lists,
+                   ReplanContext& context);
+
+// 比较最终计划与暖启动计划，写入 values.metrics.replan_*
+void EvaluateReplanChanges(const ReplanContext& context, AllValues& values, const AllLists& lists);
+
+// 按输入 CSV 格式写出算例 (合并前的订单)
+bool WriteInstanceCSV(const string& path, const AllValues& values, const AllLists& lists);
+
+#endif  // REPLAN_H_
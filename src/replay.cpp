@@ -0,0 +1,390 @@
+// replay.cpp - 子问题离线重放实现
+
+#include "replay.h"
+#include "child_solve.h"
+#include "cplex_params.h"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr double kReplayTimeShift = 1.0;   // 平移几何平均的平移量 (秒)
+
+// 解析 "mip_start": {"name": value, ...}；null 或缺省时为空
+vector<pair<string, double>> ParseMipStart(const string& text) {
+    vector<pair<string, double>> start;
+    size_t pos = text.find("\"mip_start\":");
+    if (pos == string::npos) return start;
+    size_t open = text.find_first_not_of(" \t\r\n", pos + 12);
+    if (open == string::npos || text[open] != '{') return start;
+    size_t close = text.find('}', open);
+    size_t cur = open + 1;
+    while (close != string::npos) {
+        size_t name_begin = text.find('"', cur);
+        if (name_begin == string::npos || name_begin > close) break;
+        size_t name_end = text.find('"', name_begin + 1);
+        size_t colon = text.find(':', name_end);
+        if (colon == string::npos || colon > close) break;
+        char* end = nullptr;
+        double value = strtod(text.c_str() + colon + 1, &end);
+        start.emplace_back(text.substr(name_begin + 1, name_end - name_begin - 1), value);
+        cur = end - text.c_str();
+    }
+    return start;
+}
+
+string ProfileName(const ReplayOptions& options, size_t p) {
+    return options.profiles[p].name.empty() ? "default" : options.profiles[p].name;
+}
+
+// 在工作线程的环境中求解一次
+// phase_params 为叠加的阶段参数 (--phase-profiles)，可为空
+void SolveOnce(IloEnv env, const ReplaySubproblem& sp, const ConfigSection& profile,
+               const CplexPhaseProfile* phase_params, const ReplayOptions& options, ReplayRun& run) {
+    IloCplex cplex(env);
+    IloModel model(env);
+    IloObjective objective(env);
+    IloNumVarArray vars(env);
+    IloRangeArray ranges(env);
+    try {
+        cplex.importModel(model, sp.model_path.c_str(), objective, vars, ranges);
+        cplex.extract(model);
+
+        cplex.setOut(env.getNullStream());
+        cplex.setWarning(env.getNullStream());
+        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
+        if (!options.cplex_workdir.empty()) {
+            cplex.setParam(IloCplex::Param::WorkDir, options.cplex_workdir.c_str());
+        }
+        cplex.setParam(IloCplex::Param::WorkMem, options.cplex_workmem);
+        cplex.setParam(IloCplex::TiLim, options.time_limit >= 0 ? options.time_limit : sp.time_limit);
+        cplex.setParam(IloCplex::Threads, options.threads);
+        ApplyCplexProfile(cplex, profile);
+        if (phase_params != nullptr) {
+            for (const auto& [key, value] : phase_params->params) {
+                ApplyCplexParam(cplex, key, value);
+            }
+        }
+
+        if (options.mip_start && !sp.mip_start.empty()) {
+            map<string, IloNumVar> by_name;
+            for (IloInt j = 0; j < vars.getSize(); j++) {
+                const char* name = vars[j].getName();
+                if (name != nullptr) by_name[name] = vars[j];
+            }
+            IloNumVarArray start_vars(env);
+            IloNumArray start_values(env);
+            for (const auto& [name, value] : sp.mip_start) {
+                auto it = by_name.find(name);
+                if (it == by_name.end()) continue;
+                start_vars.add(it->second);
+                start_values.add(value);
+            }
+            if (start_vars.getSize() > 0) {
+                cplex.addMIPStart(start_vars, start_values, IloCplex::MIPStartRepair);
+            }
+            start_vars.end();
+            start_values.end();
+        }
+
+        auto start = chrono::steady_clock::now();
+        cplex.solve();
+        run.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        run.nodes = cplex.getNnodes();
+
+        IloAlgorithm::Status status = cplex.getStatus();
+        if (status == IloAlgorithm::Optimal || status == IloAlgorithm::Feasible) {
+            run.status = status == IloAlgorithm::Optimal ? "optimal" : "feasible";
+            run.objective = cplex.getObjValue();
+            run.bound = cplex.getBestObjValue();
+            run.gap = cplex.getMIPRelativeGap();
+        } else {
+            run.status = status == IloAlgorithm::Infeasible ? "infeasible" : "unknown";
+        }
+    } catch (IloException& e) {
+        cerr << "[重放] " << sp.name << ": " << e.getMessage() << "\n";
+        run.status = "error";
+    }
+
+    // 环境在整个工作线程内复用，导入的变量与约束逐次释放
+    cplex.end();
+    model.end();
+    objective.end();
+    ranges.endElements();
+    ranges.end();
+    vars.endElements();
+    vars.end();
+}
+
+// 平移几何平均
+double ShiftedGeoMean(const vector<double>& values) {
+    if (values.empty()) return 0.0;
+    double log_sum = 0.0;
+    for (double v : values) log_sum += log(v + kReplayTimeShift);
+    return exp(log_sum / values.size()) - kReplayTimeShift;
+}
+
+}  // namespace
+
+bool ReadSubproblemDumps(const string& dir, const vector<string>& phases,
+                         vector<ReplaySubproblem>& subproblems) {
+    subproblems.clear();
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        cerr << "[重放] 不是目录: " << dir << "\n";
+        return false;
+    }
+
+    vector<pair<int, ReplaySubproblem>> found;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (entry.path().extension() != ".json") continue;
+        ifstream fin(entry.path());
+        stringstream buffer;
+        buffer << fin.rdbuf();
+        string text = buffer.str();
+
+        ReplaySubproblem sp;
+        sp.phase = JsonString(text, "phase");
+        string model = JsonString(text, "model");
+        if (sp.phase.empty() || model.empty()) continue;   // 不是转储的附带 JSON
+        if (!phases.empty() && std::find(phases.begin(), phases.end(), sp.phase) == phases.end()) {
+            continue;
+        }
+        sp.name = entry.path().stem().string();
+        sp.model_path = (fs::path(dir) / model).string();
+        sp.k = static_cast<int>(JsonNumber(text, "k", 0));
+        sp.W = static_cast<int>(JsonNumber(text, "W", 0));
+        sp.time_limit = JsonNumber(text, "time_limit", 60.0);
+        sp.mip_start = ParseMipStart(text);
+        if (!fs::exists(sp.model_path, ec)) {
+            cerr << "[重放] 缺少模型文件: " << sp.model_path << "\n";
+            continue;
+        }
+        found.emplace_back(static_cast<int>(JsonNumber(text, "sequence", 0)), std::move(sp));
+    }
+    std::sort(found.begin(), found.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& [sequence, sp] : found) subproblems.push_back(std::move(sp));
+    return !subproblems.empty();
+}
+
+vector<ReplayRun> RunReplay(const vector<ReplaySubproblem>& subproblems, const ReplayOptions& options) {
+    // 同一子问题的各配置相邻，提前中止时各配置的样本仍可比较
+    vector<ReplayRun> runs;
+    for (size_t s = 0; s < subproblems.size(); s++) {
+        for (size_t p = 0; p < options.profiles.size(); p++) {
+            ReplayRun run;
+            run.subproblem = s;
+            run.profile = p;
+            runs.push_back(run);
+        }
+    }
+
+    int workers = options.workers;
+    if (workers <= 0) {
+        int hardware = max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        workers = max(1, hardware / max(1, options.threads));
+    }
+    workers = min(workers, static_cast<int>(runs.size()));
+
+    std::atomic<size_t> next{0};
+    std::mutex log_mutex;
+    auto work = [&]() {
+        IloEnv env;
+        for (size_t k = next++; k < runs.size(); k = next++) {
+            ReplayRun& run = runs[k];
+            const ReplaySubproblem& sp = subproblems[run.subproblem];
+            const CplexPhaseProfile* phase_params = nullptr;
+            if (static_cast<int>(run.profile) == options.phase_profile) {
+                auto it = options.phase_profiles.find(sp.phase);
+                if (it != options.phase_profiles.end()) phase_params = &it->second;
+            }
+            SolveOnce(env, sp, options.profiles[run.profile], phase_params, options, run);
+            std::lock_guard<std::mutex> lock(log_mutex);
+            cout << "[重放] " << sp.name << " " << ProfileName(options, run.profile) << ": "
+                 << run.status << " 目标=" << fixed << setprecision(2) << run.objective
+                 << " 时间=" << setprecision(2) << run.time << "s 节点=" << run.nodes
+                 << defaultfloat << "\n";
+        }
+        env.end();
+    };
+
+    cout << "[重放] 子问题 " << subproblems.size() << " 个 x 配置 " << options.profiles.size()
+         << " 个，并行 " << workers << " x " << options.threads << " 线程\n";
+    vector<std::thread> pool;
+    for (int w = 0; w < workers; w++) pool.emplace_back(work);
+    for (auto& thread : pool) thread.join();
+    return runs;
+}
+
+void WriteReplayCsv(ostream& out, const vector<ReplaySubproblem>& subproblems,
+                    const ReplayOptions& options, const vector<ReplayRun>& runs) {
+    out << "subproblem,phase,k,W,profile,status,objective,bound,gap,time,nodes\n";
+    out << fixed << setprecision(4);
+    for (const auto& run : runs) {
+        const auto& sp = subproblems[run.subproblem];
+        out << sp.name << "," << sp.phase << "," << sp.k << "," << sp.W << ","
+            << ProfileName(options, run.profile) << "," << run.status << ","
+            << run.objective << "," << run.bound << "," << run.gap << ","
+            << run.time << "," << run.nodes << "\n";
+    }
+}
+
+void PrintReplaySummary(const vector<ReplaySubproblem>& subproblems,
+                        const ReplayOptions& options, const vector<ReplayRun>& runs) {
+    size_t P = options.profiles.size();
+
+    // 每个子问题上各配置的最好目标
+    vector<double> best(subproblems.size(), -1.0);
+    for (const auto& run : runs) {
+        if (run.objective < 0) continue;
+        double& b = best[run.subproblem];
+        if (b < 0 || run.objective < b) b = run.objective;
+    }
+
+    // 阶段列表 (按出现顺序)，"all" 在最后
+    vector<string> phases;
+    for (const auto& sp : subproblems) {
+        if (std::find(phases.begin(), phases.end(), sp.phase) == phases.end()) {
+            phases.push_back(sp.phase);
+        }
+    }
+    phases.push_back("all");
+
+    cout << "\n" << left << setw(18) << "profile" << setw(12) << "phase" << right
+         << setw(7) << "count" << setw(8) << "solved" << setw(9) << "optimal"
+         << setw(11) << "sgm_time" << setw(10) << "speedup" << setw(10) << "mean_gap"
+         << setw(7) << "wins" << "\n";
+    cout << string(92, '-') << "\n" << fixed;
+
+    for (const string& phase : phases) {
+        double base_time = 0.0;   // 第一个配置的 sgm_time，speedup 相对于它
+        for (size_t p = 0; p < P; p++) {
+            int count = 0, solved = 0, optimal = 0, wins = 0, gaps = 0;
+            double gap_sum = 0.0;
+            vector<double> times;
+            for (const auto& run : runs) {
+                if (run.profile != p) continue;
+                const auto& sp = subproblems[run.subproblem];
+                if (phase != "all" && sp.phase != phase) continue;
+                count++;
+                times.push_back(run.time);
+                if (run.objective >= 0) {
+                    solved++;
+                    double b = best[run.subproblem];
+                    if (run.objective <= b + kEpsilon * max(1.0, fabs(b))) wins++;
+                }
+                if (run.status == "optimal") optimal++;
+                if (run.gap >= 0) {
+                    gap_sum += run.gap;
+                    gaps++;
+                }
+            }
+            double sgm = ShiftedGeoMean(times);
+            if (p == 0) base_time = sgm;
+            cout << left << setw(18) << ProfileName(options, p) << setw(12) << phase << right
+                 << setw(7) << count << setw(8) << solved << setw(9) << optimal
+                 << setw(11) << setprecision(3) << sgm
+                 << setw(10) << setprecision(2) << (base_time + kReplayTimeShift) / (sgm + kReplayTimeShift)
+                 << setw(10) << setprecision(4) << (gaps > 0 ? gap_sum / gaps : 0.0)
+                 << setw(7) << wins << "\n";
+        }
+    }
+    cout << defaultfloat;
+}
+
+vector<PhaseTuneResult> TunePhases(const vector<ReplaySubproblem>& subproblems,
+                                   const ReplayOptions& options, const PhaseTuneOptions& tune,
+                                   const string& prm_prefix) {
+    // 各阶段的子问题 (按阶段名表顺序)
+    vector<PhaseTuneResult> results;
+    mt19937 rng(tune.seed);
+    IloEnv env;
+    for (const string& phase : CplexPhaseNames()) {
+        vector<size_t> members;
+        for (size_t s = 0; s < subproblems.size(); s++) {
+            if (subproblems[s].phase == phase) members.push_back(s);
+        }
+        if (members.empty()) continue;
+        // 抽样后按序号 (转储顺序) 排列，同一种子得到同一组模型
+        std::shuffle(members.begin(), members.end(), rng);
+        members.resize(min(members.size(), static_cast<size_t>(max(1, tune.sample))));
+        std::sort(members.begin(), members.end());
+
+        PhaseTuneResult result;
+        result.phase = phase;
+        result.samples = static_cast<int>(members.size());
+        result.prm_path = prm_prefix + "." + phase + ".prm";
+
+        // 单次试解时限: -t 或样本中最大的转储时限
+        double trial_limit = options.time_limit;
+        if (trial_limit < 0) {
+            trial_limit = 0.0;
+            for (size_t s : members) trial_limit = max(trial_limit, subproblems[s].time_limit);
+        }
+        cout << "[调参] " << phase << ": " << members.size() << " 个模型，单次时限 "
+             << trial_limit << "s，总时限 " << tune.tune_time << "s\n";
+
+        IloCplex cplex(env);
+        IloArray<const char*> files(env);
+        IloCplex::ParameterSet fixed(env);
+        try {
+            for (size_t s : members) files.add(subproblems[s].model_path.c_str());
+            cplex.setOut(env.getNullStream());
+            cplex.setWarning(env.getNullStream());
+            cplex.setDefaults();
+            cplex.setParam(IloCplex::Param::Tune::TimeLimit, tune.tune_time);
+            // 时限与线程数固定，不参与调参
+            fixed.setParam(IloCplex::Param::TimeLimit, trial_limit);
+            fixed.setParam(IloCplex::Param::Threads, options.threads);
+            if (!options.cplex_workdir.empty()) {
+                cplex.setParam(IloCplex::Param::WorkDir, options.cplex_workdir.c_str());
+            }
+            cplex.setParam(IloCplex::Param::WorkMem, options.cplex_workmem);
+
+            IloInt status = cplex.tuneParam(files, fixed);
+            result.status = status == IloCplex::TuningComplete ? "complete"
+                          : status == IloCplex::TuningTimeLim ? "time_limit" : "aborted";
+            result.params = NonDefaultCplexParams(cplex);
+            cplex.writeParam(result.prm_path.c_str());
+        } catch (IloException& e) {
+            cerr << "[调参] " << phase << ": " << e.getMessage() << "\n";
+            result.status = "error";
+        }
+        fixed.end();
+        files.end();
+        cplex.end();
+
+        cout << "[调参] " << phase << " " << result.status << ":";
+        for (const auto& [key, value] : result.params) cout << " " << key << "=" << value;
+        cout << (result.params.empty() ? " (默认参数)" : "") << "\n";
+        results.push_back(std::move(result));
+    }
+    env.end();
+    return results;
+}
+
+bool WritePhaseProfiles(const string& path, const vector<PhaseTuneResult>& results) {
+    ofstream fout(path);
+    if (!fout) {
+        cerr << "[调参] 无法写入: " << path << "\n";
+        return false;
+    }
+    fout << "; LS-NTGF-Replay --tune-param 生成，用于 LS-NTGF-All --cplex-profiles\n"
+         << "; 每个阶段一节，参数表之外的调参结果见各阶段的 .prm 文件\n";
+    for (const auto& result : results) {
+        if (result.status == "error") continue;
+        fout << "\n; " << result.samples << " 个模型，调参状态 " << result.status
+             << "，完整参数: " << fs::path(result.prm_path).filename().string() << "\n"
+             << "[" << result.phase << "]\n";
+        for (const auto& [key, value] : result.params) {
+            fout << key << " = " << value << "\n";
+        }
+    }
+    return static_cast<bool>(fout);
+}
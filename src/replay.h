@@ -0,0 +1,95 @@
+// replay.h - 子问题离线重放
+// 读取 --dump-subproblems 转储的目录 (见 subproblem_dump.h)，在若干 CPLEX 参数配置 (见 cplex_params.h)
+// 下并行重新求解每个子问题，记录状态、目标、界、gap、时间与节点数，按配置与阶段汇总。
+// 每个工作线程持有一个 IloEnv (许可证只检出一次)，每次求解新建 IloCplex 并导入模型文件；
+// 附带 JSON 中的 mip_start 按变量名作为 MIP 初始解 (MIPStartRepair) 加入。
+//
+// 汇总指标: solved (有可行解)、optimal、时间的平移几何平均 (平移 1 秒，少数长求解不主导结果)、
+// 平均 gap，以及 wins (目标不差于同一子问题上各配置的最好目标)
+//
+// 分阶段调参 (--tune-param): 每个阶段随机抽取若干转储的模型文件，用 IloCplex::tuneParam 调参，
+// 调得的参数中属于 cplex_params.h 参数表的写成与阶段同名的节 (可直接作为 --cplex-profiles)，
+// 完整参数另存为 CPLEX 参数文件 (.prm)。调参不使用 mip_start
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "optimizer.h"
+#include "config_file.h"
+
+// 一个转储的子问题
+struct ReplaySubproblem {
+    string name;                 // 文件名主干 (fo_window_0012_k8_W6)
+    string model_path;
+    string phase;
+    int k = 0;
+    int W = 0;
+    double time_limit = 0.0;     // 转储时的时限
+    vector<pair<string, double>> mip_start;
+};
+
+struct ReplayOptions {
+    vector<ConfigSection> profiles;   // 参数配置 (名称为空的节视为不加参数的 default)
+    int workers = 0;                  // 并行求解数，0 表示硬件线程数 / threads
+    int threads = 1;                  // 每次求解的 CPLEX 线程数
+    double time_limit = -1.0;         // 每次求解的时限，负值取转储时的时限
+    bool mip_start = true;
+    string cplex_workdir;             // 空为 CPLEX 默认
+    int cplex_workmem = 4096;
+    // 分阶段配置 (--phase-profiles): 第 phase_profile 个配置再叠加子问题所属阶段的参数
+    int phase_profile = -1;           // -1 表示没有
+    map<string, CplexPhaseProfile> phase_profiles;
+};
+
+// 分阶段调参选项
+struct PhaseTuneOptions {
+    int sample = 8;                   // 每个阶段的模型数
+    unsigned seed = 1;                // 抽样种子
+    double tune_time = 600.0;         // 每个阶段的调参总时限 (Tune::TimeLimit)
+};
+
+// 一个阶段的调参结果
+struct PhaseTuneResult {
+    string phase;
+    int samples = 0;
+    string status = "error";          // complete / aborted / time_limit / error
+    vector<pair<string, string>> params;   // 参数表中非默认的参数
+    string prm_path;                  // 完整参数文件
+};
+
+// 一次求解 (子问题 x 配置)
+struct ReplayRun {
+    size_t subproblem = 0;
+    size_t profile = 0;
+    string status = "error";          // optimal / feasible / infeasible / unknown / error
+    double objective = -1.0;          // 无可行解为 -1
+    double bound = 0.0;
+    double gap = -1.0;
+    double time = 0.0;
+    long nodes = 0;
+};
+
+// 读取转储目录中的子问题 (按序号排序)；phases 非空时只保留列出的阶段
+bool ReadSubproblemDumps(const string& dir, const vector<string>& phases,
+                         vector<ReplaySubproblem>& subproblems);
+
+// 并行重放，返回全部求解记录 (顺序与子问题、配置一致)
+vector<ReplayRun> RunReplay(const vector<ReplaySubproblem>& subproblems, const ReplayOptions& options);
+
+// 逐次求解记录
+void WriteReplayCsv(ostream& out, const vector<ReplaySubproblem>& subproblems,
+                    const ReplayOptions& options, const vector<ReplayRun>& runs);
+
+// 按配置与阶段汇总的终端表格
+void PrintReplaySummary(const vector<ReplaySubproblem>& subproblems,
+                        const ReplayOptions& options, const vector<ReplayRun>& runs);
+
+// 按阶段抽样调参 (阶段依次进行，每个阶段用 options.threads 线程)；prm_prefix 为 .prm 文件名前缀
+vector<PhaseTuneResult> TunePhases(const vector<ReplaySubproblem>& subproblems,
+                                   const ReplayOptions& options, const PhaseTuneOptions& tune,
+                                   const string& prm_prefix);
+
+// 写出分阶段配置文件 (每个阶段一节)
+bool WritePhaseProfiles(const string& path, const vector<PhaseTuneResult>& results);
+
+#endif  // REPLAY_H_
@@ -0,0 +1,179 @@
+// replay_main.cpp - 子问题重放主程序 (LS-NTGF-Replay)
+// 在多个 CPLEX 参数配置下重新求解 --dump-subproblems 转储的子问题，或按阶段调参，见 replay.h
+//
+// 用法: LS-NTGF-Replay <转储目录> [--profiles <ini>] [--phase-profiles <ini>] [options]
+//       LS-NTGF-Replay <转储目录> --tune-param <ini> [options]
+
+#include "replay.h"
+#include "cplex_params.h"
+
+static void PrintReplayUsage(const char* program) {
+    cout << "Usage: " << program << " <dump_dir> [options]\n\n"
+         << "Re-solves subproblems exported with LS-NTGF-All --dump-subproblems under\n"
+         << "alternative CPLEX parameter profiles and tabulates time and objective.\n\n"
+         << "Profiles:\n"
+         << "  --profiles <ini>         CPLEX parameter profiles, one section per profile\n"
+         << "                           (\"default\", CPLEX defaults, always runs first)\n"
+         << "  --phase-profiles <ini>   Per-phase profiles (LS-NTGF-All --cplex-profiles format),\n"
+         << "                           run as profile \"phases\" with each subproblem's phase applied\n"
+         << "  --only <list>            Only run the listed profiles (comma-separated)\n\n"
+         << "Per-phase Tuning:\n"
+         << "  --tune-param <ini>       Run IloCplex::tuneParam on a sample of each phase and write\n"
+         << "                           per-phase profiles (plus <ini>.<phase>.prm) instead of replaying\n"
+         << "  --tune-sample <n>        Models sampled per phase (default: 8)\n"
+         << "  --tune-seed <n>          Sampling seed (default: 1)\n"
+         << "  --tune-time <sec>        Tuning time limit per phase (default: 600)\n\n"
+         << "Selection:\n"
+         << "  --phase <list>           Only use these phases: rf_window,rf_final,fo_window,fo_final,\n"
+         << "                           rr_step1,rr_step2,rr_step3,direct\n"
+         << "  --no-mip-start           Ignore the recorded MIP starts\n\n"
+         << "Solve:\n"
+         << "  --workers <n>            Parallel solves, 0=hardware threads / --threads (default: 0)\n"
+         << "  --threads <n>            CPLEX threads per solve (default: 1)\n"
+         << "  -t <sec>                 Time limit per solve (default: recorded budget)\n"
+         << "  --cplex-workdir <path>   CPLEX working directory (default: CPLEX default)\n"
+         << "  --cplex-workmem <MB>     CPLEX memory limit (default: 4096)\n\n"
+         << "Output:\n"
+         << "  -o <csv>                 Per-solve results (default: <dump_dir>/replay_<time>.csv)\n"
+         << "  -h, --help               Show this help message\n\n"
+         << "CPLEX parameter keys:\n ";
+    for (const auto& key : CplexParamKeys()) cout << " " << key;
+    cout << "\n\nExample:\n"
+         << "  " << program << " dumps/N100 --profiles profiles.ini --phase fo_window -t 30\n"
+         << "  " << program << " dumps/N100 --tune-param phases.ini --tune-sample 6 --threads 4\n";
+}
+
+int main(int argc, char* argv[]) {
+    string dump_dir;
+    string profiles_path;
+    string only;
+    string phase_list;
+    string output;
+    string phase_profiles_path;
+    string tune_output;
+    ReplayOptions options;
+    PhaseTuneOptions tune;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            PrintReplayUsage(argv[0]);
+            return 0;
+        } else if (arg == "--profiles" && i + 1 < argc) {
+            profiles_path = argv[++i];
+        } else if (arg == "--phase-profiles" && i + 1 < argc) {
+            phase_profiles_path = argv[++i];
+        } else if (arg == "--tune-param" && i + 1 < argc) {
+            tune_output = argv[++i];
+        } else if (arg == "--tune-sample" && i + 1 < argc) {
+            tune.sample = max(1, atoi(argv[++i]));
+        } else if (arg == "--tune-seed" && i + 1 < argc) {
+            tune.seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--tune-time" && i + 1 < argc) {
+            tune.tune_time = atof(argv[++i]);
+        } else if (arg == "--only" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "--phase" && i + 1 < argc) {
+            phase_list = argv[++i];
+        } else if (arg == "--no-mip-start") {
+            options.mip_start = false;
+        } else if (arg == "--workers" && i + 1 < argc) {
+            options.workers = max(0, atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = max(0, atoi(argv[++i]));
+        } else if (arg == "-t" && i + 1 < argc) {
+            options.time_limit = atof(argv[++i]);
+        } else if (arg == "--cplex-workdir" && i + 1 < argc) {
+            options.cplex_workdir = argv[++i];
+        } else if (arg == "--cplex-workmem" && i + 1 < argc) {
+            options.cplex_workmem = atoi(argv[++i]);
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && dump_dir.empty()) {
+            dump_dir = arg;
+        } else {
+            cerr << "Unknown option: " << arg << "\n";
+            PrintReplayUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (dump_dir.empty()) {
+        PrintReplayUsage(argv[0]);
+        return 1;
+    }
+
+    // 配置: default (不加参数) 在前，其后为配置文件中的各节
+    options.profiles.push_back(ConfigSection());
+    if (!profiles_path.empty()) {
+        vector<ConfigSection> profiles;
+        if (!ReadCplexProfiles(profiles_path, profiles)) {
+            return 1;
+        }
+        for (auto& profile : profiles) {
+            if (profile.name == "default") {
+                options.profiles[0] = std::move(profile);   // 覆盖 default
+            } else {
+                options.profiles.push_back(std::move(profile));
+            }
+        }
+    }
+    if (!phase_profiles_path.empty()) {
+        if (!ReadCplexPhaseProfiles(phase_profiles_path, options.phase_profiles)) {
+            return 1;
+        }
+        ConfigSection phases;
+        phases.name = "phases";
+        options.profiles.push_back(phases);
+    }
+    if (!only.empty()) {
+        vector<string> names;
+        SplitString(only, names, ",");
+        std::erase_if(options.profiles, [&](const ConfigSection& p) {
+            string name = p.name.empty() ? "default" : p.name;
+            return std::find(names.begin(), names.end(), name) == names.end();
+        });
+        if (options.profiles.empty()) {
+            cerr << "[重放] --only 没有匹配的配置: " << only << "\n";
+            return 1;
+        }
+    }
+    for (size_t p = 0; p < options.profiles.size(); p++) {
+        if (!phase_profiles_path.empty() && options.profiles[p].name == "phases") {
+            options.phase_profile = static_cast<int>(p);
+        }
+    }
+
+    vector<string> phases;
+    if (!phase_list.empty()) {
+        SplitString(phase_list, phases, ",");
+    }
+    vector<ReplaySubproblem> subproblems;
+    if (!ReadSubproblemDumps(dump_dir, phases, subproblems)) {
+        cerr << "[重放] 没有可重放的子问题: " << dump_dir << "\n";
+        return 1;
+    }
+
+    if (!tune_output.empty()) {
+        vector<PhaseTuneResult> results = TunePhases(subproblems, options, tune, tune_output);
+        if (results.empty() || !WritePhaseProfiles(tune_output, results)) {
+            return 1;
+        }
+        cout << "\n[调参] 分阶段配置: " << tune_output << "\n";
+        return 0;
+    }
+
+    vector<ReplayRun> runs = RunReplay(subproblems, options);
+
+    if (output.empty()) {
+        output = dump_dir + "/replay_" + GetCurrentTimestamp() + ".csv";
+    }
+    ofstream fout(output);
+    if (!fout) {
+        cerr << "[重放] 无法写入: " << output << "\n";
+        return 1;
+    }
+    WriteReplayCsv(fout, subproblems, options, runs);
+    PrintReplaySummary(subproblems, options, runs);
+    cout << "\n[重放] 逐次结果: " << output << "\n";
+    return 0;
+}
@@ -0,0 +1,154 @@
+// rf_cache.cpp - RF 子问题结果缓存实现
+
+#include "rf_cache.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ULL;
+constexpr uint64_t kFnvPrime = 1099511628211ULL;
+
+class Fnv1a {
+public:
+    void Bytes(const void* data, size_t size) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash_ = (hash_ ^ p[i]) * kFnvPrime;
+        }
+    }
+
+    template <typename T>
+    void Value(T value) {
+        Bytes(&value, sizeof(value));
+    }
+
+    template <typename T>
+    void List(const vector<T>& list) {
+        Value(list.size());
+        for (const T& v : list) {
+            Value(v);
+        }
+    }
+
+    template <typename T>
+    void Matrix(const vector<vector<T>>& matrix) {
+        Value(matrix.size());
+        for (const auto& row : matrix) {
+            List(row);
+        }
+    }
+
+    uint64_t Hash() const { return hash_; }
+
+private:
+    uint64_t hash_ = kFnvOffset;
+};
+
+}  // namespace
+
+RFSolveStatus ClassifyRFSolve(IloCplex& cplex, bool has_incumbent) {
+    if (has_incumbent) {
+        return RFSolveStatus::Feasible;
+    }
+    IloAlgorithm::Status status = cplex.getStatus();
+    if (status == IloAlgorithm::Infeasible || status == IloAlgorithm::InfeasibleOrUnbounded) {
+        return RFSolveStatus::Infeasible;
+    }
+    return RFSolveStatus::Unknown;
+}
+
+uint64_t RFInstanceFingerprint(const AllValues& values, const AllLists& lists) {
+    Fnv1a h;
+
+    h.Value(values.number_of_items);
+    h.Value(values.number_of_groups);
+    h.Value(values.number_of_periods);
+    h.Value(values.number_of_flows);
+    h.Value(values.machine_capacity);
+
+    h.List(lists.cost_x);
+    h.List(lists.cost_y);
+    h.List(lists.cost_i);
+    h.List(lists.cost_b);
+    h.List(lists.cost_u);
+    h.List(lists.usage_x);
+    h.List(lists.usage_y);
+    h.List(lists.ew_x);
+    h.List(lists.lw_x);
+    h.List(lists.final_demand);
+    h.Matrix(lists.flow_flag);
+    h.Matrix(lists.group_flag);
+    h.Matrix(lists.period_demand);
+
+    // 影响子问题模型或求解结果的参数
+    h.Value(values.rf_time);
+    h.Value(values.cplex_threads);
+    h.Value(values.aggregate_exclusivity);
+    h.Value(values.tight_big_m);
+    h.Value(values.item_vub);
+    h.Value(values.user_cut_scope);
+
+    return h.Hash();
+}
+
+RFSubproblemCache::RFSubproblemCache(const AllValues& values, const AllLists& lists)
+    : enabled_(values.rf_cache),
+      T_(values.number_of_periods),
+      fingerprint_(enabled_ ? RFInstanceFingerprint(values, lists) : 0) {}
+
+string RFSubproblemCache::Key(int k, int W, const RFState& state) const {
+    int win_end = min(k + W, T_);
+    int G = static_cast<int>(state.y_bar.size());
+
+    string key(sizeof(fingerprint_) + 2 * sizeof(int), '\0');
+    std::memcpy(&key[0], &fingerprint_, sizeof(fingerprint_));
+    std::memcpy(&key[sizeof(fingerprint_)], &k, sizeof(int));
+    std::memcpy(&key[sizeof(fingerprint_) + sizeof(int)], &win_end, sizeof(int));
+
+    // 前缀 [0,k) 的 (y, lambda) 每位一比特
+    unsigned char bits = 0;
+    int count = 0;
+    auto push = [&](int bit) {
+        bits = static_cast<unsigned char>(bits | ((bit & 1) << count));
+        if (++count == 8) {
+            key.push_back(static_cast<char>(bits));
+            bits = 0;
+            count = 0;
+        }
+    };
+    for (int t = 0; t < k; t++) {
+        for (int g = 0; g < G; g++) {
+            push(state.y_bar[g][t]);
+            push(state.lambda_bar[g][t]);
+        }
+    }
+    if (count > 0) {
+        key.push_back(static_cast<char>(bits));
+    }
+    return key;
+}
+
+bool RFSubproblemCache::Lookup(int k, int W, const RFState& state, RFCacheEntry& entry) {
+    if (!enabled_) {
+        return false;
+    }
+    auto it = entries_.find(Key(k, W, state));
+    if (it == entries_.end()) {
+        misses_++;
+        return false;
+    }
+    hits_++;
+    entry = it->second;
+    return true;
+}
+
+void RFSubproblemCache::Store(int k, int W, const RFState& state, const RFCacheEntry& entry) {
+    if (!enabled_) {
+        return;
+    }
+    entries_[Key(k, W, state)] = entry;
+}
+
+bool RFSubproblemCache::Contains(int k, int W, const RFState& state) const {
+    return enabled_ && entries_.count(Key(k, W, state)) > 0;
+}
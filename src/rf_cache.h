@@ -0,0 +1,66 @@
+// rf_cache.h - RF 子问题结果缓存
+// SP(k, W) 只依赖已固定前缀 [0,k) 的 (y, lambda)、窗口右端 min(k+W, T)、
+// 实例数据与影响模型/求解的参数。回滚后重新求解的窗口常与之前某次前缀相同，
+// 按上述内容缓存结果 (含不可行结论)，扩展重试与回滚循环不再重复求解同一子问题。
+// 只缓存确定的结论: 可行解、CPLEX 证明的不可行与预筛判定的不可行。超时无解、
+// 被截止时间缩短、被中断或淘汰中止以及出错的求解结论未知，不写入缓存，再次遇到时重新求解。
+//
+// 键由实例指纹、k、窗口右端和按位打包的前缀组成，散列表按完整键比较，
+// 前缀不同的子问题不会因散列冲突误命中
+
+#ifndef RF_CACHE_H_
+#define RF_CACHE_H_
+
+#include "optimizer.h"
+#include <cstdint>
+#include <unordered_map>
+
+// 子问题求解结论
+enum class RFSolveStatus {
+    Feasible,       // 找到可行解
+    Infeasible,     // 已证明不可行 (CPLEX 或预筛)
+    Unknown,        // 无解但未证明不可行 (超时、中止、出错)，不可缓存
+};
+
+// 由 CPLEX 求解状态得到结论 (has_incumbent 为是否有可行解)
+RFSolveStatus ClassifyRFSolve(IloCplex& cplex, bool has_incumbent);
+
+// 子问题结果
+struct RFCacheEntry {
+    bool feasible = false;
+    double objective = -1.0;
+    double cpu_time = 0.0;              // 首次求解耗时
+    vector<vector<int>> y;              // 可行时的 y 解 [g][t]
+    vector<vector<int>> lambda;         // 可行时的 lambda 解 [g][t]
+};
+
+// 实例指纹: 订单/大类/工序数据与子问题相关参数 (时限、线程、模型写法、用户割) 的 FNV-1a 散列
+uint64_t RFInstanceFingerprint(const AllValues& values, const AllLists& lists);
+
+class RFSubproblemCache {
+public:
+    // values.rf_cache 关闭时 Lookup 恒不命中、Store 不保存
+    RFSubproblemCache(const AllValues& values, const AllLists& lists);
+
+    bool Lookup(int k, int W, const RFState& state, RFCacheEntry& entry);
+    // 调用方只存入确定的结论 (见 RFSolveStatus)
+    void Store(int k, int W, const RFState& state, const RFCacheEntry& entry);
+
+    // 是否已有结论 (不计入命中统计)
+    bool Contains(int k, int W, const RFState& state) const;
+
+    long Hits() const { return hits_; }
+    long Misses() const { return misses_; }
+
+private:
+    string Key(int k, int W, const RFState& state) const;
+
+    bool enabled_;
+    int T_;
+    uint64_t fingerprint_;
+    std::unordered_map<string, RFCacheEntry> entries_;
+    long hits_ = 0;
+    long misses_ = 0;
+};
+
+#endif  // RF_CACHE_H_
@@ -0,0 +1,165 @@
+// root_bound.cpp - 后台根节点下界实现
+//
+// LP 模式: 完整模型全部整数变量转为连续，LP 最优值即为下界 (中止时无效)
+// Root 模式: 节点上限为 0，CPLEX 只处理根节点 (预处理 + 割平面)，
+//            getBestObjValue 在任意时刻 (包括中止后) 都是合法下界
+// 后台线程不写日志，结果由主线程在 Finish 之后统一输出
+
+#include "root_bound.h"
+#include "lot_sizing_model.h"
+#include "lot_sizing_cuts.h"
+#include "logger.h"
+#include "deadline.h"
+
+RootBoundTask::~RootBoundTask() {
+    if (worker_.joinable()) {
+        Finish(0.0);
+    }
+}
+
+void RootBoundTask::Start(const AllValues& values, const AllLists& lists) {
+    if (values.root_bound_mode == RootBoundMode::Off || worker_.joinable()) {
+        return;
+    }
+
+    // 数据副本: 启发式会改写 lists 中的解和 values 中的统计
+    values_ = values;
+    lists_ = lists;
+
+    // 默认只占用主求解器之外的空闲核
+    int threads = values.root_threads;
+    if (threads <= 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        threads = values.cplex_threads > 0 ? hardware - values.cplex_threads : 1;
+    }
+    result_ = RootBoundResult();
+    result_.threads = max(1, threads);
+    done_ = false;
+    stop_requested_ = false;
+
+    LOG_FMT("[根节点下界] 后台启动: 模式=%s 时限=%.1fs 线程=%d\n",
+            RootBoundModeName(values.root_bound_mode), values.root_time, result_.threads);
+
+    worker_ = std::thread(&RootBoundTask::Run, this);
+}
+
+RootBoundResult RootBoundTask::Finish(double wait_seconds) {
+    if (!worker_.joinable()) {
+        return result_;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait_for(lock, std::chrono::duration<double>(max(0.0, wait_seconds)),
+                          [this] { return done_; });
+        if (!done_) {
+            stop_requested_ = true;
+            if (aborter_ != nullptr) {
+                aborter_->abort();
+            }
+        }
+    }
+    worker_.join();
+
+    LOG_FMT("[根节点下界] 完成: 下界=%.2f 耗时=%.3fs 用户割=%ld%s\n",
+            result_.bound, result_.time, result_.cuts, result_.aborted ? " (中止)" : "");
+    return result_;
+}
+
+void RootBoundTask::Run() {
+    auto start = std::chrono::steady_clock::now();
+    const AllValues& values = values_;
+    RootBoundResult result = result_;
+
+    IloEnv env;
+    try {
+        IloModel model(env);
+        LotSizingVars vars;
+        BuildLotSizingModel(env, model, values, lists_, vars);
+
+        if (values.root_bound_mode == RootBoundMode::LP) {
+            for (int g = 0; g < values.number_of_groups; ++g) {
+                model.add(IloConversion(env, vars.Y[g], ILOFLOAT));
+                model.add(IloConversion(env, vars.Lambda[g], ILOFLOAT));
+            }
+            model.add(IloConversion(env, vars.U, ILOFLOAT));
+        }
+
+        IloCplex cplex(model);
+        cplex.setParam(IloCplex::TiLim, g_deadline.Clamp(values.root_time));
+        cplex.setParam(IloCplex::Threads, result.threads);
+        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
+        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
+        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        if (values.root_bound_mode == RootBoundMode::Root) {
+            cplex.setParam(IloCplex::Param::MIP::Limits::Nodes, 0);
+        }
+        cplex.setOut(env.getNullStream());
+        cplex.setWarning(env.getNullStream());
+
+        IloCplex::Aborter aborter(env);
+        cplex.use(aborter);
+
+        // Root 模式下根节点割平面轮次正是下界来源，用户割与直接求解共用作用范围
+        std::unique_ptr<LotSizingCutCallback> cut_callback;
+        if (values.root_bound_mode == RootBoundMode::Root) {
+            cut_callback = AttachLotSizingCuts(cplex, kCutScopeDirect, env, values, lists_,
+                                               vars.X, vars.Y, vars.Lambda, vars.B,
+                                               values.machine_capacity, values.number_of_periods);
+        }
+
+        bool skip = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            skip = stop_requested_;
+            aborter_ = skip ? nullptr : &aborter;
+        }
+
+        if (!skip) {
+            cplex.solve();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            aborter_ = nullptr;
+            result.aborted = stop_requested_;
+        }
+
+        if (cut_callback) {
+            result.cuts = cut_callback->Stats().Total();
+        }
+
+        if (!skip) {
+            if (values.root_bound_mode == RootBoundMode::LP) {
+                if (cplex.getStatus() == IloAlgorithm::Optimal) {
+                    result.bound = cplex.getObjValue();
+                }
+            } else {
+                try {
+                    result.bound = cplex.getBestObjValue();
+                } catch (...) {
+                    result.bound = -1.0;
+                }
+            }
+        }
+    } catch (IloException&) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborter_ = nullptr;
+        result.bound = -1.0;
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborter_ = nullptr;
+        result.bound = -1.0;
+    }
+    env.end();
+
+    result.time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result_ = result;
+        done_ = true;
+    }
+    done_cv_.notify_all();
+}
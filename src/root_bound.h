@@ -0,0 +1,55 @@
+// root_bound.h - 后台根节点下界
+// 启发式求解期间在独立线程中求解完整模型的 LP 松弛或根节点 MIP，
+// 利用空闲核给出可证明的下界，启发式结束后并入最终 gap
+
+#ifndef ROOT_BOUND_H_
+#define ROOT_BOUND_H_
+
+#include "optimizer.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// 后台下界求解结果
+struct RootBoundResult {
+    double bound = -1.0;      // 下界 (-1 表示无)
+    double time = 0.0;        // 求解耗时 (秒)
+    int threads = 1;          // CPLEX 线程数
+    bool aborted = false;     // 是否因启发式结束被中止
+    long cuts = 0;            // 加入的用户割数 (Root 模式)
+};
+
+// 后台下界任务
+// 线程内使用独立的 IloEnv 与数据副本，与启发式不共享任何 CPLEX 对象
+class RootBoundTask {
+public:
+    RootBoundTask() = default;
+    ~RootBoundTask();
+
+    RootBoundTask(const RootBoundTask&) = delete;
+    RootBoundTask& operator=(const RootBoundTask&) = delete;
+
+    // 启动后台求解 (模式为 Off 时不启动)
+    void Start(const AllValues& values, const AllLists& lists);
+
+    // 最多等待 wait_seconds，仍未结束则中止并回收线程
+    RootBoundResult Finish(double wait_seconds);
+
+    bool Started() const { return worker_.joinable(); }
+
+private:
+    void Run();
+
+    AllValues values_;
+    AllLists lists_;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable done_cv_;
+    bool done_ = false;
+    bool stop_requested_ = false;
+    IloCplex::Aborter* aborter_ = nullptr;  // 求解期间有效，受 mutex_ 保护
+    RootBoundResult result_;
+};
+
+#endif  // ROOT_BOUND_H_
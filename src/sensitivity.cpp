@@ -0,0 +1,214 @@
+// sensitivity.cpp - 最终计划的对偶灵敏度实现
+
+#include "sensitivity.h"
+#include "logger.h"
+#include "lot_sizing_model.h"
+#include "cplex_pool.h"
+#include "deadline.h"
+
+namespace {
+
+// 读取一组行的对偶、余量与右端项区间
+void ReadRowSensitivity(IloEnv env, IloCplex& cplex, const IloRangeArray& rows, int count,
+                        vector<double>& dual, vector<double>& slack,
+                        vector<double>& rhs_low, vector<double>& rhs_high) {
+    IloNumArray duals(env, count);
+    IloNumArray low(env, count);
+    IloNumArray high(env, count);
+    cplex.getDuals(duals, rows);
+    cplex.getRHSSA(low, high, rows);
+
+    dual.assign(count, 0.0);
+    slack.assign(count, 0.0);
+    rhs_low.assign(count, 0.0);
+    rhs_high.assign(count, 0.0);
+    for (int k = 0; k < count; ++k) {
+        dual[k] = duals[k];
+        slack[k] = cplex.getSlack(rows[k]);
+        rhs_low[k] = low[k];
+        rhs_high[k] = high[k];
+    }
+    duals.end();
+    low.end();
+    high.end();
+}
+
+// 读取一组变量的检验数
+void ReadReducedCosts(IloEnv env, IloCplex& cplex, const IloNumVarArray& vars, int count,
+                      vector<double>& reduced_cost) {
+    IloNumArray costs(env, count);
+    cplex.getReducedCosts(costs, vars);
+    reduced_cost.assign(count, 0.0);
+    for (int k = 0; k < count; ++k) {
+        reduced_cost[k] = costs[k];
+    }
+    costs.end();
+}
+
+// 时间窗稀疏变量 [i][t] 只对已创建的位置读取，读数按 t 写回
+// (检验数窗口外为 0，目标系数区间窗口外为 +-1e20，输出为 null)
+void ReadWindowSensitivity(IloEnv env, IloCplex& cplex, const IloArray<IloNumVarArray>& vars,
+                           int count, int T, vector<vector<double>>* reduced_cost,
+                           vector<vector<double>>* cost_low, vector<vector<double>>* cost_high) {
+    if (reduced_cost) reduced_cost->assign(count, vector<double>(T, 0.0));
+    if (cost_low) cost_low->assign(count, vector<double>(T, -1e20));
+    if (cost_high) cost_high->assign(count, vector<double>(T, 1e20));
+    for (int i = 0; i < count; ++i) {
+        IloNumVarArray window(env);
+        vector<int> periods;
+        for (int t = 0; t < T; ++t) {
+            if (vars[i][t].getImpl()) {
+                window.add(vars[i][t]);
+                periods.push_back(t);
+            }
+        }
+        if (!periods.empty()) {
+            IloNumArray values(env), low(env), high(env);
+            if (reduced_cost) cplex.getReducedCosts(values, window);
+            if (cost_low) cplex.getObjSA(low, high, window);
+            for (size_t k = 0; k < periods.size(); ++k) {
+                if (reduced_cost) (*reduced_cost)[i][periods[k]] = values[k];
+                if (cost_low) {
+                    (*cost_low)[i][periods[k]] = low[k];
+                    (*cost_high)[i][periods[k]] = high[k];
+                }
+            }
+            values.end();
+            low.end();
+            high.end();
+        }
+        window.end();
+    }
+}
+
+}  // namespace
+
+bool ComputeSensitivity(AllValues& values, const AllLists& lists, bool carryover_clears_setup) {
+    int N = values.number_of_items;
+    int T = values.number_of_periods;
+    int F = values.number_of_flows;
+    int G = values.number_of_groups;
+    auto& m = values.metrics;
+    m.sensitivity = false;
+
+    if (lists.small_y.size() < static_cast<size_t>(G) ||
+        lists.small_l.size() < static_cast<size_t>(G) ||
+        lists.small_u.size() < static_cast<size_t>(N)) {
+        LOG("[灵敏度] 跳过 - 缺少最终计划");
+        return false;
+    }
+    for (int g = 0; g < G; ++g) {
+        if (lists.small_y[g].size() < static_cast<size_t>(T) ||
+            lists.small_l[g].size() < static_cast<size_t>(T)) {
+            LOG_FMT("[灵敏度] 跳过 - 分组 %d 周期不匹配\n", g);
+            return false;
+        }
+    }
+
+    LOG("\n[灵敏度] 固定整数变量求解 LP...");
+
+    try {
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, g_deadline.FinalBudget(values.cpx_runtime_limit));
+        IloEnv env = lease.Env();
+        IloModel model(env);
+
+        LotSizingVars vars;
+        LotSizingRows rows;
+        BuildLotSizingModel(env, model, values, lists, vars, &rows);
+        OwnLotSizingVars(lease, vars);
+
+        // y、lambda、u 固定为最终计划并转为连续变量，模型成为 LP
+        for (int g = 0; g < G; ++g) {
+            for (int t = 0; t < T; ++t) {
+                int lambda = lists.small_l[g][t];
+                int y = (carryover_clears_setup && lambda == 1) ? 0 : lists.small_y[g][t];
+                vars.Y[g][t].setBounds(y, y);
+                vars.Lambda[g][t].setBounds(lambda, lambda);
+            }
+            model.add(IloConversion(env, vars.Y[g], ILOFLOAT));
+            model.add(IloConversion(env, vars.Lambda[g], ILOFLOAT));
+        }
+        for (int i = 0; i < N; ++i) {
+            double u = lists.small_u[i] > 0.5 ? 1.0 : 0.0;
+            vars.U[i].setBounds(u, u);
+        }
+        model.add(IloConversion(env, vars.U, ILOFLOAT));
+
+        IloCplex& cplex = lease.Load(model);
+
+        auto lp_start = chrono::steady_clock::now();
+        bool solved = cplex.solve();
+        m.sensitivity_time = chrono::duration<double>(chrono::steady_clock::now() - lp_start).count();
+
+        if (!solved || cplex.getStatus() != IloAlgorithm::Optimal) {
+            LOG_FMT("[灵敏度] 固定 LP 未得到最优解 (状态=%d)，不输出灵敏度\n",
+                    static_cast<int>(cplex.getStatus()));
+            return false;
+        }
+
+        m.sensitivity_objective = cplex.getObjValue();
+
+        ReadRowSensitivity(env, cplex, rows.capacity, T,
+                           m.capacity_dual, m.capacity_slack,
+                           m.capacity_rhs_low, m.capacity_rhs_high);
+
+        m.flow_limit_dual.assign(F, vector<double>());
+        m.flow_limit_slack.assign(F, vector<double>());
+        m.flow_limit_rhs_low.assign(F, vector<double>());
+        m.flow_limit_rhs_high.assign(F, vector<double>());
+        for (int f = 0; f < F; ++f) {
+            ReadRowSensitivity(env, cplex, rows.flow_limit[f], T,
+                               m.flow_limit_dual[f], m.flow_limit_slack[f],
+                               m.flow_limit_rhs_low[f], m.flow_limit_rhs_high[f]);
+        }
+
+        m.setup_reduced_cost.assign(G, vector<double>());
+        m.carryover_reduced_cost.assign(G, vector<double>());
+        for (int g = 0; g < G; ++g) {
+            ReadReducedCosts(env, cplex, vars.Y[g], T, m.setup_reduced_cost[g]);
+            ReadReducedCosts(env, cplex, vars.Lambda[g], T, m.carryover_reduced_cost[g]);
+        }
+        ReadReducedCosts(env, cplex, vars.U, N, m.unmet_reduced_cost);
+        ReadWindowSensitivity(env, cplex, vars.X, N, T, &m.production_reduced_cost,
+                              &m.production_cost_low, &m.production_cost_high);
+        ReadWindowSensitivity(env, cplex, vars.B, N, T, nullptr,
+                              &m.backlog_cost_low, &m.backlog_cost_high);
+
+        m.sensitivity = true;
+
+        int binding_capacity = 0;
+        double best_dual = 0.0;
+        int best_period = -1;
+        for (int t = 0; t < T; ++t) {
+            if (m.capacity_dual[t] < -kEpsilon) {
+                binding_capacity++;
+                if (m.capacity_dual[t] < best_dual) {
+                    best_dual = m.capacity_dual[t];
+                    best_period = t;
+                }
+            }
+        }
+        int binding_flow = 0;
+        for (int f = 0; f < F; ++f) {
+            for (int t = 0; t < T; ++t) {
+                if (m.flow_limit_dual[f][t] < -kEpsilon) binding_flow++;
+            }
+        }
+
+        LOG_FMT("[灵敏度] LP 目标=%.2f 时间=%.3f秒\n", m.sensitivity_objective, m.sensitivity_time);
+        LOG_FMT("[灵敏度] 产能紧约束周期 %d/%d，下游能力紧约束 %d 个\n",
+                binding_capacity, T, binding_flow);
+        if (best_period >= 0) {
+            LOG_FMT("[灵敏度] 产能边际价值最高: 周期 %d，每单位产能 %.4f\n",
+                    best_period, -best_dual);
+        }
+        return true;
+
+    } catch (IloException& e) {
+        LOG_FMT("[灵敏度] CPLEX错误: %s\n", e.getMessage());
+    } catch (...) {
+        LOG("[灵敏度] 未知错误");
+    }
+    return false;
+}
@@ -0,0 +1,22 @@
+// sensitivity.h - 最终计划的对偶灵敏度
+// 最终求解 (RR 阶段3、RF/RFO 最终求解) 之后，在完整模型上把 y、lambda、u 固定为最终计划的取值
+// 并转为连续变量，重新求解这个 LP (只剩 x、b、I、P)，导出:
+//   产能行 [t]          对偶 (多 1 分钟产能的目标变化)、余量、对偶保持不变的右端项区间
+//   下游能力行 [f][t]   P_ft <= D_ft 的对偶、余量与右端项区间
+//   y / lambda / u      固定值处的检验数 (单独放开一个 setup/carryover/未满足的一阶估计)
+//   x                   生产量的检验数 (非基变量多生产 1 单位的目标变化)，
+//                       以及最优基不变的生产单价区间 (getObjSA，对应输入的 cost_x)
+//   b 的目标系数        最优基不变的欠交单价区间 (getObjSA)，调整 --b-penalty 时的可行范围
+// 右端项区间内对偶不变，产能、下游能力的 what-if 问题不需要再做 MIP 求解。
+// 结果写入 values.metrics (见 SolutionMetrics 灵敏度部分)，由结果 JSON 的 metrics.sensitivity 输出
+
+#ifndef SENSITIVITY_H_
+#define SENSITIVITY_H_
+
+#include "optimizer.h"
+
+// 以 lists.small_y / small_l / small_u 为最终计划求解固定 LP；
+// carryover_clears_setup 为 true 时 lambda=1 的周期 y 取 0 (与 RR 阶段3 的固定方式一致)
+bool ComputeSensitivity(AllValues& values, const AllLists& lists, bool carryover_clears_setup);
+
+#endif  // SENSITIVITY_H_
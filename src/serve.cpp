@@ -0,0 +1,655 @@
+// serve.cpp - 常驻求解服务实现
+//
+// 读取端 (stdin 线程或每个套接字连接一个线程) 解析请求行并放入有界队列，
+// 主线程逐个取出求解；响应经请求所属连接的写端返回 (同一连接的写入加锁)
+
+#include "serve.h"
+#include "logger.h"
+#include "cplex_pool.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include "progress.h"
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr size_t kServeInstanceCacheSize = 8;   // 保留的已读取实例数
+
+// ============================================================================
+// 请求解析: 请求行只用到扁平对象 (字符串、数字与字符串数组)
+// ============================================================================
+struct ServeRequest {
+    string id;
+    string cmd;                 // 空表示求解请求
+    string file;
+    vector<string> args;
+    double deadline = -1.0;     // < 0 表示沿用服务进程参数
+};
+
+class JsonLineReader {
+public:
+    explicit JsonLineReader(const string& text) : s_(text) {}
+
+    bool ParseRequest(ServeRequest& req, string& error) {
+        SkipSpace();
+        if (!Consume('{')) return Fail(error, "请求不是 JSON 对象");
+        SkipSpace();
+        if (Consume('}')) return true;
+        while (true) {
+            string key;
+            if (!ReadString(key)) return Fail(error, "键必须为字符串");
+            SkipSpace();
+            if (!Consume(':')) return Fail(error, "缺少 ':'");
+            SkipSpace();
+            if (key == "args") {
+                if (!ReadStringArray(req.args)) return Fail(error, "args 必须为字符串数组");
+            } else if (key == "deadline") {
+                if (!ReadNumber(req.deadline)) return Fail(error, "deadline 必须为数字");
+            } else if (key == "id" || key == "cmd" || key == "file") {
+                string value;
+                if (!ReadScalarAsString(value)) return Fail(error, key + " 必须为字符串");
+                (key == "id" ? req.id : key == "cmd" ? req.cmd : req.file) = value;
+            } else if (!SkipValue()) {
+                return Fail(error, "无法解析字段 " + key);
+            }
+            SkipSpace();
+            if (Consume(',')) {
+                SkipSpace();
+                continue;
+            }
+            if (Consume('}')) return true;
+            return Fail(error, "缺少 ',' 或 '}'");
+        }
+    }
+
+private:
+    static bool Fail(string& error, const string& message) {
+        error = message;
+        return false;
+    }
+
+    void SkipSpace() {
+        while (i_ < s_.size() && std::isspace(static_cast<unsigned char>(s_[i_]))) i_++;
+    }
+
+    bool Consume(char c) {
+        if (i_ < s_.size() && s_[i_] == c) {
+            i_++;
+            return true;
+        }
+        return false;
+    }
+
+    static int HexDigit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool ReadString(string& out) {
+        if (!Consume('"')) return false;
+        out.clear();
+        while (i_ < s_.size()) {
+            char c = s_[i_++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (i_ >= s_.size()) return false;
+            char e = s_[i_++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // 只支持 ASCII 范围的 \u00XX
+                    // 手工解析十六进制，非法转义由调用方报 Fail 而不是抛异常
+                    if (i_ + 4 > s_.size()) return false;
+                    int code = 0;
+                    for (int k = 0; k < 4; k++) {
+                        int digit = HexDigit(s_[i_++]);
+                        if (digit < 0) return false;
+                        code = code * 16 + digit;
+                    }
+                    if (code > 0x7f) return false;
+                    out += static_cast<char>(code);
+                    break;
+                }
+                default: out += e; break;   // \" \\ \/
+            }
+        }
+        return false;
+    }
+
+    bool ReadNumber(double& out) {
+        size_t start = i_;
+        while (i_ < s_.size() && (std::isdigit(static_cast<unsigned char>(s_[i_])) ||
+                                  strchr("+-.eE", s_[i_]) != nullptr)) {
+            i_++;
+        }
+        if (start == i_) return false;
+        try {
+            out = std::stod(s_.substr(start, i_ - start));
+        } catch (...) {
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadScalarAsString(string& out) {
+        if (i_ < s_.size() && s_[i_] == '"') return ReadString(out);
+        double number = 0.0;
+        size_t start = i_;
+        if (!ReadNumber(number)) return false;
+        out = s_.substr(start, i_ - start);
+        return true;
+    }
+
+    bool ReadStringArray(vector<string>& out) {
+        if (!Consume('[')) return false;
+        SkipSpace();
+        if (Consume(']')) return true;
+        while (true) {
+            string item;
+            SkipSpace();
+            if (!ReadScalarAsString(item)) return false;
+            out.push_back(item);
+            SkipSpace();
+            if (Consume(',')) continue;
+            return Consume(']');
+        }
+    }
+
+    bool SkipValue() {
+        if (i_ >= s_.size()) return false;
+        if (s_[i_] == '"') {
+            string ignored;
+            return ReadString(ignored);
+        }
+        if (s_[i_] == '[' || s_[i_] == '{') {
+            // 未知的嵌套值: 按括号深度跳过 (字符串内括号不计)
+            int depth = 0;
+            while (i_ < s_.size()) {
+                char c = s_[i_];
+                if (c == '"') {
+                    string ignored;
+                    if (!ReadString(ignored)) return false;
+                    continue;
+                }
+                if (c == '[' || c == '{') depth++;
+                if (c == ']' || c == '}') depth--;
+                i_++;
+                if (depth == 0) return true;
+            }
+            return false;
+        }
+        while (i_ < s_.size() && s_[i_] != ',' && s_[i_] != '}') i_++;
+        return true;
+    }
+
+    const string& s_;
+    size_t i_ = 0;
+};
+
+// 缩进格式的结果 JSON 压成一行 (字符串值不含换行，去掉行首缩进即可)
+string CompactJson(const string& text) {
+    string out;
+    std::istringstream in(text);
+    string line;
+    while (std::getline(in, line)) {
+        size_t start = line.find_first_not_of(' ');
+        if (start != string::npos) out += line.substr(start);
+    }
+    return out;
+}
+
+// ============================================================================
+// 响应写端
+// ============================================================================
+class ResponseSink {
+public:
+    virtual ~ResponseSink() = default;
+
+    void Send(const string& line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WriteLine(line + "\n");
+    }
+
+protected:
+    virtual void WriteLine(const string& line) = 0;
+
+private:
+    std::mutex mutex_;
+};
+
+// stdin 模式: 写入原 stdout (cout 已转向 stderr)
+class StreamSink : public ResponseSink {
+public:
+    explicit StreamSink(std::streambuf* buffer) : out_(buffer) {}
+
+protected:
+    void WriteLine(const string& line) override {
+        out_ << line;
+        out_.flush();
+    }
+
+private:
+    std::ostream out_;
+};
+
+#ifndef _WIN32
+// 套接字模式: 连接关闭后的写入直接丢弃
+class SocketSink : public ResponseSink {
+public:
+    explicit SocketSink(int fd) : fd_(fd) {}
+    ~SocketSink() override { close(fd_); }   // 最后一个持有者 (连接或排队请求) 释放时关闭
+
+protected:
+    void WriteLine(const string& line) override {
+        size_t sent = 0;
+        while (sent < line.size()) {
+            ssize_t n = send(fd_, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+
+private:
+    int fd_;
+};
+#endif
+
+// ============================================================================
+// 请求队列
+// ============================================================================
+struct ServeJob {
+    ServeRequest request;
+    std::shared_ptr<ResponseSink> sink;
+    chrono::steady_clock::time_point received;
+};
+
+class ServeQueue {
+public:
+    explicit ServeQueue(size_t capacity) : capacity_(capacity) {}
+
+    // 队列已满或已关闭时返回 false；成功时 position 为排队位置 (含正在求解的请求)
+    bool Push(ServeJob job, size_t& position) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || jobs_.size() >= capacity_) return false;
+        jobs_.push_back(std::move(job));
+        position = jobs_.size() + (running_ ? 1 : 0);
+        cv_.notify_one();
+        return true;
+    }
+
+    // 阻塞直到有请求或队列关闭且为空
+    bool Pop(ServeJob& job) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !jobs_.empty() || closed_; });
+        if (jobs_.empty()) return false;
+        job = std::move(jobs_.front());
+        jobs_.pop_front();
+        running_ = true;
+        running_id_ = job.request.id;
+        return true;
+    }
+
+    void Done() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        running_id_.clear();
+    }
+
+    // 取消: 排队中的请求直接移出 (返回 true)；正在求解的请求由调用方中断
+    bool RemoveQueued(const string& id, ServeJob& removed) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = jobs_.begin(); it != jobs_.end(); ++it) {
+            if (it->request.id == id) {
+                removed = std::move(*it);
+                jobs_.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 只匹配非空且相同的 id (无 id 的请求不能被取消)
+    bool IsRunning(const string& id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return running_ && !id.empty() && running_id_ == id;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        cv_.notify_all();
+    }
+
+    bool Closed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<ServeJob> jobs_;
+    bool running_ = false;      // 正在求解 (求解请求的 id 可以为空)
+    string running_id_;
+    bool closed_ = false;
+};
+
+// ============================================================================
+// 实例缓存: 同一路径且文件未修改时复用已读取的数据 (合并前)
+// ============================================================================
+class InstanceCache {
+public:
+    // 命中时 cached 为 true
+    bool Load(const string& path, AllValues& values, AllLists& lists, bool& cached) {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(path, ec);
+        cached = false;
+        tick_++;
+        for (auto& entry : entries_) {
+            if (entry.path == path && !ec && entry.mtime == mtime) {
+                entry.last_use = tick_;
+                values = entry.values;
+                lists = entry.lists;
+                cached = true;
+                return true;
+            }
+        }
+
+        AllValues fresh_values;
+        AllLists fresh_lists;
+        if (!LoadInstance(path, fresh_values, fresh_lists)) {
+            return false;
+        }
+        values = fresh_values;
+        lists = fresh_lists;
+        if (ec) {
+            return true;   // 取不到修改时间时不缓存
+        }
+
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                      [&](const Entry& e) { return e.path == path; }),
+                       entries_.end());
+        if (entries_.size() >= kServeInstanceCacheSize) {
+            auto oldest = std::min_element(entries_.begin(), entries_.end(),
+                                           [](const Entry& a, const Entry& b) {
+                                               return a.last_use < b.last_use;
+                                           });
+            entries_.erase(oldest);
+        }
+        entries_.push_back({path, mtime, std::move(fresh_values), std::move(fresh_lists), tick_});
+        return true;
+    }
+
+private:
+    struct Entry {
+        string path;
+        fs::file_time_type mtime;
+        AllValues values;
+        AllLists lists;
+        long last_use = 0;
+    };
+    vector<Entry> entries_;
+    long tick_ = 0;
+};
+
+// ============================================================================
+// 服务
+// ============================================================================
+class Server {
+public:
+    explicit Server(const CommandLineArgs& base_args)
+        : base_args_(base_args), queue_(static_cast<size_t>(base_args.serve_queue)) {}
+
+    // 读取端调用: 处理一行请求
+    void HandleLine(const string& line, const std::shared_ptr<ResponseSink>& sink) {
+        if (line.find_first_not_of(" \t\r") == string::npos) return;
+
+        ServeRequest req;
+        string error;
+        JsonLineReader reader(line);
+        if (!reader.ParseRequest(req, error)) {
+            sink->Send("{\"id\":\"\",\"status\":\"error\",\"error\":\"" + JsonEscape(error) + "\"}");
+            return;
+        }
+        string id = "\"id\":\"" + JsonEscape(req.id) + "\"";
+
+        if (req.cmd == "ping") {
+            sink->Send("{" + id + ",\"status\":\"pong\"}");
+        } else if (req.cmd == "cancel") {
+            ServeJob removed;
+            if (req.id.empty()) {
+                sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"cancel 需要 id\"}");
+            } else if (queue_.RemoveQueued(req.id, removed)) {
+                removed.sink->Send("{" + id + ",\"status\":\"cancelled\"}");
+            } else if (queue_.IsRunning(req.id)) {
+                g_interrupt.Request("cancel");
+            } else {
+                sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"请求不存在\"}");
+            }
+        } else if (req.cmd == "shutdown") {
+            LOG("[服务] 收到 shutdown，处理完当前请求后退出");
+            queue_.Close();
+            sink->Send("{" + id + ",\"status\":\"shutdown\"}");
+        } else if (!req.cmd.empty()) {
+            sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"未知命令 " + JsonEscape(req.cmd) + "\"}");
+        } else {
+            size_t position = 0;
+            ServeJob job{req, sink, chrono::steady_clock::now()};
+            if (!queue_.Push(std::move(job), position)) {
+                sink->Send("{" + id + ",\"status\":\"rejected\",\"reason\":\"" +
+                           (queue_.Closed() ? "shutting down" : "queue full") + "\"}");
+                return;
+            }
+            sink->Send("{" + id + ",\"status\":\"accepted\",\"queued\":" + to_string(position) + "}");
+        }
+    }
+
+    // 主线程: 逐个求解直到队列关闭且为空
+    void Run() {
+        ServeJob job;
+        while (queue_.Pop(job)) {
+            Solve(job);
+            queue_.Done();
+            if (g_interrupt.Requested() && g_interrupt.Source() == "signal") {
+                LOG("[服务] 收到信号，退出");
+                queue_.Close();
+            }
+        }
+    }
+
+    void Close() { queue_.Close(); }
+
+private:
+    void Solve(const ServeJob& job) {
+        const ServeRequest& req = job.request;
+        string id = "\"id\":\"" + JsonEscape(req.id) + "\"";
+        auto start = chrono::steady_clock::now();
+
+        // 请求参数覆盖在服务进程参数之上
+        CommandLineArgs args = base_args_;
+        args.input_file.clear();
+        if (!req.args.empty()) {
+            vector<string> storage = {"serve"};
+            storage.insert(storage.end(), req.args.begin(), req.args.end());
+            vector<char*> argv;
+            for (auto& item : storage) argv.push_back(item.data());
+            if (!ParseArgs(static_cast<int>(argv.size()), argv.data(), args)) {
+                job.sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"参数无效\"}");
+                return;
+            }
+        }
+        if (!req.file.empty()) {
+            args.input_file = req.file;
+        }
+        if (args.input_file.empty()) {
+            job.sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"缺少 file\"}");
+            return;
+        }
+
+        LOG_FMT("\n[服务] 请求 %s: %s (排队 %.3fs)\n", req.id.c_str(), args.input_file.c_str(),
+                SecondsSince(job.received));
+
+        g_interrupt.Reset();
+        g_deadline.Start(req.deadline >= 0 ? req.deadline : args.deadline);
+
+        AllValues values;
+        AllLists lists;
+        bool cached = false;
+        if (!instances_.Load(args.input_file, values, lists, cached)) {
+            job.sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"数据加载失败\"}");
+            return;
+        }
+        double load_time = SecondsSince(start);
+
+        string result;
+        try {
+            SolveSummary summary = RunSolve(args, values, lists);
+            std::ostringstream json;
+            WriteResultJson(json, args, values, lists, summary);
+            result = CompactJson(json.str());
+        } catch (const std::exception& e) {
+            job.sink->Send("{" + id + ",\"status\":\"error\",\"error\":\"" + JsonEscape(e.what()) + "\"}");
+            return;
+        }
+
+        double wall = SecondsSince(start);
+        const char* status = g_interrupt.Requested() ? "interrupted" : "completed";
+        char timing[160];
+        snprintf(timing, sizeof(timing), ",\"wall\":%.3f,\"load\":%.3f,\"instance_cached\":%s",
+                 wall, load_time, cached ? "true" : "false");
+        job.sink->Send("{" + id + ",\"status\":\"" + status + "\"" + timing + ",\"result\":" + result + "}");
+        LOG_FMT("[服务] 请求 %s %s: 墙钟 %.3fs (读数 %.3fs%s)\n", req.id.c_str(), status, wall,
+                load_time, cached ? "，实例已缓存" : "");
+    }
+
+    CommandLineArgs base_args_;
+    ServeQueue queue_;
+    InstanceCache instances_;
+};
+
+#ifndef _WIN32
+// 每个连接一个读取线程，按行切分请求；线程分离运行，共同持有 server
+void ServeConnection(std::shared_ptr<Server> server, int fd) {
+    auto sink = std::make_shared<SocketSink>(fd);
+    string pending;
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        pending.append(buffer, static_cast<size_t>(n));
+        size_t pos;
+        while ((pos = pending.find('\n')) != string::npos) {
+            server->HandleLine(pending.substr(0, pos), sink);
+            pending.erase(0, pos + 1);
+        }
+    }
+    // 排队中的请求仍持有 sink，对端关闭后的响应被丢弃
+    shutdown(fd, SHUT_RD);
+}
+#endif
+
+}  // namespace
+
+int RunServer(const CommandLineArgs& base_args) {
+    bool use_stdin = base_args.serve == "-";
+
+    // stdin 模式: stdout 只输出响应，其余输出 (日志、CPLEX、状态码) 改写到 stderr
+    std::streambuf* response_buffer = cout.rdbuf();
+    if (use_stdin) {
+        cout.rdbuf(cerr.rdbuf());
+    }
+    SetStatusOutput(false);
+
+    string log_file_path = base_args.log_file.empty() ? "./logs/serve" : base_args.log_file;
+    Logger logger(log_file_path);
+    LOG_FMT("[服务] 启动: %s 队列上限=%d\n", use_stdin ? "stdin/stdout" : base_args.serve.c_str(),
+            base_args.serve_queue);
+
+    // 信号只在请求间隙生效: 正在求解的请求以当前最好结果结束后退出
+    g_interrupt.Install(false, base_args.cancel_grace);
+    g_progress.Open(base_args.progress_fd, base_args.progress_interval);
+
+    // stdin 读取线程与连接线程分离运行 (getline/recv 无法中断)，共同持有 server
+    auto server_ptr = std::make_shared<Server>(base_args);
+    Server& server = *server_ptr;
+    std::thread reader;
+
+    if (use_stdin) {
+        auto sink = std::make_shared<StreamSink>(response_buffer);
+        reader = std::thread([server_ptr, sink]() {
+            string line;
+            while (std::getline(std::cin, line)) {
+                server_ptr->HandleLine(line, sink);
+            }
+            // stdin 结束: 处理完已排队的请求后退出
+            server_ptr->Close();
+        });
+        reader.detach();
+    } else {
+#ifdef _WIN32
+        LOG("[服务] Windows 不支持 Unix 域套接字，请使用 --serve -");
+        cout.rdbuf(response_buffer);
+        return 1;
+#else
+        int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (listen_fd < 0 || base_args.serve.size() >= sizeof(addr.sun_path)) {
+            LOG("[服务] 无法创建套接字");
+            return 1;
+        }
+        strncpy(addr.sun_path, base_args.serve.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(base_args.serve.c_str());
+        if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(listen_fd, 8) != 0) {
+            LOG_FMT("[服务] 无法监听 %s\n", base_args.serve.c_str());
+            close(listen_fd);
+            return 1;
+        }
+        reader = std::thread([server_ptr, listen_fd]() {
+            while (true) {
+                int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd < 0) break;   // 监听套接字已关闭
+                std::thread(ServeConnection, server_ptr, fd).detach();
+            }
+        });
+        server.Run();
+        shutdown(listen_fd, SHUT_RDWR);
+        close(listen_fd);
+        reader.join();
+        unlink(base_args.serve.c_str());
+#endif
+    }
+
+    if (use_stdin) {
+        server.Run();
+        cout.rdbuf(response_buffer);
+    }
+
+    LOG("[服务] 退出");
+    CplexPool::Instance().Shutdown();
+    g_interrupt.Shutdown();
+    return 0;
+}
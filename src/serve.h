@@ -0,0 +1,25 @@
+// serve.h - 常驻求解服务
+// --serve <path> 在 Unix 域套接字上监听，--serve - 使用 stdin/stdout；每行一个 JSON 请求:
+//   {"id":"r1","file":"data.csv","args":["--algo=RFO","-t","60"],"deadline":30}
+//   {"id":"r1","cmd":"cancel"}      中止正在求解或仍在排队的请求 (id 必填，无 id 的请求不能取消)
+//   {"cmd":"shutdown"}              处理完当前请求后退出
+//   {"id":"p","cmd":"ping"}
+// args 按命令行语法在服务进程参数之上覆盖，deadline 为本请求的墙钟上限 (秒)。
+// 每个请求依次返回 accepted 与最终结果两行响应:
+//   {"id":"r1","status":"accepted","queued":1}
+//   {"id":"r1","status":"completed","wall":3.214,"load":0.002,"instance_cached":true,"result":{...}}
+// status 还可能是 interrupted / error / rejected (队列已满) / cancelled (排队中被取消)。
+//
+// 进程常驻期间保留 CPLEX 环境池与已读取的实例 (按路径与修改时间缓存)，
+// 请求不再重新解析 CSV、创建环境或写结果文件。请求按到达顺序串行求解，
+// 队列长度由 --serve-queue 限制。stdin 模式下日志改写到 stderr，stdout 只输出响应
+
+#ifndef SERVE_H_
+#define SERVE_H_
+
+#include "solve_driver.h"
+
+// 运行服务直到 shutdown、stdin 结束或收到信号，返回进程退出码
+int RunServer(const CommandLineArgs& base_args);
+
+#endif  // SERVE_H_
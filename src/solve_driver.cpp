@@ -0,0 +1,1090 @@
+// solve_driver.cpp - 单次求解流程实现
+
+#include "solve_driver.h"
+#include "logger.h"
+#include "plan_state.h"
+#include "lagrangian_bound.h"
+#include "root_bound.h"
+#include "lot_sizing_cuts.h"
+#include "cplex_pool.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include "progress.h"
+#include "replan.h"
+#include "sensitivity.h"
+#include "config_file.h"
+#include "cplex_params.h"
+
+// ============================================================================
+// 帮助信息
+// ============================================================================
+void PrintUsage(const char* program) {
+    cout << "Usage: " << program << " [options] [data_file]\n";
+    cout << "\nAlgorithm Selection:\n";
+    cout << "  --algo=RF           Relax-and-Fix (default)\n";
+    cout << "  --algo=RFO          RF + Fix-and-Optimize\n";
+    cout << "  --algo=RR           Relax-and-Recover 3-stage decomposition\n";
+    cout << "\nBasic Options:\n";
+    cout << "  -f, --file <path>       Input data file\n";
+    cout << "  -o, --output <dir>      Output directory (default: ./results)\n";
+    cout << "  -l, --log <file>        Log file path (default: ./logs/solve.log)\n";
+    cout << "  -t, --time <seconds>    CPLEX time limit (default: 30)\n";
+    cout << "  --deadline <seconds>    Wall-clock deadline for the whole run, 0=off (default: 0)\n";
+    cout << "  --stdin-control         Accept \"cancel\" on stdin to stop with the best plan so far\n";
+    cout << "  --cancel-grace <double> Time limit per completion solve after cancel (default: 10.0)\n";
+    cout << "  --progress-fd <fd>      Stream JSON progress events to this file descriptor (default: off)\n";
+    cout << "  --progress-interval <s> Minimum seconds between rate-limited progress events (default: 0.5)\n";
+    cout << "  --u-penalty <int>       Unmet demand penalty (default: 10000)\n";
+    cout << "  --b-penalty <int>       Backorder penalty (default: 100)\n";
+    cout << "  --threshold <double>    Big order threshold (default: 1000)\n";
+    cout << "  --no-merge              Disable order merging\n";
+    cout << "  --capacity <int>        Machine capacity per period (default: 1440)\n";
+    cout << "\nCPLEX Options:\n";
+    cout << "  --cplex-workdir <path>  CPLEX work directory (default: D:\\CPLEX_Temp)\n";
+    cout << "  --cplex-workmem <MB>    CPLEX work memory limit (default: 4096)\n";
+    cout << "  --cplex-threads <num>   CPLEX thread count, 0=auto (default: 0)\n";
+    cout << "\nRF Algorithm Options:\n";
+    cout << "  --rf-window <int>       RF window size (default: 6)\n";
+    cout << "  --rf-step <int>         RF fix step (default: 1)\n";
+    cout << "  --rf-time <double>      RF subproblem time limit (default: 60.0)\n";
+    cout << "  --rf-retries <int>      RF max retries (default: 3)\n";
+    cout << "  --no-rf-cache           Disable RF subproblem result cache\n";
+    cout << "  --rf-retry <mode>       RF window retries: seq|par|par-rollback (default: seq)\n";
+    cout << "  --rf-speculate <depth>  Speculative RF look-ahead windows, 0=off (default: 0)\n";
+    cout << "\nFO Algorithm Options (for RFO):\n";
+    cout << "  --fo-window <int>       FO window size (default: 8)\n";
+    cout << "  --fo-step <int>         FO step size (default: 3)\n";
+    cout << "  --fo-rounds <int>       FO max rounds (default: 2)\n";
+    cout << "  --fo-buffer <int>       FO boundary buffer (default: 1)\n";
+    cout << "  --fo-time <double>      FO subproblem time limit (default: 30.0)\n";
+    cout << "\nRR Algorithm Options:\n";
+    cout << "  --rr-capacity <double>  RR capacity expansion factor (default: 1.2)\n";
+    cout << "  --rr-bonus <double>     RR consecutive startup bonus (default: 50.0)\n";
+    cout << "\nLower Bound Options:\n";
+    cout << "  --lr-iters <int>        Lagrangian bound subgradient iterations, 0=off (default: 200)\n";
+    cout << "  --lr-threads <int>      Lagrangian bound threads, 0=auto (default: 0)\n";
+    cout << "  --root-bound <mode>     Background full-model bound: off|lp|root (default: off)\n";
+    cout << "  --root-time <double>    Background bound time limit (default: 60.0)\n";
+    cout << "  --root-threads <int>    Background bound threads, 0=spare cores (default: 0)\n";
+    cout << "  --root-wait <double>    Max wait for background bound after solve (default: 0)\n";
+    cout << "\nModel Options:\n";
+    cout << "  --exclusivity <form>    Carryover exclusivity rows: agg|pair (default: agg)\n";
+    cout << "  --big-m <mode>          Family setup Big-M: tight|cap (default: tight)\n";
+    cout << "  --item-vub              Add item bounds x_it <= d_i*(y_gt+lambda_gt)\n";
+    cout << "  --user-cuts <scope>     Lot-sizing user cuts: off|all|direct,rf,fo,rr (default: off)\n";
+    cout << "\nService Mode:\n";
+    cout << "  --serve <path|->        Serve JSON-line solve requests on a Unix socket or stdin/stdout\n";
+    cout << "  --serve-queue <int>     Max queued requests in service mode (default: 16)\n";
+    cout << "\nRolling Re-planning:\n";
+    cout << "  --replan <json>         Previous result JSON to warm-start from (implies --algo=RFO)\n";
+    cout << "  --replan-delta <path>   Instance delta applied to the data file (shift/frozen/orders)\n";
+    cout << "  --replan-frozen <int>   Leading periods kept from the previous plan (default: from delta)\n";
+    cout << "\nCoefficient Sweep:\n";
+    cout << "  --sweep <csv>           Solve capacity/penalty variants on one built model per worker\n";
+    cout << "  --sweep-workers <int>   Parallel worker environments, 0=auto (default: 0)\n";
+    cout << "\nParameter Profiles & Tuning:\n";
+    cout << "  --profile <ini>         Load parameters from a profile section before the command line\n";
+    cout << "  --profile-class <name>  Profile section (instance class) to load (default: default)\n";
+    cout << "  --tune <dir|list>       Race candidate RF/FO/RR parameters over an instance set\n";
+    cout << "  --tune-configs <int>    Candidate configurations incl. the current one (default: 16)\n";
+    cout << "  --tune-workers <int>    Parallel solver processes, 0=auto (default: 0)\n";
+    cout << "  --tune-seed <int>       Candidate sampling seed (default: 1)\n";
+    cout << "\nSubproblem Dump:\n";
+    cout << "  --dump-subproblems <dir>\n";
+    cout << "                          Export every RF/FO/RR subproblem and direct model with a JSON sidecar\n";
+    cout << "                          (see LS-NTGF-Replay)\n";
+    cout << "  --dump-format <fmt>     Dump model format: lp|mps|sav (default: lp)\n";
+    cout << "\nCPLEX Parameters:\n";
+    cout << "  --cplex-profiles <ini>  Per-phase CPLEX parameter profiles (rf_window, rf_final,\n";
+    cout << "                          fo_window, fo_final, rr_step1-3, direct; see LS-NTGF-Replay\n";
+    cout << "                          --tune-param)\n";
+    cout << "\nRegression Suite:\n";
+    cout << "  --regress <ini>         Solve a pinned instance suite and compare with stored baselines\n";
+    cout << "  --regress-record        Write this run's results to the suite baseline\n";
+    cout << "  --regress-algo <list>   Only run the listed algorithms, e.g. RF,RFO (default: suite)\n";
+    cout << "  --regress-strict        Treat cases missing from the baseline as regressions\n";
+    cout << "  --regress-options <s>   Extra child arguments appended to the suite options\n";
+    cout << "\nOther Options:\n";
+    cout << "  --sensitivity           Report duals/ranging of the final fixed-setup LP in the result JSON\n";
+    cout << "  --bench-moves <int>     Benchmark incremental move evaluation on the final plan (default: 0=off)\n";
+    cout << "  -h, --help              Show this help message\n";
+    cout << "\nExamples:\n";
+    cout << "  " << program << " --algo=RF data.csv\n";
+    cout << "  " << program << " --algo=RFO -t 60 --rf-window 8 data.csv\n";
+    cout << "  " << program << " --algo=RR --rr-capacity 1.5 data.csv\n";
+}
+
+// ============================================================================
+// 解析命令行参数
+// ============================================================================
+bool ParseArgs(int argc, char* argv[], CommandLineArgs& args) {
+    // 参数配置文件先于命令行生效 (与出现位置无关)
+    bool has_profile = false;
+    for (int i = 1; i + 1 < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--profile") {
+            args.profile = argv[++i];
+            has_profile = true;
+        } else if (arg == "--profile-class") {
+            args.profile_class = argv[++i];
+        }
+    }
+    if (has_profile && !ApplyParamProfile(args.profile, args.profile_class, args)) {
+        return false;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            args.show_help = true;
+            return true;
+        } else if (arg.rfind("--algo=", 0) == 0) {
+            string algo_str = arg.substr(7);
+            if (algo_str == "RF" || algo_str == "rf") {
+                args.algorithm = AlgorithmType::RF;
+            } else if (algo_str == "RFO" || algo_str == "rfo") {
+                args.algorithm = AlgorithmType::RFO;
+            } else if (algo_str == "RR" || algo_str == "rr") {
+                args.algorithm = AlgorithmType::RR;
+            } else {
+                cerr << "Unknown algorithm: " << algo_str << "\n";
+                cerr << "Valid options: RF, RFO, RR\n";
+                return false;
+            }
+        } else if ((arg == "-f" || arg == "--file") && i + 1 < argc) {
+            args.input_file = argv[++i];
+        } else if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            args.output_dir = argv[++i];
+        } else if ((arg == "-l" || arg == "--log") && i + 1 < argc) {
+            args.log_file = argv[++i];
+        } else if ((arg == "-t" || arg == "--time") && i + 1 < argc) {
+            args.time_limit = atof(argv[++i]);
+        } else if (arg == "--deadline" && i + 1 < argc) {
+            args.deadline = atof(argv[++i]);
+        } else if (arg == "--stdin-control") {
+            args.stdin_control = true;
+        } else if (arg == "--cancel-grace" && i + 1 < argc) {
+            args.cancel_grace = atof(argv[++i]);
+        } else if (arg == "--progress-fd" && i + 1 < argc) {
+            args.progress_fd = atoi(argv[++i]);
+        } else if (arg == "--progress-interval" && i + 1 < argc) {
+            args.progress_interval = atof(argv[++i]);
+        } else if (arg == "--serve" && i + 1 < argc) {
+            args.serve = argv[++i];
+        } else if (arg == "--serve-queue" && i + 1 < argc) {
+            args.serve_queue = max(1, atoi(argv[++i]));
+        } else if (arg == "--replan" && i + 1 < argc) {
+            args.replan = argv[++i];
+        } else if (arg == "--replan-delta" && i + 1 < argc) {
+            args.replan_delta = argv[++i];
+        } else if (arg == "--replan-frozen" && i + 1 < argc) {
+            args.replan_frozen = max(0, atoi(argv[++i]));
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            args.sweep = argv[++i];
+        } else if (arg == "--sweep-workers" && i + 1 < argc) {
+            args.sweep_workers = max(0, atoi(argv[++i]));
+        } else if (arg == "--u-penalty" && i + 1 < argc) {
+            args.u_penalty = atoi(argv[++i]);
+        } else if (arg == "--b-penalty" && i + 1 < argc) {
+            args.b_penalty = atoi(argv[++i]);
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            args.big_order_threshold = atof(argv[++i]);
+        } else if (arg == "--no-merge") {
+            args.enable_merge = false;
+        } else if (arg == "--cplex-workdir" && i + 1 < argc) {
+            args.cplex_workdir = argv[++i];
+        } else if (arg == "--cplex-workmem" && i + 1 < argc) {
+            args.cplex_workmem = atoi(argv[++i]);
+        } else if (arg == "--cplex-threads" && i + 1 < argc) {
+            args.cplex_threads = atoi(argv[++i]);
+        } else if (arg == "--capacity" && i + 1 < argc) {
+            args.machine_capacity = atoi(argv[++i]);
+        } else if (arg == "--rf-window" && i + 1 < argc) {
+            args.rf_window = atoi(argv[++i]);
+        } else if (arg == "--rf-step" && i + 1 < argc) {
+            args.rf_step = atoi(argv[++i]);
+        } else if (arg == "--rf-time" && i + 1 < argc) {
+            args.rf_time = atof(argv[++i]);
+        } else if (arg == "--rf-retries" && i + 1 < argc) {
+            args.rf_retries = atoi(argv[++i]);
+        } else if (arg == "--no-rf-cache") {
+            args.rf_cache = false;
+        } else if (arg == "--rf-speculate" && i + 1 < argc) {
+            args.rf_speculate = max(0, atoi(argv[++i]));
+        } else if (arg == "--rf-retry" && i + 1 < argc) {
+            string retry_str = argv[++i];
+            if (retry_str == "seq") {
+                args.rf_retry = RFRetryMode::Sequential;
+            } else if (retry_str == "par") {
+                args.rf_retry = RFRetryMode::Parallel;
+            } else if (retry_str == "par-rollback") {
+                args.rf_retry = RFRetryMode::ParallelRollback;
+            } else {
+                cerr << "Unknown RF retry mode: " << retry_str << "\n";
+                cerr << "Valid options: seq, par, par-rollback\n";
+                return false;
+            }
+        } else if (arg == "--fo-window" && i + 1 < argc) {
+            args.fo_window = atoi(argv[++i]);
+        } else if (arg == "--fo-step" && i + 1 < argc) {
+            args.fo_step = atoi(argv[++i]);
+        } else if (arg == "--fo-rounds" && i + 1 < argc) {
+            args.fo_rounds = atoi(argv[++i]);
+        } else if (arg == "--fo-buffer" && i + 1 < argc) {
+            args.fo_buffer = atoi(argv[++i]);
+        } else if (arg == "--fo-time" && i + 1 < argc) {
+            args.fo_time = atof(argv[++i]);
+        } else if (arg == "--rr-capacity" && i + 1 < argc) {
+            args.rr_capacity = atof(argv[++i]);
+        } else if (arg == "--rr-bonus" && i + 1 < argc) {
+            args.rr_bonus = atof(argv[++i]);
+        } else if (arg == "--lr-iters" && i + 1 < argc) {
+            args.lr_iterations = atoi(argv[++i]);
+        } else if (arg == "--lr-threads" && i + 1 < argc) {
+            args.lr_threads = atoi(argv[++i]);
+        } else if (arg == "--root-bound" && i + 1 < argc) {
+            string mode_str = argv[++i];
+            if (mode_str == "off") {
+                args.root_bound = RootBoundMode::Off;
+            } else if (mode_str == "lp" || mode_str == "LP") {
+                args.root_bound = RootBoundMode::LP;
+            } else if (mode_str == "root" || mode_str == "ROOT") {
+                args.root_bound = RootBoundMode::Root;
+            } else {
+                cerr << "Unknown root bound mode: " << mode_str << "\n";
+                cerr << "Valid options: off, lp, root\n";
+                return false;
+            }
+        } else if (arg == "--root-time" && i + 1 < argc) {
+            args.root_time = atof(argv[++i]);
+        } else if (arg == "--root-threads" && i + 1 < argc) {
+            args.root_threads = atoi(argv[++i]);
+        } else if (arg == "--root-wait" && i + 1 < argc) {
+            args.root_wait = atof(argv[++i]);
+        } else if (arg == "--exclusivity" && i + 1 < argc) {
+            string form_str = argv[++i];
+            if (form_str == "agg") {
+                args.aggregate_exclusivity = true;
+            } else if (form_str == "pair") {
+                args.aggregate_exclusivity = false;
+            } else {
+                cerr << "Unknown exclusivity form: " << form_str << "\n";
+                cerr << "Valid options: agg, pair\n";
+                return false;
+            }
+        } else if (arg == "--big-m" && i + 1 < argc) {
+            string big_m_str = argv[++i];
+            if (big_m_str == "tight") {
+                args.tight_big_m = true;
+            } else if (big_m_str == "cap") {
+                args.tight_big_m = false;
+            } else {
+                cerr << "Unknown Big-M mode: " << big_m_str << "\n";
+                cerr << "Valid options: tight, cap\n";
+                return false;
+            }
+        } else if (arg == "--item-vub") {
+            args.item_vub = true;
+        } else if (arg == "--user-cuts" && i + 1 < argc) {
+            string scope_str = argv[++i];
+            if (!ParseCutScope(scope_str, args.user_cut_scope)) {
+                cerr << "Unknown user cut scope: " << scope_str << "\n";
+                cerr << "Valid options: off, all, or a comma list of direct, rf, fo, rr\n";
+                return false;
+            }
+        } else if (arg == "--bench-moves" && i + 1 < argc) {
+            args.bench_moves = atol(argv[++i]);
+        } else if (arg == "--sensitivity") {
+            args.sensitivity = true;
+        } else if ((arg == "--profile" || arg == "--profile-class") && i + 1 < argc) {
+            ++i;  // 已在上面处理
+        } else if (arg == "--tune" && i + 1 < argc) {
+            args.tune = argv[++i];
+        } else if (arg == "--tune-configs" && i + 1 < argc) {
+            args.tune_configs = max(1, atoi(argv[++i]));
+        } else if (arg == "--tune-workers" && i + 1 < argc) {
+            args.tune_workers = max(0, atoi(argv[++i]));
+        } else if (arg == "--tune-seed" && i + 1 < argc) {
+            args.tune_seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--dump-subproblems" && i + 1 < argc) {
+            args.dump_subproblems = argv[++i];
+        } else if (arg == "--dump-format" && i + 1 < argc) {
+            args.dump_format = argv[++i];
+            if (args.dump_format != "lp" && args.dump_format != "mps" && args.dump_format != "sav") {
+                cerr << "Unknown dump format: " << args.dump_format << "\n";
+                cerr << "Valid options: lp, mps, sav\n";
+                return false;
+            }
+        } else if (arg == "--cplex-profiles" && i + 1 < argc) {
+            args.cplex_profiles = argv[++i];
+            if (!ReadCplexPhaseProfiles(args.cplex_profiles, args.cplex_phase_profiles)) {
+                return false;
+            }
+        } else if (arg == "--regress" && i + 1 < argc) {
+            args.regress = argv[++i];
+        } else if (arg == "--regress-record") {
+            args.regress_record = true;
+        } else if (arg == "--regress-algo" && i + 1 < argc) {
+            args.regress_algo = argv[++i];
+        } else if (arg == "--regress-strict") {
+            args.regress_strict = true;
+        } else if (arg == "--regress-options" && i + 1 < argc) {
+            args.regress_options = argv[++i];
+        } else if (arg[0] != '-' && args.input_file.empty()) {
+            // 位置参数作为输入文件
+            args.input_file = arg;
+        } else {
+            cerr << "Unknown option: " << arg << "\n";
+            return false;
+        }
+    }
+    // 重排程在暖启动计划上执行 RFO 的 FO 阶段
+    if (!args.replan.empty()) {
+        args.algorithm = AlgorithmType::RFO;
+    }
+    return true;
+}
+
+bool ApplyParamProfile(const string& path, const string& section, CommandLineArgs& args) {
+    vector<ConfigSection> sections;
+    if (!ReadConfigFile(path, sections)) {
+        return false;
+    }
+    string name = section.empty() ? "default" : section;
+    const ConfigSection* chosen = FindConfigSection(sections, name);
+    if (chosen == nullptr) {
+        cerr << "Profile section [" << name << "] not found in " << path << "\n";
+        return false;
+    }
+
+    // 匿名节 (全局键) 在前，选中的节在后，转换为命令行参数交给 ParseArgs
+    vector<string> tokens = {"profile"};
+    for (const ConfigSection* part : {FindConfigSection(sections, ""), chosen}) {
+        if (part == nullptr) continue;
+        for (const auto& [key, value] : part->entries) {
+            if (key.rfind("profile", 0) == 0 || key.rfind("tune", 0) == 0 ||
+                key.rfind("regress", 0) == 0) {
+                cerr << "Profile key not allowed: " << key << "\n";
+                return false;
+            }
+            string flag = "--" + key;
+            std::replace(flag.begin(), flag.end(), '_', '-');
+            if (key == "algo") {
+                tokens.push_back(flag + "=" + value);
+            } else if (value == "true") {
+                tokens.push_back(flag);
+            } else if (value != "false") {
+                tokens.push_back(flag);
+                tokens.push_back(value);
+            }
+        }
+    }
+
+    vector<char*> argv;
+    for (auto& token : tokens) argv.push_back(token.data());
+    return ParseArgs(static_cast<int>(argv.size()), argv.data(), args);
+}
+
+// ============================================================================
+// 输出状态码 (供 GUI 解析)
+// ============================================================================
+static bool g_status_output = true;
+
+void SetStatusOutput(bool enabled) {
+    g_status_output = enabled;
+}
+
+void EmitStatus(const string& status) {
+    if (!g_status_output) {
+        return;
+    }
+    cout << status << endl;
+    cout.flush();
+}
+
+// ============================================================================
+// 计算下界 (供 gap 使用)
+// Lagrangian 下界先算，期间后台根节点下界继续运行
+// ============================================================================
+void EvaluateLowerBound(AllValues& values, const AllLists& lists, double objective,
+                        RootBoundTask& root_task) {
+    auto& m = values.metrics;
+
+    if (values.lr_iterations > 0 && objective >= 0) {
+        LagrangianResult lr = SolveLagrangianBound(values, lists, objective);
+        m.lr_bound = lr.bound;
+        m.lr_iterations = lr.iterations;
+        m.lr_time = lr.time;
+        m.lower_bound = max(m.lower_bound, lr.bound);
+    }
+
+    if (root_task.Started()) {
+        double wait = g_interrupt.Requested() ? 0.0 : min(values.root_wait, g_deadline.Remaining());
+        RootBoundResult root = root_task.Finish(wait);
+        m.root_bound = root.bound;
+        m.root_time = root.time;
+        m.lower_bound = max(m.lower_bound, root.bound);
+    }
+}
+
+// ============================================================================
+// 读取实例
+// ============================================================================
+bool LoadInstance(const string& path, AllValues& values, AllLists& lists) {
+    LOG_FMT("[读取] 加载数据: %s\n", path.c_str());
+    ReadData(values, lists, path);
+
+    if (values.number_of_items <= 0) {
+        LOG("[错误] 数据加载失败");
+        return false;
+    }
+
+    LOG_FMT("[数据] 订单=%d 周期=%d 流向=%d 分组=%d\n",
+            values.number_of_items, values.number_of_periods,
+            values.number_of_flows, values.number_of_groups);
+    return true;
+}
+
+// ============================================================================
+// 应用参数
+// ============================================================================
+void ApplyArgs(const CommandLineArgs& args, AllValues& values) {
+    values.cpx_runtime_limit = args.time_limit;
+    values.u_penalty = args.u_penalty;
+    values.b_penalty = args.b_penalty;
+    values.big_order_threshold = args.big_order_threshold;
+    values.cplex_workdir = args.cplex_workdir;
+    values.cplex_workmem = args.cplex_workmem;
+    values.cplex_threads = args.cplex_threads;
+    values.output_dir = args.output_dir;
+    values.input_file = args.input_file;
+    values.algorithm_name = AlgorithmName(args.algorithm);
+    // Machine capacity (override if specified)
+    if (args.machine_capacity > 0) {
+        values.machine_capacity = args.machine_capacity;
+    }
+    // RF algorithm parameters
+    values.rf_window = args.rf_window;
+    values.rf_step = args.rf_step;
+    values.rf_time = args.rf_time;
+    values.rf_retries = args.rf_retries;
+    values.rf_cache = args.rf_cache;
+    values.rf_retry_mode = args.rf_retry;
+    values.rf_speculate = args.rf_speculate;
+    // FO algorithm parameters
+    values.fo_window = args.fo_window;
+    values.fo_step = args.fo_step;
+    values.fo_rounds = args.fo_rounds;
+    values.fo_buffer = args.fo_buffer;
+    values.fo_time = args.fo_time;
+    // RR algorithm parameters
+    values.rr_capacity = args.rr_capacity;
+    values.rr_bonus = args.rr_bonus;
+    // Lower bound parameters
+    values.lr_iterations = args.lr_iterations;
+    values.lr_threads = args.lr_threads;
+    values.root_bound_mode = args.root_bound;
+    values.root_time = args.root_time;
+    values.root_threads = args.root_threads;
+    values.root_wait = args.root_wait;
+    // Model formulation
+    values.aggregate_exclusivity = args.aggregate_exclusivity;
+    values.tight_big_m = args.tight_big_m;
+    values.item_vub = args.item_vub;
+    values.user_cut_scope = args.user_cut_scope;
+    // Subproblem dump
+    values.dump_dir = args.dump_subproblems;
+    values.dump_format = args.dump_format;
+    // CPLEX phase profiles
+    values.cplex_phase_profiles = args.cplex_phase_profiles;
+}
+
+// ============================================================================
+// 求解: 合并 -> 算法 -> 下界
+// ============================================================================
+SolveSummary RunSolve(const CommandLineArgs& args, AllValues& values, AllLists& lists) {
+    ApplyArgs(args, values);
+    LogCplexPhaseProfiles(values);
+
+    clock_t case_start = clock();
+
+    // 滚动重排程: 在旧算例上应用增量并映射旧计划 (合并前)
+    ReplanContext replan;
+    if (!args.replan.empty() && !PrepareReplan(args, values, lists, replan)) {
+        return SolveSummary();
+    }
+
+    // 大订单合并 (可选)
+    int original_items = values.number_of_items;
+    if (args.enable_merge) {
+        LOG("[合并] 合并订单（流向-分组策略）...");
+        UpdateBigOrderFG(values, lists);
+        LOG_FMT("[合并] 完成: %d -> %d 订单\n", original_items, values.number_of_items);
+        EmitStatus("[MERGE:" + to_string(original_items) + ":" +
+                   to_string(values.number_of_items) + "]");
+    } else {
+        LOG("[合并] 跳过订单合并");
+        EmitStatus("[MERGE:SKIP]");
+    }
+
+    // 后台根节点下界 (可选，使用合并后的数据副本)
+    RootBoundTask root_task;
+    root_task.Start(values, lists);
+
+    // 根据选择的算法执行求解
+    LOG_FMT("[求解] 执行 %s 算法...\n", AlgorithmName(args.algorithm));
+
+    switch (args.algorithm) {
+        case AlgorithmType::RF:
+            EmitStatus("[STAGE:1:START]");
+            SolveRF(values, lists);
+            EvaluateLowerBound(values, lists, values.result_step1.objective, root_task);
+            values.result_step1.gap = RelativeGap(values.result_step1.objective,
+                                                  values.metrics.lower_bound);
+            EmitStatus("[STAGE:1:DONE:" +
+                       to_string(values.result_step1.objective) + ":" +
+                       to_string(values.result_step1.runtime) + ":" +
+                       to_string(values.result_step1.gap) + "]");
+            break;
+
+        case AlgorithmType::RFO:
+            EmitStatus("[STAGE:1:START]");
+            if (!args.replan.empty()) {
+                SolveReplan(values, lists, replan.warm);
+                EvaluateReplanChanges(replan, values, lists);
+            } else {
+                SolveRFO(values, lists);
+            }
+            EvaluateLowerBound(values, lists, values.result_step1.objective, root_task);
+            values.result_step1.gap = RelativeGap(values.result_step1.objective,
+                                                  values.metrics.lower_bound);
+            EmitStatus("[STAGE:1:DONE:" +
+                       to_string(values.result_step1.objective) + ":" +
+                       to_string(values.result_step1.runtime) + ":" +
+                       to_string(values.result_step1.gap) + "]");
+            break;
+
+        case AlgorithmType::RR:
+            // RR (Relax-and-Recover) 三阶段求解
+            EmitStatus("[STAGE:1:START]");
+            g_progress.SetPhase("RR1");
+            SolveStep1(values, lists);
+            EmitStatus("[STAGE:1:DONE:" +
+                       to_string(values.result_step1.objective) + ":" +
+                       to_string(values.result_step1.runtime) + ":" +
+                       to_string(values.result_step1.gap) + "]");
+
+            EmitStatus("[STAGE:2:START]");
+            g_progress.SetPhase("RR2");
+            SolveStep2(values, lists);
+            EmitStatus("[STAGE:2:DONE:" +
+                       to_string(values.result_step2.objective) + ":" +
+                       to_string(values.result_step2.runtime) + ":" +
+                       to_string(values.result_step2.gap) + "]");
+
+            EmitStatus("[STAGE:3:START]");
+            g_progress.SetPhase("RR3");
+            SolveStep3(values, lists);
+            EmitStatus("[STAGE:3:DONE:" +
+                       to_string(values.result_step3.objective) + ":" +
+                       to_string(values.result_step3.runtime) + ":" +
+                       to_string(values.result_step3.gap) + "]");
+
+            // Stage 3 的 gap 仅针对固定 setup 后的受限模型，汇总 gap 以下界计算
+            EvaluateLowerBound(values, lists, values.result_step3.objective, root_task);
+            break;
+    }
+
+    // 最终计划的对偶灵敏度 (可选，固定整数变量后的 LP)
+    if (args.sensitivity && !g_interrupt.Requested()) {
+        double plan_objective = args.algorithm == AlgorithmType::RR
+            ? values.result_step3.objective : values.result_step1.objective;
+        if (plan_objective >= 0) {
+            ComputeSensitivity(values, lists, args.algorithm == AlgorithmType::RR);
+        }
+    }
+
+    g_progress.SetPhase("DONE");
+
+    // 子问题环境池统计 (进程内累计，服务模式下包含之前的请求)
+    RecordCplexPoolStats(values);
+
+    // 计算总耗时
+    clock_t case_end = clock();
+    double total_duration = static_cast<double>(case_end - case_start) / CLOCKS_PER_SEC;
+
+    // 获取最终结果
+    double final_objective = -1.0;
+    double final_runtime = -1.0;
+    double final_gap = -1.0;
+
+    switch (args.algorithm) {
+        case AlgorithmType::RF:
+        case AlgorithmType::RFO:
+            final_objective = values.result_step1.objective;
+            final_runtime = values.result_step1.runtime;
+            break;
+        case AlgorithmType::RR:
+            final_objective = values.result_step3.objective;
+            final_runtime = values.result_step1.runtime + values.result_step2.runtime
+                          + values.result_step3.runtime;
+            break;
+    }
+    final_gap = RelativeGap(final_objective, values.metrics.lower_bound);
+
+    // 输出结果
+    LOG("\n========================================");
+    LOG("  求解结果汇总");
+    LOG("========================================");
+    LOG_FMT("  算法:     %s\n", AlgorithmName(args.algorithm));
+    if (g_interrupt.Requested()) {
+        LOG("  状态:     已中断 (当前最好计划)");
+    }
+    LOG_FMT("  目标值:   %.2f\n", final_objective);
+    LOG_FMT("  求解时间: %.3fs\n", final_runtime);
+    LOG_FMT("  总耗时:   %.3fs\n", total_duration);
+    LOG_FMT("  下界:     %.2f\n", values.metrics.lower_bound);
+    LOG_FMT("  Gap:      %.4f\n", final_gap);
+    LOG("========================================");
+
+    // 邻域移动增量评价基准 (可选)
+    if (args.bench_moves > 0 && final_objective >= 0) {
+        BenchmarkPlanState(values, lists, args.bench_moves);
+    }
+
+    SolveSummary summary;
+    summary.objective = final_objective;
+    summary.runtime = final_runtime;
+    summary.gap = final_gap;
+    summary.total_time = total_duration;
+    return summary;
+}
+
+// ============================================================================
+// 结果 JSON
+// ============================================================================
+
+// 灵敏度数组 (单行)；右端项区间无界时 CPLEX 返回 +-1e20 以上，输出 null
+static void WriteSensitivityArray(ostream& out, const vector<double>& data) {
+    out << "[";
+    for (size_t k = 0; k < data.size(); k++) {
+        if (fabs(data[k]) >= 1e20) {
+            out << "null";
+        } else {
+            out << data[k];
+        }
+        if (k + 1 < data.size()) out << ", ";
+    }
+    out << "]";
+}
+
+// 灵敏度矩阵 (每行一个数组)
+static void WriteSensitivityMatrix(ostream& out, const vector<vector<double>>& data,
+                                   const char* indent) {
+    out << "[\n";
+    for (size_t r = 0; r < data.size(); r++) {
+        out << indent << "  ";
+        WriteSensitivityArray(out, data[r]);
+        if (r + 1 < data.size()) out << ",";
+        out << "\n";
+    }
+    out << indent << "]";
+}
+
+void WriteResultJson(ostream& out, const CommandLineArgs& args, const AllValues& values,
+                     const AllLists& lists, const SolveSummary& summary) {
+    out << fixed;
+    out << "{\n";
+    out << "  \"summary\": {\n";
+    out << "    \"algorithm\": \"" << AlgorithmName(args.algorithm) << "\",\n";
+    out << "    \"status\": \"" << (g_interrupt.Requested() ? "interrupted" : "completed") << "\",\n";
+    out << "    \"input_file\": \"" << JsonEscape(args.input_file) << "\",\n";
+    out << setprecision(2);
+    out << "    \"objective\": " << summary.objective << ",\n";
+    out << setprecision(3);
+    out << "    \"total_time\": " << summary.total_time << ",\n";
+    out << "    \"solve_time\": " << summary.runtime << ",\n";
+    out << setprecision(2);
+    out << "    \"lower_bound\": " << values.metrics.lower_bound << ",\n";
+    out << setprecision(6);
+    out << "    \"gap\": " << summary.gap;
+    if (g_deadline.Enabled()) {
+        out << setprecision(3);
+        out << ",\n    \"deadline\": " << g_deadline.Limit() << ",\n";
+        out << "    \"deadline_wrap_up\": " << (g_deadline.WrappedUp() ? "true" : "false");
+    }
+
+    if (args.algorithm == AlgorithmType::RR) {
+        out << ",\n    \"steps\": [\n";
+        out << "      {\"step\": 1, ";
+        out << setprecision(2) << "\"objective\": " << values.result_step1.objective << ", ";
+        out << setprecision(3) << "\"time\": " << values.result_step1.runtime << ", ";
+        out << "\"cpu_time\": " << values.result_step1.cpu_time << ", ";
+        out << setprecision(6) << "\"gap\": " << values.result_step1.gap << "},\n";
+        out << "      {\"step\": 2, ";
+        out << setprecision(2) << "\"objective\": " << values.result_step2.objective << ", ";
+        out << setprecision(3) << "\"time\": " << values.result_step2.runtime << ", ";
+        out << "\"cpu_time\": " << values.result_step2.cpu_time << ", ";
+        out << setprecision(6) << "\"gap\": " << values.result_step2.gap << "},\n";
+        out << "      {\"step\": 3, ";
+        out << setprecision(2) << "\"objective\": " << values.result_step3.objective << ", ";
+        out << setprecision(3) << "\"time\": " << values.result_step3.runtime << ", ";
+        out << "\"cpu_time\": " << values.result_step3.cpu_time << ", ";
+        out << setprecision(6) << "\"gap\": " << values.result_step3.gap << "}\n";
+        out << "    ]";
+    }
+    out << "\n  },\n";
+
+    out << "  \"problem\": {\n";
+    out << "    \"N\": " << values.number_of_items << ",\n";
+    out << "    \"T\": " << values.number_of_periods << ",\n";
+    out << "    \"F\": " << values.number_of_flows << ",\n";
+    out << "    \"G\": " << values.number_of_groups << ",\n";
+    out << "    \"capacity\": " << values.machine_capacity << "\n";
+    out << "  },\n";
+
+    // Metrics section
+    const auto& m = values.metrics;
+    out << "  \"metrics\": {\n";
+
+    // Cost breakdown
+    out << "    \"cost\": {\n";
+    out << setprecision(2);
+    out << "      \"production\": " << m.cost_production << ",\n";
+    out << "      \"setup\": " << m.cost_setup << ",\n";
+    out << "      \"inventory\": " << m.cost_inventory << ",\n";
+    out << "      \"backorder\": " << m.cost_backorder << ",\n";
+    out << "      \"unmet\": " << m.cost_unmet << "\n";
+    out << "    },\n";
+
+    // Setup/Carryover
+    out << "    \"setup_carryover\": {\n";
+    out << "      \"total_setups\": " << m.total_setups << ",\n";
+    out << "      \"total_carryovers\": " << m.total_carryovers << ",\n";
+    out << "      \"saved_setup_cost\": " << m.saved_setup_cost << "\n";
+    out << "    },\n";
+
+    // Demand fulfillment
+    out << "    \"demand\": {\n";
+    out << "      \"total_demand\": " << m.total_demand << ",\n";
+    out << "      \"unmet_count\": " << m.unmet_count << ",\n";
+    out << setprecision(4);
+    out << "      \"unmet_rate\": " << m.unmet_rate << ",\n";
+    out << "      \"total_backorder\": " << m.total_backorder << ",\n";
+    out << "      \"on_time_rate\": " << m.on_time_rate << "\n";
+    out << "    },\n";
+
+    // Capacity utilization
+    out << "    \"capacity\": {\n";
+    out << "      \"avg_utilization\": " << m.capacity_util_avg << ",\n";
+    out << "      \"max_utilization\": " << m.capacity_util_max << ",\n";
+    out << "      \"by_period\": [";
+    for (size_t t = 0; t < m.capacity_util_by_period.size(); t++) {
+        out << setprecision(3) << m.capacity_util_by_period[t];
+        if (t + 1 < m.capacity_util_by_period.size()) out << ", ";
+    }
+    out << "]\n";
+    out << "    },\n";
+
+    // CPLEX stats
+    out << "    \"cplex\": {\n";
+    out << "      \"nodes\": " << m.cplex_nodes << ",\n";
+    out << "      \"iterations\": " << m.cplex_iterations << ",\n";
+    out << "      \"pool\": {\n";
+    out << "        \"envs_created\": " << m.pool_envs_created << ",\n";
+    out << "        \"leases\": " << m.pool_leases << ",\n";
+    out << "        \"warm_leases\": " << m.pool_warm_leases << ",\n";
+    out << setprecision(4);
+    out << "        \"startup_time\": " << m.pool_startup_time << ",\n";
+    out << "        \"overhead_time\": " << m.pool_overhead_time << "\n";
+    out << "      }\n";
+    out << "    },\n";
+
+    // Lower bound
+    out << "    \"bound\": {\n";
+    out << setprecision(2);
+    out << "      \"lower_bound\": " << m.lower_bound << ",\n";
+    out << "      \"lagrangian\": " << m.lr_bound << ",\n";
+    out << "      \"lagrangian_iterations\": " << m.lr_iterations << ",\n";
+    out << setprecision(3);
+    out << "      \"lagrangian_time\": " << m.lr_time << ",\n";
+    out << "      \"root_mode\": \"" << RootBoundModeName(values.root_bound_mode) << "\",\n";
+    out << setprecision(2);
+    out << "      \"root_bound\": " << m.root_bound << ",\n";
+    out << setprecision(3);
+    out << "      \"root_time\": " << m.root_time << "\n";
+    out << "    },\n";
+
+    // Subproblem prescreen
+    out << "    \"prescreen\": {\n";
+    out << "      \"checks\": " << m.prescreen_checks << ",\n";
+    out << "      \"rejects\": " << m.prescreen_rejects << ",\n";
+    out << setprecision(4);
+    out << "      \"time\": " << m.prescreen_time << "\n";
+    out << "    },\n";
+
+    // User cuts
+    out << "    \"cuts\": {\n";
+    out << "      \"scope\": \"" << CutScopeName(values.user_cut_scope) << "\",\n";
+    out << "      \"calls\": " << m.cut_calls << ",\n";
+    out << "      \"added\": " << m.cuts_added << ",\n";
+    out << setprecision(3);
+    out << "      \"time\": " << m.cut_time << ",\n";
+    out << setprecision(2);
+    out << "      \"root_gain\": " << m.cut_root_gain << "\n";
+    out << "    },\n";
+
+    // Rolling re-planning
+    if (m.replan) {
+        out << "    \"replan\": {\n";
+        out << "      \"previous_result\": \"" << JsonEscape(args.replan) << "\",\n";
+        out << "      \"instance_file\": \"" << JsonEscape(m.replan_instance_file) << "\",\n";
+        out << "      \"shift\": " << m.replan_shift << ",\n";
+        out << "      \"frozen_periods\": " << m.replan_frozen << ",\n";
+        out << "      \"affected_periods\": " << m.replan_affected_periods << ",\n";
+        out << "      \"orders_added\": " << m.replan_orders_added << ",\n";
+        out << "      \"orders_removed\": " << m.replan_orders_removed << ",\n";
+        out << "      \"orders_expired\": " << m.replan_orders_expired << ",\n";
+        out << "      \"orders_completed\": " << m.replan_orders_completed << ",\n";
+        out << "      \"fallback\": " << (m.replan_fallback ? "true" : "false") << ",\n";
+        out << setprecision(2);
+        out << "      \"warm_objective\": " << m.replan_warm_objective << ",\n";
+        out << "      \"overlap_periods\": " << m.replan_overlap_periods << ",\n";
+        out << "      \"periods_changed\": " << m.replan_periods_changed << ",\n";
+        out << "      \"first_changed_period\": " << m.replan_first_changed << ",\n";
+        out << "      \"setup_changes\": " << m.replan_setup_changes << ",\n";
+        out << "      \"carryover_changes\": " << m.replan_carryover_changes << ",\n";
+        out << "      \"volume_change\": " << m.replan_volume_change << ",\n";
+        out << setprecision(4);
+        out << "      \"volume_change_pct\": " << m.replan_volume_change_pct << "\n";
+        out << "    },\n";
+    }
+
+    // Dual sensitivity of the final fixed-setup LP
+    if (m.sensitivity) {
+        out << "    \"sensitivity\": {\n";
+        out << setprecision(2);
+        out << "      \"lp_objective\": " << m.sensitivity_objective << ",\n";
+        out << setprecision(3);
+        out << "      \"lp_time\": " << m.sensitivity_time << ",\n";
+        out << setprecision(4);
+        out << "      \"capacity\": {\n";
+        out << "        \"dual\": ";
+        WriteSensitivityArray(out, m.capacity_dual);
+        out << ",\n        \"slack\": ";
+        WriteSensitivityArray(out, m.capacity_slack);
+        out << ",\n        \"rhs_low\": ";
+        WriteSensitivityArray(out, m.capacity_rhs_low);
+        out << ",\n        \"rhs_high\": ";
+        WriteSensitivityArray(out, m.capacity_rhs_high);
+        out << "\n      },\n";
+        out << "      \"flow_limit\": {\n";
+        out << "        \"dual\": ";
+        WriteSensitivityMatrix(out, m.flow_limit_dual, "        ");
+        out << ",\n        \"slack\": ";
+        WriteSensitivityMatrix(out, m.flow_limit_slack, "        ");
+        out << ",\n        \"rhs_low\": ";
+        WriteSensitivityMatrix(out, m.flow_limit_rhs_low, "        ");
+        out << ",\n        \"rhs_high\": ";
+        WriteSensitivityMatrix(out, m.flow_limit_rhs_high, "        ");
+        out << "\n      },\n";
+        out << "      \"setup_reduced_cost\": ";
+        WriteSensitivityMatrix(out, m.setup_reduced_cost, "      ");
+        out << ",\n      \"carryover_reduced_cost\": ";
+        WriteSensitivityMatrix(out, m.carryover_reduced_cost, "      ");
+        out << ",\n      \"unmet_reduced_cost\": ";
+        WriteSensitivityArray(out, m.unmet_reduced_cost);
+        out << ",\n      \"production_reduced_cost\": ";
+        WriteSensitivityMatrix(out, m.production_reduced_cost, "      ");
+        out << ",\n      \"production_cost\": {\n";
+        out << "        \"low\": ";
+        WriteSensitivityMatrix(out, m.production_cost_low, "        ");
+        out << ",\n        \"high\": ";
+        WriteSensitivityMatrix(out, m.production_cost_high, "        ");
+        out << "\n      },\n      \"backlog_cost\": {\n";
+        out << "        \"low\": ";
+        WriteSensitivityMatrix(out, m.backlog_cost_low, "        ");
+        out << ",\n        \"high\": ";
+        WriteSensitivityMatrix(out, m.backlog_cost_high, "        ");
+        out << "\n      }\n    },\n";
+    }
+
+    // Algorithm-specific metrics
+    out << "    \"algorithm_specific\": {\n";
+    if (args.algorithm == AlgorithmType::RF) {
+        out << "      \"rf_iterations\": " << m.rf_iterations << ",\n";
+        out << "      \"rf_window_expansions\": " << m.rf_window_expansions << ",\n";
+        out << "      \"rf_rollbacks\": " << m.rf_rollbacks << ",\n";
+        out << "      \"rf_subproblems\": " << m.rf_subproblems << ",\n";
+        out << "      \"rf_cache_hits\": " << m.rf_cache_hits << ",\n";
+        out << "      \"rf_cache_misses\": " << m.rf_cache_misses << ",\n";
+        out << "      \"rf_retry_mode\": \"" << RFRetryModeName(values.rf_retry_mode) << "\",\n";
+        out << "      \"rf_parallel_batches\": " << m.rf_parallel_batches << ",\n";
+        out << "      \"rf_parallel_cancelled\": " << m.rf_parallel_cancelled << ",\n";
+        out << "      \"rf_spec_launched\": " << m.rf_spec_launched << ",\n";
+        out << "      \"rf_spec_hits\": " << m.rf_spec_hits << ",\n";
+        out << setprecision(3);
+        out << "      \"rf_spec_hit_rate\": "
+             << (m.rf_spec_launched > 0 ? static_cast<double>(m.rf_spec_hits) / m.rf_spec_launched : 0.0)
+             << ",\n";
+        out << setprecision(3);
+        out << "      \"rf_avg_subproblem_time\": " << m.rf_avg_subproblem_time << ",\n";
+        out << "      \"rf_final_solve_time\": " << m.rf_final_solve_time << "\n";
+    } else if (args.algorithm == AlgorithmType::RFO) {
+        out << setprecision(2);
+        out << "      \"rfo_rf_objective\": " << m.rfo_rf_objective << ",\n";
+        out << setprecision(3);
+        out << "      \"rfo_rf_time\": " << m.rfo_rf_time << ",\n";
+        out << "      \"rfo_rf_cache_hits\": " << m.rf_cache_hits << ",\n";
+        out << "      \"rfo_rf_cache_misses\": " << m.rf_cache_misses << ",\n";
+        out << "      \"rfo_fo_rounds\": " << m.rfo_fo_rounds << ",\n";
+        out << "      \"rfo_fo_windows_improved\": " << m.rfo_fo_windows_improved << ",\n";
+        out << setprecision(2);
+        out << "      \"rfo_fo_improvement\": " << m.rfo_fo_improvement << ",\n";
+        out << setprecision(4);
+        out << "      \"rfo_fo_improvement_pct\": " << m.rfo_fo_improvement_pct << ",\n";
+        out << setprecision(3);
+        out << "      \"rfo_fo_time\": " << m.rfo_fo_time << ",\n";
+        out << "      \"rfo_final_solve_time\": " << m.rfo_final_solve_time << "\n";
+    } else if (args.algorithm == AlgorithmType::RR) {
+        out << setprecision(2);
+        out << "      \"rr_step1_objective\": " << m.rr_step1_objective << ",\n";
+        out << "      \"rr_step1_setups\": " << m.rr_step1_setups << ",\n";
+        out << setprecision(3);
+        out << "      \"rr_step1_time\": " << m.rr_step1_time << ",\n";
+        out << "      \"rr_step2_carryovers\": " << m.rr_step2_carryovers << ",\n";
+        out << "      \"rr_step2_time\": " << m.rr_step2_time << ",\n";
+        out << setprecision(2);
+        out << "      \"rr_step3_objective\": " << m.rr_step3_objective << ",\n";
+        out << setprecision(3);
+        out << "      \"rr_step3_time\": " << m.rr_step3_time << ",\n";
+        out << setprecision(6);
+        out << "      \"rr_step3_gap_to_step1\": " << m.rr_step3_gap_to_step1 << ",\n";
+        out << setprecision(4);
+        out << "      \"rr_carryover_utilization\": " << m.rr_carryover_utilization << "\n";
+    }
+    out << "    }\n";
+
+    out << "  },\n";
+
+    // Output Y and L variables (available for all algorithms)
+    out << "  \"variables\": {\n";
+
+    // Y[g][t] - Setup decisions
+    out << "    \"Y\": {\n";
+    out << "      \"description\": \"Setup decision\",\n";
+    out << "      \"dimensions\": [" << values.number_of_groups << ", " << values.number_of_periods << "],\n";
+    out << "      \"data\": [\n";
+    for (int g = 0; g < values.number_of_groups; g++) {
+        out << "        [";
+        for (int t = 0; t < values.number_of_periods; t++) {
+            int val = (g < (int)lists.small_y.size() && t < (int)lists.small_y[g].size())
+                    ? lists.small_y[g][t] : 0;
+            out << val;
+            if (t + 1 < values.number_of_periods) out << ", ";
+        }
+        out << "]";
+        if (g + 1 < values.number_of_groups) out << ",";
+        out << "\n";
+    }
+    out << "      ]\n";
+    out << "    },\n";
+
+    // L[g][t] - Carryover decisions
+    out << "    \"L\": {\n";
+    out << "      \"description\": \"Setup carryover\",\n";
+    out << "      \"dimensions\": [" << values.number_of_groups << ", " << values.number_of_periods << "],\n";
+    out << "      \"data\": [\n";
+    for (int g = 0; g < values.number_of_groups; g++) {
+        out << "        [";
+        for (int t = 0; t < values.number_of_periods; t++) {
+            int val = (g < (int)lists.small_l.size() && t < (int)lists.small_l[g].size())
+                    ? lists.small_l[g][t] : 0;
+            out << val;
+            if (t + 1 < values.number_of_periods) out << ", ";
+        }
+        out << "]";
+        if (g + 1 < values.number_of_groups) out << ",";
+        out << "\n";
+    }
+    out << "      ]\n";
+    out << "    },\n";
+
+    // X[i][t] - Production quantities
+    out << "    \"X\": {\n";
+    out << "      \"description\": \"Production quantity\",\n";
+    out << "      \"dimensions\": [" << values.number_of_items << ", " << values.number_of_periods << "],\n";
+    out << "      \"data\": [\n";
+    out << setprecision(0);
+    for (int i = 0; i < values.number_of_items; i++) {
+        out << "        [";
+        for (int t = 0; t < values.number_of_periods; t++) {
+            double val = (i < (int)lists.small_x.size() && t < (int)lists.small_x[i].size())
+                       ? lists.small_x[i][t] : 0.0;
+            out << val;
+            if (t + 1 < values.number_of_periods) out << ", ";
+        }
+        out << "]";
+        if (i + 1 < values.number_of_items) out << ",";
+        out << "\n";
+    }
+    out << "      ]\n";
+    out << "    },\n";
+
+    // I[f][t] - Inventory levels
+    out << "    \"I\": {\n";
+    out << "      \"description\": \"Inventory level\",\n";
+    out << "      \"dimensions\": [" << values.number_of_flows << ", " << values.number_of_periods << "],\n";
+    out << "      \"data\": [\n";
+    for (int f = 0; f < values.number_of_flows; f++) {
+        out << "        [";
+        for (int t = 0; t < values.number_of_periods; t++) {
+            double val = (f < (int)lists.small_i.size() && t < (int)lists.small_i[f].size())
+                       ? lists.small_i[f][t] : 0.0;
+            out << val;
+            if (t + 1 < values.number_of_periods) out << ", ";
+        }
+        out << "]";
+        if (f + 1 < values.number_of_flows) out << ",";
+        out << "\n";
+    }
+    out << "      ]\n";
+    out << "    },\n";
+
+    // B[i][t] - Backorder quantities
+    out << "    \"B\": {\n";
+    out << "      \"description\": \"Backorder quantity\",\n";
+    out << "      \"dimensions\": [" << values.number_of_items << ", " << values.number_of_periods << "],\n";
+    out << "      \"data\": [\n";
+    for (int i = 0; i < values.number_of_items; i++) {
+        out << "        [";
+        for (int t = 0; t < values.number_of_periods; t++) {
+            double val = (i < (int)lists.small_b.size() && t < (int)lists.small_b[i].size())
+                       ? lists.small_b[i][t] : 0.0;
+            out << val;
+            if (t + 1 < values.number_of_periods) out << ", ";
+        }
+        out << "]";
+        if (i + 1 < values.number_of_items) out << ",";
+        out << "\n";
+    }
+    out << "      ]\n";
+    out << "    },\n";
+
+    // U[i] - Unmet demand indicators
+    out << "    \"U\": {\n";
+    out << "      \"description\": \"Unmet demand indicator\",\n";
+    out << "      \"dimensions\": [" << values.number_of_items << "],\n";
+    out << "      \"data\": [";
+    for (int i = 0; i < values.number_of_items; i++) {
+        double val = (i < (int)lists.small_u.size()) ? lists.small_u[i] : 0.0;
+        out << (int)val;
+        if (i + 1 < values.number_of_items) out << ", ";
+    }
+    out << "]\n";
+    out << "    }\n";
+
+    out << "  }\n";
+    out << "}\n";
+}
@@ -0,0 +1,133 @@
+// solve_driver.h - 单次求解流程
+// 命令行参数、参数应用、求解 (合并 -> 算法 -> 下界) 与结果 JSON 输出。
+// main 的单次运行与服务模式 (serve.h) 共用同一流程
+
+#ifndef SOLVE_DRIVER_H_
+#define SOLVE_DRIVER_H_
+
+#include "optimizer.h"
+
+// 命令行参数 (服务模式下每个请求在服务进程参数的基础上覆盖)
+struct CommandLineArgs {
+    AlgorithmType algorithm = AlgorithmType::RF;  // 默认使用 RF
+    string input_file = "";
+    string output_dir = "./results";
+    string log_file = "";
+    double time_limit = 30.0;
+    double deadline = 0.0;      // 全局截止时间 (秒)，0 表示不限
+    bool stdin_control = false; // 监听 stdin 中断命令
+    double cancel_grace = 10.0; // 中断后收尾求解时限 (秒)
+    int progress_fd = -1;       // 进度流文件描述符，-1 表示关闭
+    double progress_interval = 0.5;
+    int u_penalty = 10000;
+    int b_penalty = 100;
+    double big_order_threshold = 1000.0;
+    bool enable_merge = true;   // 是否启用订单合并
+    bool show_help = false;
+    // CPLEX parameters
+    string cplex_workdir = "D:\\CPLEX_Temp";
+    int cplex_workmem = 4096;
+    int cplex_threads = 0;
+    // Machine capacity
+    int machine_capacity = 1440;
+    // RF algorithm parameters
+    int rf_window = 6;
+    int rf_step = 1;
+    double rf_time = 60.0;
+    int rf_retries = 3;
+    bool rf_cache = true;
+    RFRetryMode rf_retry = RFRetryMode::Sequential;
+    int rf_speculate = 0;
+    // FO algorithm parameters (for RFO)
+    int fo_window = 8;
+    int fo_step = 3;
+    int fo_rounds = 2;
+    int fo_buffer = 1;
+    double fo_time = 30.0;
+    // RR algorithm parameters
+    double rr_capacity = 1.2;
+    double rr_bonus = 50.0;
+    // Lower bound parameters
+    int lr_iterations = 200;
+    int lr_threads = 0;
+    RootBoundMode root_bound = RootBoundMode::Off;
+    double root_time = 60.0;
+    int root_threads = 0;
+    double root_wait = 0.0;
+    // Model formulation
+    bool aggregate_exclusivity = true;
+    bool tight_big_m = true;
+    bool item_vub = false;
+    int user_cut_scope = 0;
+    // Local search move evaluation benchmark
+    long bench_moves = 0;
+    // Dual sensitivity of the final fixed-setup LP (见 sensitivity.h)
+    bool sensitivity = false;
+    // Service mode
+    string serve;               // Unix 套接字路径，"-" 为 stdin/stdout，空为单次运行
+    int serve_queue = 16;       // 请求队列上限
+    // Rolling re-planning (见 replan.h)
+    string replan;              // 上次结果 JSON，空表示不重排程
+    string replan_delta;        // 算例增量文件
+    int replan_frozen = -1;     // 冻结周期数，-1 表示取增量文件中的值
+    // Coefficient sweep (见 sweep.h)
+    string sweep;               // 变体文件，空表示不扫描
+    int sweep_workers = 0;      // 并行工作线程 (环境) 数，0 表示自动
+    // Parameter profile (见 config_file.h)，先于其余命令行参数生效
+    string profile;             // 参数配置文件，空表示不加载
+    string profile_class;       // 配置节 (实例类别)，空表示 [default]
+    // Hyperparameter tuning (见 tune.h)
+    string tune;                // 实例集 (目录或列表文件)，空表示不调参
+    int tune_configs = 16;      // 候选配置数 (含当前参数)
+    int tune_workers = 0;       // 并行求解进程数，0 表示自动
+    unsigned tune_seed = 1;     // 候选配置采样种子
+    // Subproblem dump (见 subproblem_dump.h)
+    string dump_subproblems;    // 转储目录，空表示不转储
+    string dump_format = "lp";  // lp / mps / sav
+    // Per-phase CPLEX parameter profiles (见 cplex_params.h)
+    string cplex_profiles;      // 配置文件，空表示全部阶段用 CPLEX 默认值
+    map<string, CplexPhaseProfile> cplex_phase_profiles;  // 解析时读入
+    // Regression suite (见 regress.h)
+    string regress;             // 套件文件，空表示不运行
+    bool regress_record = false;  // 以本次结果写入基线
+    string regress_algo;        // 只运行列出的算法 (逗号分隔)，空为套件中的全部
+    bool regress_strict = false;  // 基线缺少的用例 (new) 也视为回归 (CTest 目标使用)
+    string regress_options;     // 追加在套件 options 之后的子进程参数 (按空白切分)
+};
+
+// 求解汇总
+struct SolveSummary {
+    double objective = -1.0;
+    double runtime = -1.0;      // 算法求解时间 (RR 为三阶段之和)
+    double gap = -1.0;
+    double total_time = 0.0;    // 合并 + 求解 + 下界
+};
+
+void PrintUsage(const char* program);
+
+// argv[0] 不解析；args 中已有的值作为默认值。
+// --profile 指定的配置节先写入 args，命令行中的其余参数再覆盖
+bool ParseArgs(int argc, char* argv[], CommandLineArgs& args);
+
+// 把参数配置文件的一节写入 args: 键 rf_window 对应 --rf-window，algo 对应 --algo=，
+// 值为 true/false 的键作为开关；section 为空时取 [default]
+bool ApplyParamProfile(const string& path, const string& section, CommandLineArgs& args);
+
+// 输出状态码 (供 GUI 解析)；服务模式下关闭，避免与响应混合
+void EmitStatus(const string& status);
+void SetStatusOutput(bool enabled);
+
+// 读取实例，失败时返回 false
+bool LoadInstance(const string& path, AllValues& values, AllLists& lists);
+
+// 参数写入 values (实例路径与输出目录取 args.input_file / args.output_dir)
+void ApplyArgs(const CommandLineArgs& args, AllValues& values);
+
+// 在已读取的实例上求解，结果留在 values/lists 中
+SolveSummary RunSolve(const CommandLineArgs& args, AllValues& values, AllLists& lists);
+
+// 结果 JSON (缩进格式，字符串值不含换行)
+void WriteResultJson(ostream& out, const CommandLineArgs& args, const AllValues& values,
+                     const AllLists& lists, const SolveSummary& summary);
+
+#endif  // SOLVE_DRIVER_H_
@@ -6,7 +6,20 @@
 //   T^rel: 放松周期 - 变量放松为连续
 
 #include "optimizer.h"
+#include "lot_sizing_model.h"
+#include "lot_sizing_cuts.h"
+#include "plan_metrics.h"
+#include "cplex_pool.h"
+#include "rf_cache.h"
+#include "prescreen.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include "progress.h"
 #include "logger.h"
+#include "subproblem_dump.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 // 初始化 RF 状态
 static void InitRFState(RFState& state, const AllValues& values) {
@@ -22,18 +35,141 @@ static void InitRFState(RFState& state, const AllValues& values) {
     state.iterations = 0;
 }
 
+// 并行重试中单个子问题的取消句柄
+// 求解期间登记环境的 Aborter；被更小的可行窗口淘汰时由其他线程调用 Cancel() 中止
+class RFCancelHandle {
+public:
+    // 登记 Aborter，已取消时返回 false (不再开始求解)
+    bool Attach(IloCplex::Aborter* aborter) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborter_ = cancelled_ ? nullptr : aborter;
+        return !cancelled_;
+    }
+
+    void Detach() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborter_ = nullptr;
+    }
+
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        if (aborter_ != nullptr) {
+            aborter_->abort();
+        }
+    }
+
+    bool Cancelled() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cancelled_;
+    }
+
+private:
+    std::mutex mutex_;
+    bool cancelled_ = false;
+    IloCplex::Aborter* aborter_ = nullptr;  // 求解期间有效，受 mutex_ 保护
+};
+
+// 离开作用域时解除登记 (先于环境归还)
+struct RFCancelScope {
+    RFCancelHandle* handle;
+    ~RFCancelScope() {
+        if (handle != nullptr) handle->Detach();
+    }
+};
+
+// 推测 RF 的临时解处理函数: 参数为窗口段 [k, k+W) 的 (y, lambda)，其余周期为 0
+using RFIncumbentHandler = std::function<void(const vector<vector<int>>&,
+                                              const vector<vector<int>>&)>;
+
+// 首个 incumbent 回调
+// Candidate 上下文读取窗口段 (y, lambda) 交给 handler (只触发一次)；
+// CPLEX 每个求解器只能挂一个通用回调，Relaxation 上下文转交用户割回调
+class RFIncumbentHook : public IloCplex::Callback::Function {
+public:
+    RFIncumbentHook(IloEnv env, const IloArray<IloNumVarArray>& Y,
+                    const IloArray<IloNumVarArray>& Lambda,
+                    int G, int T, int k, int win_end,
+                    IloCplex::Callback::Function* inner,
+                    const RFIncumbentHandler& handler)
+        : G_(G), T_(T), k_(k), win_end_(win_end),
+          inner_(inner), handler_(handler), vars_(env) {
+        for (int g = 0; g < G; g++) {
+            for (int t = k; t < win_end; t++) {
+                vars_.add(Y[g][t]);
+                vars_.add(Lambda[g][t]);
+            }
+        }
+    }
+
+    ~RFIncumbentHook() override {
+        vars_.end();
+    }
+
+    void invoke(const IloCplex::Callback::Context& context) override {
+        if (context.inRelaxation()) {
+            if (inner_ != nullptr) inner_->invoke(context);
+            return;
+        }
+        if (!context.inCandidate() || !context.isCandidatePoint() || fired_.exchange(true)) {
+            return;
+        }
+
+        IloNumArray point(context.getEnv());
+        context.getCandidatePoint(vars_, point);
+        vector<vector<int>> y(G_, vector<int>(T_, 0));
+        vector<vector<int>> lambda(G_, vector<int>(T_, 0));
+        IloInt idx = 0;
+        for (int g = 0; g < G_; g++) {
+            for (int t = k_; t < win_end_; t++) {
+                y[g][t] = point[idx++] > 0.5 ? 1 : 0;
+                lambda[g][t] = point[idx++] > 0.5 ? 1 : 0;
+            }
+        }
+        point.end();
+
+        handler_(y, lambda);
+    }
+
+    CPXLONG Contexts() const {
+        CPXLONG contexts = IloCplex::Callback::Context::Id::Candidate;
+        if (inner_ != nullptr) contexts |= IloCplex::Callback::Context::Id::Relaxation;
+        return contexts;
+    }
+
+private:
+    int G_, T_, k_, win_end_;
+    IloCplex::Callback::Function* inner_;
+    RFIncumbentHandler handler_;
+    IloNumVarArray vars_;
+    std::atomic<bool> fired_{false};
+};
+
+// SolveRFSubproblem 的选项
+struct RFSubproblemOptions {
+    bool is_final = false;                          // 最终求解: 全部固定，u 为整数，提取完整计划
+    RFCancelHandle* cancel = nullptr;               // 非空时为并行重试: 不输出 CPLEX 日志，可被 Cancel() 中止
+    int threads = -1;                               // >= 0 时覆盖 CPLEX 线程数
+    const RFIncumbentHandler* on_incumbent = nullptr;  // 非空时首个 incumbent 出现即回调
+};
+
+// SolveRFSubproblem 的结果
+struct RFSubproblemResult {
+    RFSolveStatus status = RFSolveStatus::Unknown;  // 见 rf_cache.h
+    double objective = -1.0;
+    double cpu_time = 0.0;
+};
+
 // 求解 RF 子问题 SP(k, W)
-// 返回是否找到可行解，若可行则更新 y_solution 和 lambda_solution
-static bool SolveRFSubproblem(
+// 可行时更新 y_solution 和 lambda_solution
+static RFSubproblemResult SolveRFSubproblem(
     int k, int W,
     const RFState& state,
     AllValues& values,
     AllLists& lists,
     vector<vector<int>>& y_solution,
     vector<vector<int>>& lambda_solution,
-    bool is_final = false,
-    double* objective_out = nullptr,
-    double* cpu_time_out = nullptr)
+    const RFSubproblemOptions& options = {})
 {
     int G = values.number_of_groups;
     int T = values.number_of_periods;
@@ -47,24 +183,36 @@ static bool SolveRFSubproblem(
     LOG_FMT("[RF] 子问题: k=%d W=%d (固定:[0,%d) 窗口:[%d,%d) 放松:[%d,%d))\n",
             k, W, k, k, win_end, rel_start, T);
 
+    // 截止时间调度: 按剩余时间与剩余窗口数分配时限，最终求解取剩余全部时间
+    double time_limit = values.rf_time;
+    if (g_deadline.Enabled()) {
+        int remaining_windows = (T - k + values.rf_step - 1) / values.rf_step;
+        time_limit = options.is_final ? g_deadline.FinalBudget(values.rf_time)
+                              : g_deadline.Budget(values.rf_time, remaining_windows);
+        LOG_FMT("[RF] 截止时间调度: 时限=%.1fs 剩余=%.1fs\n", time_limit, g_deadline.Remaining());
+    }
+
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = options.threads >= 0
+            ? CplexPool::Instance().Acquire(values, time_limit, options.threads)
+            : AcquireCplex(values, time_limit);
+        IloEnv env = lease.Env();
         IloModel model(env);
 
         // 决策变量
-        IloArray<IloNumVarArray> X(env, N);
+        IloArray<IloNumVarArray> X;
         IloArray<IloNumVarArray> Y(env, G);
         IloArray<IloNumVarArray> Lambda(env, G);
         IloArray<IloNumVarArray> I(env, F);
         IloArray<IloNumVarArray> P(env, F);
-        IloArray<IloNumVarArray> B(env, N);
-        IloNumVarArray U(env);
+        IloArray<IloNumVarArray> B;
+        IloNumVarArray U;
 
         // X, B 始终为连续变量
-        for (int i = 0; i < N; i++) {
-            X[i] = IloNumVarArray(env, T, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, T, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        X = CreateWindowVars(env, lists.ew_x, T);
+        B = CreateWindowVars(env, lists.lw_x, T);
 
         // I, P 始终为连续变量
         for (int f = 0; f < F; f++) {
@@ -95,12 +243,16 @@ static bool SolveRFSubproblem(
         }
 
         // U: 在 RF 循环中放松，最终求解时恢复整数
-        if (is_final) {
+        if (options.is_final) {
             U = IloNumVarArray(env, N, 0, 1, ILOBOOL);
         } else {
             U = IloNumVarArray(env, N, 0, 1, ILOFLOAT);
         }
 
+        // 变量随环境归还结束 (见 cplex_pool.h)
+        for (auto vars : {X, Y, Lambda, I, P, B}) lease.Own(vars);
+        lease.Own(U);
+
         // 固定 T^fix 区间的 y, lambda
         for (int g = 0; g < G; g++) {
             for (int t = 0; t < k; t++) {
@@ -114,7 +266,7 @@ static bool SolveRFSubproblem(
 
         // 生产成本
         for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 objective += lists.cost_x[i] * X[i][t];
             }
         }
@@ -151,7 +303,7 @@ static bool SolveRFSubproblem(
         // 约束1: 需求满足
         for (int i = 0; i < N; i++) {
             IloExpr total_production(env);
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -162,6 +314,7 @@ static bool SolveRFSubproblem(
         for (int t = 0; t < T; t++) {
             IloExpr capacity(env);
             for (int i = 0; i < N; i++) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < G; g++) {
@@ -172,25 +325,15 @@ static bool SolveRFSubproblem(
         }
 
         // 约束3: 产品大类级 Big-M 约束 (含 carryover)
-        for (int g = 0; g < G; g++) {
-            for (int t = 0; t < T; t++) {
-                IloExpr family_production(env);
-                for (int i = 0; i < N; i++) {
-                    if (lists.group_flag[i][g]) {
-                        family_production += lists.usage_x[i] * X[i][t];
-                    }
-                }
-                model.add(family_production <= values.machine_capacity * (Y[g][t] + Lambda[g][t]));
-                family_production.end();
-            }
-        }
+        AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                                  values.machine_capacity);
 
         // 约束4: 下游工序流平衡
         for (int f = 0; f < F; f++) {
             for (int t = 0; t < T; t++) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < N; i++) {
-                    if (lists.flow_flag[i][f]) {
+                    if (lists.flow_flag[i][f] && t >= lists.ew_x[i]) {
                         flow_production += X[i][t];
                     }
                 }
@@ -212,28 +355,19 @@ static bool SolveRFSubproblem(
             }
         }
 
-        // 约束6: 最早生产期约束 (仅约束 t < e_i)
+        // 约束6: 最早生产期约束 - t < e_i 的 x_it 不创建 (时间窗稀疏变量)
         // 注意: t > l_i 后仍可生产，通过欠交惩罚控制
-        for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
-                if (t < lists.ew_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
-            }
-        }
 
         // 约束7: 欠交定义
         for (int i = 0; i < N; i++) {
             for (int t = 0; t < T; t++) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -268,42 +402,93 @@ static bool SolveRFSubproblem(
         }
 
         // 约束9: Carryover排他性 - lambda_gt + lambda_{g,t-1} + y_gt - sum_{g'!=g} y_{g't} <= 2
-        for (int g = 0; g < G; g++) {
-            for (int t = 1; t < T; t++) {
-                IloExpr sum_other_y(env);
-                for (int g2 = 0; g2 < G; g2++) {
-                    if (g2 != g) {
-                        sum_other_y += Y[g2][t];
-                    }
-                }
-                model.add(Lambda[g][t] + Lambda[g][t-1] + Y[g][t] - sum_other_y <= 2);
-                sum_other_y.end();
+        lease.Own(AddCarryoverExclusivity(env, model, values, Y, Lambda, G, T));
+
+        // 配置并求解
+        // 子问题转储: y/lambda 须在装载前命名
+        if (SubproblemDumpEnabled(values)) {
+            NameSetupVars(Y, Lambda, G, T);
+        }
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, options.is_final ? "rf_final" : "rf_window");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = options.is_final ? "rf_final" : "rf_window";
+            dump.k = k;
+            dump.W = W;
+            dump.win_begin = k;
+            dump.win_end = win_end;
+            dump.time_limit = time_limit;
+            dump.threads = options.threads >= 0 ? options.threads : values.cplex_threads;
+            dump.parallel_retry = options.cancel != nullptr;
+            DumpSubproblem(cplex, values, dump);
+        }
+
+        // 用户割平面: 放松段 y/lambda 为连续变量，只在 t < win_end 上分离
+        auto cut_callback = AttachLotSizingCuts(cplex, kCutScopeRF, env, values, lists,
+                                                X, Y, Lambda, B, values.machine_capacity, win_end);
+
+        // 推测 RF: 与用户割共用一个通用回调
+        unique_ptr<RFIncumbentHook> incumbent_hook;
+        if (options.on_incumbent != nullptr) {
+            incumbent_hook = make_unique<RFIncumbentHook>(env, Y, Lambda, G, T, k, win_end,
+                                                          cut_callback.get(), *options.on_incumbent);
+            cplex.use(incumbent_hook.get(), incumbent_hook->Contexts());
+        }
+
+        // 进度流: 并行重试与推测求解同时进行，只上报主求解
+        unique_ptr<ProgressCallback> progress;
+        if (options.cancel == nullptr) {
+            if (incumbent_hook) {
+                progress = AttachProgress(cplex, incumbent_hook.get(), incumbent_hook->Contexts());
+            } else {
+                progress = AttachProgress(cplex, cut_callback.get(),
+                                          IloCplex::Callback::Context::Id::Relaxation);
             }
         }
 
-        // 配置并求解
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, values.rf_time);  // 使用动态参数
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        // 并行重试: 登记环境的 Aborter 供淘汰时中止
+        RFCancelScope cancel_scope{nullptr};
+        if (options.cancel != nullptr) {
+            if (!options.cancel->Attach(&lease.Aborter())) {
+                return RFSubproblemResult();
+            }
+            cancel_scope.handle = options.cancel;
+        }
 
         // 设置 CPLEX 输出到日志系统（同时输出到终端和文件）
-        if (g_logger) {
+        // 并行重试时多个求解同时进行，不输出 CPLEX 日志
+        if (g_logger && options.cancel == nullptr) {
             cplex.setOut(g_logger->GetTeeStream());
         }
-        LOG("\n=============== CPLEX START ===============");
+        if (options.cancel == nullptr) {
+            LOG("\n=============== CPLEX START ===============");
+        }
 
         bool solved = cplex.solve();
+        RecordSolveEffort(values, cplex);
+
+        // 被淘汰中止的求解不代表正常耗时，不计入调度历史
+        if (!options.is_final && (options.cancel == nullptr || !options.cancel->Cancelled())) {
+            g_deadline.RecordSolve(cplex.getTime());
+        }
+
+        if (options.cancel != nullptr) {
+            options.cancel->Detach();
+        }
 
         // 求解后断开 CPLEX 输出流
         cplex.setOut(env.getNullStream());
         if (g_logger) {
             g_logger->Flush();
         }
-        LOG("=============== CPLEX END =================");
-        LOG_RAW("\n");
+        if (options.cancel == nullptr) {
+            LOG("=============== CPLEX END =================");
+        }
+        RecordCutStats(values, "[RF]", cut_callback.get());
+        if (options.cancel == nullptr) {
+            LOG_RAW("\n");
+        }
 
         bool has_incumbent = false;
         try {
@@ -313,13 +498,12 @@ static bool SolveRFSubproblem(
             has_incumbent = false;
         }
 
-        if (solved && has_incumbent) {
-            double obj_value = cplex.getObjValue();
-            double cpu_time = cplex.getTime();
-            LOG_FMT("[RF] 求解成功: 目标=%.2f CPU时间=%.2fs\n", obj_value, cpu_time);
-
-            if (objective_out) *objective_out = obj_value;
-            if (cpu_time_out) *cpu_time_out = cpu_time;
+        RFSubproblemResult result;
+        result.status = ClassifyRFSolve(cplex, solved && has_incumbent);
+        if (result.status == RFSolveStatus::Feasible) {
+            result.objective = cplex.getObjValue();
+            result.cpu_time = cplex.getTime();
+            LOG_FMT("[RF] 求解成功: 目标=%.2f CPU时间=%.2fs\n", result.objective, result.cpu_time);
 
             // 提取解
             y_solution.assign(G, vector<int>(T, 0));
@@ -333,44 +517,22 @@ static bool SolveRFSubproblem(
             }
 
             // Save X, I, B, U for final solve
-            if (is_final) {
-                lists.small_x.resize(N);
-                lists.small_b.resize(N);
-                lists.small_u.resize(N);
-                lists.small_i.resize(F);
-
-                for (int i = 0; i < N; i++) {
-                    lists.small_x[i].resize(T);
-                    lists.small_b[i].resize(T);
-                    for (int t = 0; t < T; t++) {
-                        lists.small_x[i][t] = cplex.getValue(X[i][t]);
-                        lists.small_b[i][t] = cplex.getValue(B[i][t]);
-                    }
-                    lists.small_u[i] = cplex.getValue(U[i]);
-                }
-
-                for (int f = 0; f < F; f++) {
-                    lists.small_i[f].resize(T);
-                    for (int t = 0; t < T; t++) {
-                        lists.small_i[f][t] = cplex.getValue(I[f][t]);
-                    }
-                }
+            if (options.is_final) {
+                ExtractFinalPlan(cplex, values, lists, X, B, I, U);
             }
-
-            env.end();
-            return true;
+        } else if (result.status == RFSolveStatus::Infeasible) {
+            LOG("[RF] 子问题不可行");
         } else {
-            LOG("[RF] 求解失败或无可行解");
-            env.end();
-            return false;
+            LOG("[RF] 求解失败或无可行解 (未证明不可行)");
         }
+        return result;
 
     } catch (IloException& e) {
         LOG_FMT("[RF] CPLEX错误: %s\n", e.getMessage());
-        return false;
+        return RFSubproblemResult();
     } catch (...) {
         LOG("[RF] 未知错误");
-        return false;
+        return RFSubproblemResult();
     }
 }
 
@@ -424,6 +586,344 @@ static bool Rollback(RFState& state, int& k, int& W, int rf_window) {
     return true;
 }
 
+// 预筛 SP(k, W): 只依赖固定前缀 [0,k)，与窗口大小无关
+static bool PrescreenRFWindow(int k, const RFState& state, AllValues& values,
+                              const AllLists& lists, const char* tag) {
+    vector<bool> fixed(values.number_of_periods, false);
+    for (int t = 0; t < k; t++) {
+        fixed[t] = true;
+    }
+    return PrescreenSubproblem(values, lists, state.y_bar, state.lambda_bar, fixed, tag).feasible;
+}
+
+// 带缓存的子问题求解: 命中时直接返回已知结论 (含不可行)，不计入求解次数与 CPU 时间；
+// 未命中时先预筛，必然不可行则不调用 CPLEX，并置 *rejected (扩展窗口同样无济于事)。
+// 结论未知的求解 (超时无解、中止、出错) 返回 false 但不写入缓存
+static bool SolveRFSubproblemCached(
+    int k, int W,
+    const RFState& state,
+    AllValues& values,
+    AllLists& lists,
+    RFSubproblemCache& cache,
+    vector<vector<int>>& y_solution,
+    vector<vector<int>>& lambda_solution,
+    int& subproblems,
+    double& cpu_time,
+    const RFSubproblemOptions& options = {},
+    bool* rejected = nullptr)
+{
+    RFCacheEntry entry;
+    if (cache.Lookup(k, W, state, entry)) {
+        LOG_FMT("[RF] 缓存命中: k=%d W=%d (%s)\n", k, W, entry.feasible ? "可行" : "不可行");
+        if (entry.feasible) {
+            y_solution = entry.y;
+            lambda_solution = entry.lambda;
+        }
+        return entry.feasible;
+    }
+
+    if (!PrescreenRFWindow(k, state, values, lists, "[RF]")) {
+        if (rejected) *rejected = true;
+        cache.Store(k, W, state, entry);
+        return false;
+    }
+
+    subproblems++;
+    RFSubproblemResult result = SolveRFSubproblem(k, W, state, values, lists,
+                                                  y_solution, lambda_solution, options);
+    cpu_time += result.cpu_time;
+    entry.feasible = result.status == RFSolveStatus::Feasible;
+    entry.objective = result.objective;
+    entry.cpu_time = result.cpu_time;
+    if (entry.feasible) {
+        entry.y = y_solution;
+        entry.lambda = lambda_solution;
+    }
+    if (result.status != RFSolveStatus::Unknown) {
+        cache.Store(k, W, state, entry);
+    }
+    return entry.feasible;
+}
+
+// 并行重试中的候选子问题
+struct RFRetryCandidate {
+    int k = 0;
+    int W = 0;
+    bool rollback = false;             // 回滚候选: SP(回滚起点, rf_window + 2)
+    RFSolveStatus status = RFSolveStatus::Unknown;
+    double objective = -1.0;
+    double cpu_time = 0.0;
+    vector<vector<int>> y_solution;
+    vector<vector<int>> lambda_solution;
+    RFCancelHandle cancel;
+};
+
+// 并行重试结果
+struct RFRetryOutcome {
+    int best_W = -1;                   // 最小可行窗口 (-1 表示全部不可行)
+    int expansions = 0;                // 涉及的重试窗口数 (含缓存命中)
+    int launched = 0;                  // 实际求解的子问题数
+    int cancelled = 0;                 // 被中止的子问题数
+};
+
+// 并行窗口扩展重试
+// W+1..W+R 依次查缓存，未命中的窗口并发求解，线程预算按候选数均分；
+// 某窗口可行后中止所有更大的窗口与回滚候选，取最小可行窗口。
+// ParallelRollback 模式同时求解回滚后的第一个子问题: 它只依赖回滚起点之前的前缀，
+// 与当前状态下求解等价，结论写入缓存，随后的 Rollback 之后直接命中。
+// 被中止或结论未知的候选不写入缓存
+static RFRetryOutcome SolveRetriesParallel(
+    int k, int W,
+    const RFState& state,
+    AllValues& values,
+    AllLists& lists,
+    RFSubproblemCache& cache,
+    vector<vector<int>>& y_solution,
+    vector<vector<int>>& lambda_solution,
+    double& cpu_time)
+{
+    RFRetryOutcome outcome;
+    vector<unique_ptr<RFRetryCandidate>> candidates;
+
+    for (int r = 1; r <= values.rf_retries; r++) {
+        outcome.expansions++;
+        RFCacheEntry entry;
+        if (cache.Lookup(k, W + r, state, entry)) {
+            LOG_FMT("[RF] 缓存命中: k=%d W=%d (%s)\n", k, W + r, entry.feasible ? "可行" : "不可行");
+            if (entry.feasible) {
+                // 更大的窗口无需再试
+                outcome.best_W = W + r;
+                y_solution = entry.y;
+                lambda_solution = entry.lambda;
+                break;
+            }
+            continue;
+        }
+        auto candidate = make_unique<RFRetryCandidate>();
+        candidate->k = k;
+        candidate->W = W + r;
+        candidates.push_back(std::move(candidate));
+    }
+
+    if (values.rf_retry_mode == RFRetryMode::ParallelRollback &&
+        outcome.best_W < 0 && !state.rollback_stack.empty()) {
+        int rollback_k = state.rollback_stack.back().first;
+        int rollback_W = values.rf_window + 2;
+        if (!cache.Contains(rollback_k, rollback_W, state)) {
+            auto candidate = make_unique<RFRetryCandidate>();
+            candidate->k = rollback_k;
+            candidate->W = rollback_W;
+            candidate->rollback = true;
+            candidates.push_back(std::move(candidate));
+        }
+    }
+
+    if (candidates.empty()) {
+        return outcome;
+    }
+
+    int n = static_cast<int>(candidates.size());
+    int budget = values.cplex_threads > 0 ? values.cplex_threads
+               : static_cast<int>(std::thread::hardware_concurrency());
+    int threads = max(1, budget / n);
+
+    LOG_FMT("[RF] 并行重试: k=%d 候选=%d 每个子问题线程=%d\n", k, n, threads);
+
+    auto worker = [&](RFRetryCandidate* candidate) {
+        RFSubproblemOptions options;
+        options.cancel = &candidate->cancel;
+        options.threads = threads;
+        RFSubproblemResult result = SolveRFSubproblem(candidate->k, candidate->W, state, values, lists,
+                                                      candidate->y_solution, candidate->lambda_solution,
+                                                      options);
+        candidate->status = result.status;
+        candidate->objective = result.objective;
+        candidate->cpu_time = result.cpu_time;
+        if (candidate->status == RFSolveStatus::Feasible && !candidate->rollback) {
+            for (auto& other : candidates) {
+                if (other->rollback || other->W > candidate->W) {
+                    other->cancel.Cancel();
+                }
+            }
+        }
+    };
+
+    vector<std::thread> pool;
+    for (auto& candidate : candidates) {
+        pool.emplace_back(worker, candidate.get());
+    }
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    for (auto& candidate : candidates) {
+        outcome.launched++;
+        cpu_time += candidate->cpu_time;
+
+        if (candidate->cancel.Cancelled()) {
+            outcome.cancelled++;
+            continue;
+        }
+        if (candidate->status == RFSolveStatus::Unknown) {
+            continue;
+        }
+
+        bool feasible = candidate->status == RFSolveStatus::Feasible;
+        RFCacheEntry entry;
+        entry.feasible = feasible;
+        entry.objective = candidate->objective;
+        entry.cpu_time = candidate->cpu_time;
+        if (feasible) {
+            entry.y = candidate->y_solution;
+            entry.lambda = candidate->lambda_solution;
+        }
+        cache.Store(candidate->k, candidate->W, state, entry);
+
+        if (feasible && !candidate->rollback &&
+            (outcome.best_W < 0 || candidate->W < outcome.best_W)) {
+            outcome.best_W = candidate->W;
+            y_solution = candidate->y_solution;
+            lambda_solution = candidate->lambda_solution;
+        }
+    }
+
+    if (outcome.best_W > 0) {
+        LOG_FMT("[RF] 并行重试结果: 最小可行窗口 W=%d (中止 %d 个)\n", outcome.best_W, outcome.cancelled);
+    } else {
+        LOG_FMT("[RF] 并行重试结果: 全部不可行 (中止 %d 个)\n", outcome.cancelled);
+    }
+    return outcome;
+}
+
+// 推测求解任务
+// 窗口 k 出现首个 incumbent 时，以其 [k, k+S) 段为临时固定值，
+// 在后台线程提前求解下一窗口 SP(k+S, rf_window)。推测求解自身出现 incumbent 时
+// 可继续向后推测 (next)，链长不超过 values.rf_speculate
+struct RFSpeculation {
+    int k = 0;
+    int W = 0;
+    RFState state;                     // 含临时固定值的状态副本
+    RFSolveStatus status = RFSolveStatus::Unknown;
+    double objective = -1.0;
+    double cpu_time = 0.0;
+    vector<vector<int>> y_solution;
+    vector<vector<int>> lambda_solution;
+    RFCancelHandle cancel;
+    RFIncumbentHandler on_incumbent;   // 向后继续推测
+    unique_ptr<RFSpeculation> next;    // 由本任务的 incumbent 启动的下一窗口推测
+    std::thread worker;
+
+    ~RFSpeculation() {
+        if (worker.joinable()) {
+            cancel.Cancel();
+            worker.join();
+        }
+    }
+};
+
+// 启动推测任务 (在 CPLEX 回调线程中调用)，depth 为允许的剩余链长
+static unique_ptr<RFSpeculation> LaunchSpeculation(
+    int k, const RFState& state,
+    const vector<vector<int>>& y_provisional,
+    const vector<vector<int>>& lambda_provisional,
+    AllValues& values, AllLists& lists,
+    int threads, int depth, std::atomic<int>& launched)
+{
+    int T = values.number_of_periods;
+    int fix_end = min(k + values.rf_step, T);
+
+    auto spec = make_unique<RFSpeculation>();
+    spec->k = fix_end;
+    spec->W = values.rf_window;
+    spec->state = state;
+    for (int t = k; t < fix_end; t++) {
+        for (size_t g = 0; g < spec->state.y_bar.size(); g++) {
+            spec->state.y_bar[g][t] = y_provisional[g][t];
+            spec->state.lambda_bar[g][t] = lambda_provisional[g][t];
+        }
+    }
+    launched++;
+
+    LOG_FMT("[RF] 推测: 以 k=%d 的首个 incumbent 提前求解 k=%d W=%d\n", k, spec->k, spec->W);
+
+    RFSpeculation* task = spec.get();
+    const RFIncumbentHandler* handler = nullptr;
+    if (depth > 1 && task->k + values.rf_step < T) {
+        task->on_incumbent = [task, &values, &lists, threads, depth, &launched](
+                                 const vector<vector<int>>& y, const vector<vector<int>>& lambda) {
+            task->next = LaunchSpeculation(task->k, task->state, y, lambda, values, lists,
+                                           threads, depth - 1, launched);
+        };
+        handler = &task->on_incumbent;
+    }
+
+    task->worker = std::thread([task, &values, &lists, threads, handler]() {
+        RFSubproblemOptions options;
+        options.cancel = &task->cancel;
+        options.threads = threads;
+        options.on_incumbent = handler;
+        RFSubproblemResult result = SolveRFSubproblem(task->k, task->W, task->state, values, lists,
+                                                      task->y_solution, task->lambda_solution, options);
+        task->status = result.status;
+        task->objective = result.objective;
+        task->cpu_time = result.cpu_time;
+    });
+    return spec;
+}
+
+// 结算推测任务
+// 目标子问题为 SP(k, W) 且前缀 [0,k) 与实际固定值一致时等待其结束并采用结论，
+// 链上的下一推测任务接替；否则连同后续链中止并丢弃。无推测任务或未采用时返回 false。
+// 推测求解结论未知 (超时无解、出错) 时不采用，由主循环重新求解
+static bool CollectSpeculation(
+    unique_ptr<RFSpeculation>& spec,
+    int k, int W,
+    const RFState& state,
+    RFCacheEntry& entry,
+    double& cpu_time)
+{
+    if (!spec) {
+        return false;
+    }
+
+    bool match = spec->k == k && spec->W == W;
+    for (int t = 0; t < k && match; t++) {
+        for (size_t g = 0; g < state.y_bar.size() && match; g++) {
+            match = spec->state.y_bar[g][t] == state.y_bar[g][t] &&
+                    spec->state.lambda_bar[g][t] == state.lambda_bar[g][t];
+        }
+    }
+
+    if (!match) {
+        spec->cancel.Cancel();
+    }
+    spec->worker.join();
+    cpu_time += spec->cpu_time;
+
+    if (match && spec->status == RFSolveStatus::Unknown) {
+        // 前缀一致但无确定结论: 后续链以本任务的 incumbent 为前提，一并丢弃
+        LOG_FMT("[RF] 推测未得出结论: k=%d W=%d，重新求解\n", k, W);
+        spec.reset();
+        return false;
+    }
+    if (match) {
+        entry.feasible = spec->status == RFSolveStatus::Feasible;
+        entry.objective = spec->objective;
+        entry.cpu_time = spec->cpu_time;
+        if (entry.feasible) {
+            entry.y = std::move(spec->y_solution);
+            entry.lambda = std::move(spec->lambda_solution);
+        }
+        LOG_FMT("[RF] 推测命中: k=%d W=%d (%s)\n", k, W, entry.feasible ? "可行" : "不可行");
+    } else {
+        LOG_FMT("[RF] 推测作废: 目标 k=%d W=%d 与实际固定值不一致\n", spec->k, spec->W);
+    }
+    // 命中时链上的下一推测任务接替；作废时随本任务一并中止
+    unique_ptr<RFSpeculation> next = match ? std::move(spec->next) : nullptr;
+    spec = std::move(next);
+    return match;
+}
+
 // 最终求解：固定所有 y, lambda，恢复 u 为整数
 static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
                           double& final_objective, double& final_cpu_time) {
@@ -431,16 +931,15 @@ static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
 
     int T = values.number_of_periods;
     vector<vector<int>> y_solution, lambda_solution;
-    double objective = -1.0;
-    double cpu_time = 0.0;
-
-    bool success = SolveRFSubproblem(T, 0, state, values, lists,
-                                      y_solution, lambda_solution, true,
-                                      &objective, &cpu_time);
+    RFSubproblemOptions options;
+    options.is_final = true;
+    RFSubproblemResult result = SolveRFSubproblem(T, 0, state, values, lists,
+                                                  y_solution, lambda_solution, options);
+    bool success = result.status == RFSolveStatus::Feasible;
 
     if (success) {
-        final_objective = objective;
-        final_cpu_time = cpu_time;
+        final_objective = result.objective;
+        final_cpu_time = result.cpu_time;
 
         int total_setups = 0;
         int total_carryovers = 0;
@@ -461,8 +960,10 @@ static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
 // RF 主求解函数
 void SolveRF(AllValues& values, AllLists& lists) {
     LOG("[RF] 启动 Relax-and-Fix 算法");
-    LOG_FMT("[RF] 参数: W=%d S=%d R=%d T=%.1f\n",
-            values.rf_window, values.rf_step, values.rf_retries, values.rf_time);
+    LOG_FMT("[RF] 参数: W=%d S=%d R=%d T=%.1f 重试=%s\n",
+            values.rf_window, values.rf_step, values.rf_retries, values.rf_time,
+            RFRetryModeName(values.rf_retry_mode));
+    g_progress.SetPhase("RF");
 
     auto rf_start = chrono::steady_clock::now();
 
@@ -478,48 +979,123 @@ void SolveRF(AllValues& values, AllLists& lists) {
     int rf_window_expansions = 0;
     int rf_rollbacks = 0;
     int rf_subproblems = 0;
+    int rf_parallel_batches = 0;
+    int rf_parallel_cancelled = 0;
 
+    RFSubproblemCache cache(values, lists);
     vector<vector<int>> y_solution, lambda_solution;
 
+    // 推测 RF: 主求解与各级推测求解均分线程预算
+    std::atomic<int> rf_spec_launched{0};
+    int rf_spec_hits = 0;
+    int main_threads = -1;
+    int spec_threads = -1;
+    unique_ptr<RFSpeculation> speculation;
+    RFIncumbentHandler speculate;
+    RFSubproblemOptions main_options;  // 主求解: 推测开启时限制线程数并挂推测回调
+    if (values.rf_speculate > 0) {
+        int budget = values.cplex_threads > 0 ? values.cplex_threads
+                   : static_cast<int>(std::thread::hardware_concurrency());
+        main_threads = max(1, budget / (values.rf_speculate + 1));
+        spec_threads = main_threads;
+        speculate = [&](const vector<vector<int>>& y, const vector<vector<int>>& lambda) {
+            if (speculation || k + values.rf_step >= T) return;
+            speculation = LaunchSpeculation(k, state, y, lambda, values, lists,
+                                            spec_threads, values.rf_speculate, rf_spec_launched);
+        };
+        main_options.threads = main_threads;
+        main_options.on_incumbent = &speculate;
+    }
+
     // 主循环
     while (k < T) {
         state.iterations++;
         LOG_FMT("[RF] 迭代 %d: k=%d\n", state.iterations, k);
+        g_progress.SetWindow(k, W);
+        g_progress.Emit("window");
+
+        // 截止时间临近或收到中断: 剩余周期合并为一个窗口求解后直接最终求解
+        if (g_interrupt.Requested() || g_deadline.ShouldWrapUp()) {
+            if (g_interrupt.Requested()) {
+                LOG_FMT("[RF] 已中断，剩余周期 [%d,%d) 合并为一个窗口快速补全\n", k, T);
+            } else {
+                g_deadline.MarkWrapUp();
+                LOG_FMT("[RF] 截止时间临近 (剩余 %.1fs)，剩余周期 [%d,%d) 合并为一个窗口\n",
+                        g_deadline.Remaining(), k, T);
+            }
+            speculation.reset();
+            if (SolveRFSubproblemCached(k, T - k, state, values, lists, cache,
+                                        y_solution, lambda_solution,
+                                        rf_subproblems, total_cpu_time)) {
+                FixPeriods(k, T - k, state, y_solution, lambda_solution, T);
+            } else {
+                LOG("[RF] 收尾窗口无可行解，未固定周期不启动 setup");
+            }
+            break;
+        }
 
-        double iter_cpu_time = 0.0;
-        rf_subproblems++;
-        bool feasible = SolveRFSubproblem(k, W, state, values, lists,
-                                           y_solution, lambda_solution,
-                                           false, nullptr, &iter_cpu_time);
-        total_cpu_time += iter_cpu_time;
+        bool feasible = false;
+        bool hopeless = false;  // 预筛判定固定前缀下必然不可行
+        RFCacheEntry spec_entry;
+        if (CollectSpeculation(speculation, k, W, state, spec_entry, total_cpu_time)) {
+            rf_spec_hits++;
+            cache.Store(k, W, state, spec_entry);
+            feasible = spec_entry.feasible;
+            if (feasible) {
+                y_solution = spec_entry.y;
+                lambda_solution = spec_entry.lambda;
+            }
+        } else {
+            feasible = SolveRFSubproblemCached(k, W, state, values, lists, cache,
+                                               y_solution, lambda_solution,
+                                               rf_subproblems, total_cpu_time,
+                                               main_options, &hopeless);
+        }
 
         if (feasible) {
             FixPeriods(k, values.rf_step, state, y_solution, lambda_solution, T);
             k += values.rf_step;
             W = values.rf_window;
+        } else if (g_interrupt.Requested()) {
+            // 求解被中断: 不再扩展或回滚，回到循环顶部补全
+            continue;
         } else {
             // 尝试扩展窗口
             bool resolved = false;
-            for (int r = 0; r < values.rf_retries && !resolved; r++) {
-                W++;
-                rf_window_expansions++;
-                LOG_FMT("[RF] 扩展窗口重试 %d/%d，W=%d\n", r + 1, values.rf_retries, W);
-                iter_cpu_time = 0.0;
-                rf_subproblems++;
-                resolved = SolveRFSubproblem(k, W, state, values, lists,
-                                              y_solution, lambda_solution,
-                                              false, nullptr, &iter_cpu_time);
-                total_cpu_time += iter_cpu_time;
+            if (hopeless) {
+                LOG("[RF] 固定前缀已违反必要条件，跳过窗口扩展直接回滚");
+            } else if (values.rf_retry_mode == RFRetryMode::Sequential) {
+                for (int r = 0; r < values.rf_retries && !resolved && !g_interrupt.Requested(); r++) {
+                    W++;
+                    rf_window_expansions++;
+                    LOG_FMT("[RF] 扩展窗口重试 %d/%d，W=%d\n", r + 1, values.rf_retries, W);
+                    resolved = SolveRFSubproblemCached(k, W, state, values, lists, cache,
+                                                       y_solution, lambda_solution,
+                                                       rf_subproblems, total_cpu_time,
+                                                       main_options);
+                }
+            } else {
+                RFRetryOutcome outcome = SolveRetriesParallel(k, W, state, values, lists, cache,
+                                                              y_solution, lambda_solution,
+                                                              total_cpu_time);
+                rf_parallel_batches++;
+                rf_parallel_cancelled += outcome.cancelled;
+                rf_window_expansions += outcome.expansions;
+                rf_subproblems += outcome.launched;
+                resolved = outcome.best_W > 0;
             }
 
             if (resolved) {
                 FixPeriods(k, values.rf_step, state, y_solution, lambda_solution, T);
                 k += values.rf_step;
                 W = values.rf_window;
-            } else {
+            } else if (!g_interrupt.Requested()) {
                 rf_rollbacks++;
                 if (!Rollback(state, k, W, values.rf_window)) {
                     LOG("[RF] 无法继续，算法终止");
+                    speculation.reset();
+                    values.metrics.rf_cache_hits = cache.Hits();
+                    values.metrics.rf_cache_misses = cache.Misses();
                     values.result_step1.objective = -1;
                     values.result_step1.runtime = -1;
                     values.result_step1.cpu_time = total_cpu_time;
@@ -529,9 +1105,19 @@ void SolveRF(AllValues& values, AllLists& lists) {
         }
     }
 
+    // 最后一个窗口不会再有推测任务，保险起见结束残留任务
+    speculation.reset();
+    rf_subproblems += rf_spec_launched;
+    if (values.rf_speculate > 0) {
+        int launched = rf_spec_launched;
+        LOG_FMT("[RF] 推测: 启动=%d 命中=%d 命中率=%.1f%%\n", launched, rf_spec_hits,
+                launched > 0 ? 100.0 * rf_spec_hits / launched : 0.0);
+    }
+
     // 最终求解
     double final_objective = -1.0;
     double final_cpu_time = 0.0;
+    g_progress.SetPhase("RF-FINAL");
     bool final_success = SolveRFFinal(state, values, lists, final_objective, final_cpu_time);
     total_cpu_time += final_cpu_time;
 
@@ -543,6 +1129,7 @@ void SolveRF(AllValues& values, AllLists& lists) {
         LOG_FMT("[RF] 总迭代: %d\n", state.iterations);
         LOG_FMT("[RF] 总耗时: %.3fs\n", rf_time);
         LOG_FMT("[RF] CPU时间: %.3fs\n", total_cpu_time);
+        LOG_FMT("[RF] 子问题缓存: 命中=%ld 未命中=%ld\n", cache.Hits(), cache.Misses());
         LOG_FMT("[RF] 最终目标: %.2f\n", final_objective);
 
         lists.small_y = state.y_bar;
@@ -551,7 +1138,7 @@ void SolveRF(AllValues& values, AllLists& lists) {
         values.result_step1.objective = final_objective;
         values.result_step1.runtime = rf_time;
         values.result_step1.cpu_time = total_cpu_time;
-        values.result_step1.gap = 0.0;
+        values.result_step1.gap = -1.0;  // 启发式无自身下界，gap 由下界模块计算
 
         // ========== Calculate metrics ==========
         auto& m = values.metrics;
@@ -564,94 +1151,14 @@ void SolveRF(AllValues& values, AllLists& lists) {
         m.rf_avg_subproblem_time = rf_subproblems > 0
             ? (total_cpu_time - final_cpu_time) / rf_subproblems : 0.0;
         m.rf_final_solve_time = final_cpu_time;
-
-        // Cost breakdown (from saved variables)
-        m.cost_production = 0.0;
-        m.cost_setup = 0.0;
-        m.cost_inventory = 0.0;
-        m.cost_backorder = 0.0;
-        m.cost_unmet = 0.0;
-
-        for (int i = 0; i < values.number_of_items; ++i) {
-            for (int t = 0; t < T; ++t) {
-                m.cost_production += lists.cost_x[i] * lists.small_x[i][t];
-                m.cost_backorder += lists.cost_b[i] * lists.small_b[i][t];
-            }
-            m.cost_unmet += lists.cost_u[i] * lists.small_u[i];
-        }
-
-        for (int g = 0; g < values.number_of_groups; ++g) {
-            for (int t = 0; t < T; ++t) {
-                m.cost_setup += lists.cost_y[g] * lists.small_y[g][t];
-            }
-        }
-
-        for (int f = 0; f < values.number_of_flows; ++f) {
-            for (int t = 0; t < T; ++t) {
-                m.cost_inventory += lists.cost_i[f] * lists.small_i[f][t];
-            }
-        }
-
-        // Setup/Carryover statistics
-        m.total_setups = 0;
-        m.total_carryovers = 0;
-        m.saved_setup_cost = 0.0;
-
-        for (int g = 0; g < values.number_of_groups; ++g) {
-            for (int t = 0; t < T; ++t) {
-                if (lists.small_y[g][t] == 1) m.total_setups++;
-                if (lists.small_l[g][t] == 1) {
-                    m.total_carryovers++;
-                    m.saved_setup_cost += lists.cost_y[g];
-                }
-            }
-        }
-
-        // Demand fulfillment
-        m.unmet_count = 0;
-        m.total_backorder = 0.0;
-        m.total_demand = 0.0;
-        int on_time_count = 0;
-
-        for (int i = 0; i < values.number_of_items; ++i) {
-            m.total_demand += lists.final_demand[i];
-            if (lists.small_u[i] > 0.5) {
-                m.unmet_count++;
-            } else {
-                int lw = lists.lw_x[i];
-                if (lw < T && lists.small_b[i][lw] < 0.5) {
-                    on_time_count++;
-                }
-            }
-            int T_last = T - 1;
-            m.total_backorder += lists.small_b[i][T_last];
-        }
-
-        m.unmet_rate = values.number_of_items > 0
-            ? (double)m.unmet_count / values.number_of_items : 0.0;
-        m.on_time_rate = values.number_of_items > 0
-            ? (double)on_time_count / values.number_of_items : 0.0;
-
-        // Capacity utilization
-        m.capacity_util_by_period.resize(T);
-        m.capacity_util_avg = 0.0;
-        m.capacity_util_max = 0.0;
-
-        for (int t = 0; t < T; ++t) {
-            double usage = 0.0;
-            for (int i = 0; i < values.number_of_items; ++i) {
-                usage += lists.usage_x[i] * lists.small_x[i][t];
-            }
-            for (int g = 0; g < values.number_of_groups; ++g) {
-                usage += lists.usage_y[g] * lists.small_y[g][t];
-            }
-            double util = values.machine_capacity > 0
-                ? usage / values.machine_capacity : 0.0;
-            m.capacity_util_by_period[t] = util;
-            m.capacity_util_avg += util;
-            if (util > m.capacity_util_max) m.capacity_util_max = util;
-        }
-        m.capacity_util_avg /= T;
+        m.rf_cache_hits = cache.Hits();
+        m.rf_cache_misses = cache.Misses();
+        m.rf_parallel_batches = rf_parallel_batches;
+        m.rf_parallel_cancelled = rf_parallel_cancelled;
+        m.rf_spec_launched = rf_spec_launched;
+        m.rf_spec_hits = rf_spec_hits;
+
+        ComputePlanMetrics(values, lists);
 
     } else {
         LOG("[RF] 最终求解失败");
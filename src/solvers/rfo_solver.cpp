@@ -5,7 +5,17 @@
 // 第二阶段 FO: 滑动窗口局部优化改进解质量
 
 #include "optimizer.h"
+#include "lot_sizing_model.h"
+#include "lot_sizing_cuts.h"
+#include "plan_metrics.h"
+#include "cplex_pool.h"
+#include "rf_cache.h"
+#include "prescreen.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include "progress.h"
 #include "logger.h"
+#include "subproblem_dump.h"
 
 // ============================================================================
 // RF (Relax-and-Fix) 部分
@@ -21,12 +31,12 @@ static void InitRFState(RFState& state, const AllValues& values) {
     state.period_fixed.assign(T, false);
     state.rollback_stack.clear();
     state.current_k = 0;
-    state.current_W = kRFWindowSize;
+    state.current_W = values.rf_window;  // 使用动态参数
     state.iterations = 0;
 }
 
-// 求解 RF 子问题 SP(k, W)
-static bool SolveRFSubproblem(
+// 求解 RF 子问题 SP(k, W)，返回求解结论 (见 rf_cache.h)
+static RFSolveStatus SolveRFSubproblem(
     int k, int W,
     const RFState& state,
     AllValues& values,
@@ -48,22 +58,28 @@ static bool SolveRFSubproblem(
     LOG_FMT("[RF] 子问题: k=%d W=%d (固定:[0,%d) 窗口:[%d,%d) 放松:[%d,%d))\n",
             k, W, k, k, win_end, rel_start, T);
 
+    // 截止时间调度: 剩余窗口数按 RF 步长估计，最终求解取剩余全部时间
+    double time_limit = is_final
+        ? g_deadline.FinalBudget(values.rf_time)
+        : g_deadline.Budget(values.rf_time, (T - k + values.rf_step - 1) / values.rf_step);
+
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, time_limit);
+        IloEnv env = lease.Env();
         IloModel model(env);
 
-        IloArray<IloNumVarArray> X(env, N);
+        IloArray<IloNumVarArray> X;
         IloArray<IloNumVarArray> Y(env, G);
         IloArray<IloNumVarArray> Lambda(env, G);
         IloArray<IloNumVarArray> I(env, F);
         IloArray<IloNumVarArray> P(env, F);
-        IloArray<IloNumVarArray> B(env, N);
-        IloNumVarArray U(env);
+        IloArray<IloNumVarArray> B;
+        IloNumVarArray U;
 
-        for (int i = 0; i < N; i++) {
-            X[i] = IloNumVarArray(env, T, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, T, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        X = CreateWindowVars(env, lists.ew_x, T);
+        B = CreateWindowVars(env, lists.lw_x, T);
 
         for (int f = 0; f < F; f++) {
             I[f] = IloNumVarArray(env, T, 0, IloInfinity);
@@ -94,6 +110,10 @@ static bool SolveRFSubproblem(
             U = IloNumVarArray(env, N, 0, 1, ILOFLOAT);
         }
 
+        // 变量随环境归还结束 (见 cplex_pool.h)
+        for (auto vars : {X, Y, Lambda, I, P, B}) lease.Own(vars);
+        lease.Own(U);
+
         for (int g = 0; g < G; g++) {
             for (int t = 0; t < k; t++) {
                 model.add(Y[g][t] == state.y_bar[g][t]);
@@ -103,7 +123,7 @@ static bool SolveRFSubproblem(
 
         IloExpr objective(env);
         for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 objective += lists.cost_x[i] * X[i][t];
             }
             // 欠交惩罚 (仅 t >= l_i)
@@ -130,7 +150,7 @@ static bool SolveRFSubproblem(
         // 需求满足
         for (int i = 0; i < N; i++) {
             IloExpr total_production(env);
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -141,6 +161,7 @@ static bool SolveRFSubproblem(
         for (int t = 0; t < T; t++) {
             IloExpr capacity(env);
             for (int i = 0; i < N; i++) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < G; g++) {
@@ -151,25 +172,15 @@ static bool SolveRFSubproblem(
         }
 
         // 产品大类 Big-M 约束
-        for (int g = 0; g < G; g++) {
-            for (int t = 0; t < T; t++) {
-                IloExpr family_production(env);
-                for (int i = 0; i < N; i++) {
-                    if (lists.group_flag[i][g]) {
-                        family_production += lists.usage_x[i] * X[i][t];
-                    }
-                }
-                model.add(family_production <= values.machine_capacity * (Y[g][t] + Lambda[g][t]));
-                family_production.end();
-            }
-        }
+        AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                                  values.machine_capacity);
 
         // 下游流平衡
         for (int f = 0; f < F; f++) {
             for (int t = 0; t < T; t++) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < N; i++) {
-                    if (lists.flow_flag[i][f]) {
+                    if (lists.flow_flag[i][f] && t >= lists.ew_x[i]) {
                         flow_production += X[i][t];
                     }
                 }
@@ -189,27 +200,18 @@ static bool SolveRFSubproblem(
             }
         }
 
-        // 最早生产期约束 (仅约束 t < e_i)
-        for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
-                if (t < lists.ew_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
-            }
-        }
+        // 最早生产期约束 - t < e_i 的 x_it 不创建 (时间窗稀疏变量)
 
         // 欠交定义
         for (int i = 0; i < N; i++) {
             for (int t = 0; t < T; t++) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -240,25 +242,31 @@ static bool SolveRFSubproblem(
             }
         }
         // 约束9: Carryover排他性
-        for (int g = 0; g < G; g++) {
-            for (int t = 1; t < T; t++) {
-                IloExpr sum_other_y(env);
-                for (int g2 = 0; g2 < G; g2++) {
-                    if (g2 != g) {
-                        sum_other_y += Y[g2][t];
-                    }
-                }
-                model.add(Lambda[g][t] + Lambda[g][t-1] + Y[g][t] - sum_other_y <= 2);
-                sum_other_y.end();
-            }
-        }
-
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, kRFSubproblemTimeLimit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        lease.Own(AddCarryoverExclusivity(env, model, values, Y, Lambda, G, T));
+
+        // 子问题转储: y/lambda 须在装载前命名
+        if (SubproblemDumpEnabled(values)) {
+            NameSetupVars(Y, Lambda, G, T);
+        }
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, is_final ? "rf_final" : "rf_window");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = is_final ? "rf_final" : "rf_window";
+            dump.k = k;
+            dump.W = W;
+            dump.win_begin = k;
+            dump.win_end = win_end;
+            dump.time_limit = time_limit;
+            dump.threads = values.cplex_threads;
+            DumpSubproblem(cplex, values, dump);
+        }
+
+        // 用户割平面: 放松段 y/lambda 为连续变量，只在 t < win_end 上分离
+        auto cut_callback = AttachLotSizingCuts(cplex, kCutScopeRF, env, values, lists,
+                                                X, Y, Lambda, B, values.machine_capacity, win_end);
+        auto progress = AttachProgress(cplex, cut_callback.get(),
+                                       IloCplex::Callback::Context::Id::Relaxation);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -267,11 +275,16 @@ static bool SolveRFSubproblem(
         LOG("\n=============== CPLEX START ===============");
 
         bool solved = cplex.solve();
+        RecordSolveEffort(values, cplex);
+        if (!is_final) {
+            g_deadline.RecordSolve(cplex.getTime());
+        }
 
         // 求解后关闭CPLEX输出并刷新
         cplex.setOut(env.getNullStream());
         if (g_logger) g_logger->Flush();
         LOG("=============== CPLEX END =================");
+        RecordCutStats(values, "[RF]", cut_callback.get());
         LOG_RAW("\n");
 
         bool has_incumbent = false;
@@ -282,7 +295,8 @@ static bool SolveRFSubproblem(
             has_incumbent = false;
         }
 
-        if (solved && has_incumbent) {
+        RFSolveStatus status = ClassifyRFSolve(cplex, solved && has_incumbent);
+        if (status == RFSolveStatus::Feasible) {
             double obj_value = cplex.getObjValue();
             double cpu_time = cplex.getTime();
             LOG_FMT("  [RF] 求解成功: 目标=%.2f\n", obj_value);
@@ -299,21 +313,19 @@ static bool SolveRFSubproblem(
                     lambda_solution[g][t] = (cplex.getValue(Lambda[g][t]) > 0.5) ? 1 : 0;
                 }
             }
-
-            env.end();
-            return true;
+        } else if (status == RFSolveStatus::Infeasible) {
+            LOG("  [RF] 子问题不可行");
         } else {
-            LOG("  [RF] 求解失败或无可行解");
-            env.end();
-            return false;
+            LOG("  [RF] 求解失败或无可行解 (未证明不可行)");
         }
+        return status;
 
     } catch (IloException& e) {
         LOG_FMT("  [RF] CPLEX错误: %s\n", e.getMessage());
-        return false;
+        return RFSolveStatus::Unknown;
     } catch (...) {
         LOG("  [RF] 未知错误");
-        return false;
+        return RFSolveStatus::Unknown;
     }
 }
 
@@ -339,7 +351,7 @@ static void FixPeriods(int k, int S, RFState& state,
 }
 
 // 回滚
-static bool Rollback(RFState& state, int& k, int& W) {
+static bool Rollback(RFState& state, int& k, int& W, int rf_window) {
     if (state.rollback_stack.empty()) {
         LOG("  [RF] 回滚栈为空");
         return false;
@@ -361,12 +373,60 @@ static bool Rollback(RFState& state, int& k, int& W) {
     }
 
     k = start_t;
-    W = kRFWindowSize + 2;
+    W = rf_window + 2;  // 使用动态参数
 
     LOG_FMT("  [RF] 回滚至周期 %d\n", k);
     return true;
 }
 
+// 带缓存的子问题求解: 命中时直接返回已知结论 (含不可行)；
+// 未命中时先预筛固定前缀 [0,k)，必然不可行则不调用 CPLEX；结论未知的求解不写入缓存
+static bool SolveRFSubproblemCached(
+    int k, int W,
+    const RFState& state,
+    AllValues& values,
+    AllLists& lists,
+    RFSubproblemCache& cache,
+    vector<vector<int>>& y_solution,
+    vector<vector<int>>& lambda_solution,
+    double& cpu_time)
+{
+    RFCacheEntry entry;
+    if (cache.Lookup(k, W, state, entry)) {
+        LOG_FMT("  [RF] 缓存命中: k=%d W=%d (%s)\n", k, W, entry.feasible ? "可行" : "不可行");
+        if (entry.feasible) {
+            y_solution = entry.y;
+            lambda_solution = entry.lambda;
+        }
+        return entry.feasible;
+    }
+
+    vector<bool> fixed(values.number_of_periods, false);
+    for (int t = 0; t < k; t++) {
+        fixed[t] = true;
+    }
+    if (!PrescreenSubproblem(values, lists, state.y_bar, state.lambda_bar, fixed, "  [RF]").feasible) {
+        cache.Store(k, W, state, entry);
+        return false;
+    }
+
+    double iter_cpu_time = 0.0;
+    RFSolveStatus status = SolveRFSubproblem(k, W, state, values, lists,
+                                             y_solution, lambda_solution,
+                                             false, &entry.objective, &iter_cpu_time);
+    cpu_time += iter_cpu_time;
+    entry.feasible = status == RFSolveStatus::Feasible;
+    entry.cpu_time = iter_cpu_time;
+    if (entry.feasible) {
+        entry.y = y_solution;
+        entry.lambda = lambda_solution;
+    }
+    if (status != RFSolveStatus::Unknown) {
+        cache.Store(k, W, state, entry);
+    }
+    return entry.feasible;
+}
+
 // RF 最终求解
 static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
                           double& final_objective, double& final_cpu_time) {
@@ -379,7 +439,7 @@ static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
 
     bool success = SolveRFSubproblem(T, 0, state, values, lists,
                                       y_solution, lambda_solution, true,
-                                      &objective, &cpu_time);
+                                      &objective, &cpu_time) == RFSolveStatus::Feasible;
 
     if (success) {
         final_objective = objective;
@@ -393,50 +453,74 @@ static bool SolveRFFinal(RFState& state, AllValues& values, AllLists& lists,
 static bool RunRFPhase(AllValues& values, AllLists& lists, RFState& state,
                        double& rf_objective, double& rf_cpu_time) {
     LOG("\n[RF] 启动 Relax-and-Fix 阶段");
-    LOG_FMT("[RF] 参数: W=%d S=%d R=%d\n", kRFWindowSize, kRFFixStep, kRFMaxRetries);
+    g_progress.SetPhase("RF");
+    LOG_FMT("[RF] 参数: W=%d S=%d R=%d\n", values.rf_window, values.rf_step, values.rf_retries);
 
     InitRFState(state, values);
 
     int T = values.number_of_periods;
     int k = 0;
-    int W = kRFWindowSize;
+    int W = values.rf_window;  // 使用动态参数
     double total_cpu_time = 0.0;
 
+    RFSubproblemCache cache(values, lists);
     vector<vector<int>> y_solution, lambda_solution;
 
     while (k < T) {
         state.iterations++;
         LOG_FMT("\n[RF] 迭代 %d: k=%d\n", state.iterations, k);
+        g_progress.SetWindow(k, W);
+        g_progress.Emit("window");
 
-        double iter_cpu_time = 0.0;
-        bool feasible = SolveRFSubproblem(k, W, state, values, lists,
-                                           y_solution, lambda_solution,
-                                           false, nullptr, &iter_cpu_time);
-        total_cpu_time += iter_cpu_time;
+        // 截止时间临近或收到中断: 剩余周期合并为一个窗口求解后直接最终求解
+        if (g_interrupt.Requested() || g_deadline.ShouldWrapUp()) {
+            if (g_interrupt.Requested()) {
+                LOG_FMT("[RF] 已中断，剩余周期 [%d,%d) 合并为一个窗口快速补全\n", k, T);
+            } else {
+                g_deadline.MarkWrapUp();
+                LOG_FMT("[RF] 截止时间临近 (剩余 %.1fs)，剩余周期 [%d,%d) 合并为一个窗口\n",
+                        g_deadline.Remaining(), k, T);
+            }
+            if (SolveRFSubproblemCached(k, T - k, state, values, lists, cache,
+                                        y_solution, lambda_solution,
+                                        total_cpu_time)) {
+                FixPeriods(k, T - k, state, y_solution, lambda_solution, T);
+            } else {
+                LOG("[RF] 收尾窗口无可行解，未固定周期不启动 setup");
+            }
+            break;
+        }
+
+        bool feasible = SolveRFSubproblemCached(k, W, state, values, lists, cache,
+                                                y_solution, lambda_solution,
+                                                total_cpu_time);
 
         if (feasible) {
-            FixPeriods(k, kRFFixStep, state, y_solution, lambda_solution, T);
-            k += kRFFixStep;
-            W = kRFWindowSize;
+            FixPeriods(k, values.rf_step, state, y_solution, lambda_solution, T);
+            k += values.rf_step;
+            W = values.rf_window;
+        } else if (g_interrupt.Requested()) {
+            // 求解被中断: 不再扩展或回滚，回到循环顶部补全
+            continue;
         } else {
             bool resolved = false;
-            for (int r = 0; r < kRFMaxRetries && !resolved; r++) {
+            for (int r = 0; r < values.rf_retries && !resolved && !g_interrupt.Requested(); r++) {
                 W++;
-                LOG_FMT("  [RF] 扩展窗口重试 %d/%d\n", r + 1, kRFMaxRetries);
-                iter_cpu_time = 0.0;
-                resolved = SolveRFSubproblem(k, W, state, values, lists,
-                                              y_solution, lambda_solution,
-                                              false, nullptr, &iter_cpu_time);
-                total_cpu_time += iter_cpu_time;
+                LOG_FMT("  [RF] 扩展窗口重试 %d/%d\n", r + 1, values.rf_retries);
+                resolved = SolveRFSubproblemCached(k, W, state, values, lists, cache,
+                                                   y_solution, lambda_solution,
+                                                   total_cpu_time);
             }
 
             if (resolved) {
-                FixPeriods(k, kRFFixStep, state, y_solution, lambda_solution, T);
-                k += kRFFixStep;
-                W = kRFWindowSize;
-            } else {
-                if (!Rollback(state, k, W)) {
+                FixPeriods(k, values.rf_step, state, y_solution, lambda_solution, T);
+                k += values.rf_step;
+                W = values.rf_window;
+            } else if (!g_interrupt.Requested()) {
+                if (!Rollback(state, k, W, values.rf_window)) {
                     LOG("[RF] 算法终止");
+                    values.metrics.rf_cache_hits = cache.Hits();
+                    values.metrics.rf_cache_misses = cache.Misses();
                     rf_cpu_time = total_cpu_time;
                     return false;
                 }
@@ -444,7 +528,12 @@ static bool RunRFPhase(AllValues& values, AllLists& lists, RFState& state,
         }
     }
 
+    values.metrics.rf_cache_hits = cache.Hits();
+    values.metrics.rf_cache_misses = cache.Misses();
+    LOG_FMT("[RF] 子问题缓存: 命中=%ld 未命中=%ld\n", cache.Hits(), cache.Misses());
+
     double final_obj = -1.0, final_cpu = 0.0;
+    g_progress.SetPhase("RF-FINAL");
     bool final_success = SolveRFFinal(state, values, lists, final_obj, final_cpu);
     total_cpu_time += final_cpu;
 
@@ -478,35 +567,55 @@ static bool SolveFOSubproblem(
     vector<vector<int>>& y_solution,
     vector<vector<int>>& lambda_solution,
     double* objective_out = nullptr,
-    double* cpu_time_out = nullptr)
+    double* cpu_time_out = nullptr,
+    int remaining_windows = 1)
 {
     int G = values.number_of_groups;
     int T = values.number_of_periods;
     int N = values.number_of_items;
     int F = values.number_of_flows;
 
-    // 计算扩展窗口 WND+(a)
-    int wnd_start = max(0, a - kFOBoundaryBuffer);
-    int wnd_end = min(T, a + kFOWindowSize + kFOBoundaryBuffer);
+    // 计算扩展窗口 WND+(a)，冻结周期不进入窗口
+    int wnd_start = max(fo_state.frozen_until, a - values.fo_buffer);
+    int wnd_end = min(T, a + values.fo_window + values.fo_buffer);
+    if (wnd_start >= wnd_end) {
+        return false;
+    }
 
     LOG_FMT("  [FO] 子问题: a=%d WND+=[%d,%d)\n", a, wnd_start, wnd_end);
 
+    // 预筛: 窗口外 (y, lambda) 固定为当前解
+    vector<bool> fixed(T, true);
+    for (int t = wnd_start; t < wnd_end; t++) {
+        fixed[t] = false;
+    }
+    if (!PrescreenSubproblem(values, lists, fo_state.y_current, fo_state.lambda_current,
+                             fixed, "  [FO]").feasible) {
+        return false;
+    }
+
+    // 截止时间调度: 本轮剩余窗口均分可用时间
+    double time_limit = g_deadline.Budget(values.fo_time, remaining_windows);
+
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, time_limit);
+        IloEnv env = lease.Env();
         IloModel model(env);
 
-        IloArray<IloNumVarArray> X(env, N);
         IloArray<IloNumVarArray> Y(env, G);
         IloArray<IloNumVarArray> Lambda(env, G);
         IloArray<IloNumVarArray> I(env, F);
         IloArray<IloNumVarArray> P(env, F);
-        IloArray<IloNumVarArray> B(env, N);
         IloNumVarArray U(env, N, 0, 1, ILOBOOL);  // FO中u为整数
 
-        for (int i = 0; i < N; i++) {
-            X[i] = IloNumVarArray(env, T, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, T, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        IloArray<IloNumVarArray> X = CreateWindowVars(env, lists.ew_x, T);
+        IloArray<IloNumVarArray> B = CreateWindowVars(env, lists.lw_x, T);
+
+        // 变量随环境归还结束 (见 cplex_pool.h)；Y、Lambda、I、P 的行在下面创建
+        for (auto vars : {X, Y, Lambda, I, P, B}) lease.Own(vars);
+        lease.Own(U);
 
         for (int f = 0; f < F; f++) {
             I[f] = IloNumVarArray(env, T, 0, IloInfinity);
@@ -544,7 +653,7 @@ static bool SolveFOSubproblem(
         // 目标函数
         IloExpr objective(env);
         for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 objective += lists.cost_x[i] * X[i][t];
             }
             // 欠交惩罚 (仅 t >= l_i)
@@ -572,7 +681,7 @@ static bool SolveFOSubproblem(
         // 需求满足
         for (int i = 0; i < N; i++) {
             IloExpr total_production(env);
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -583,6 +692,7 @@ static bool SolveFOSubproblem(
         for (int t = 0; t < T; t++) {
             IloExpr capacity(env);
             for (int i = 0; i < N; i++) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < G; g++) {
@@ -593,25 +703,15 @@ static bool SolveFOSubproblem(
         }
 
         // 产品大类 Big-M 约束
-        for (int g = 0; g < G; g++) {
-            for (int t = 0; t < T; t++) {
-                IloExpr family_production(env);
-                for (int i = 0; i < N; i++) {
-                    if (lists.group_flag[i][g]) {
-                        family_production += lists.usage_x[i] * X[i][t];
-                    }
-                }
-                model.add(family_production <= values.machine_capacity * (Y[g][t] + Lambda[g][t]));
-                family_production.end();
-            }
-        }
+        AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                                  values.machine_capacity);
 
         // 下游流平衡
         for (int f = 0; f < F; f++) {
             for (int t = 0; t < T; t++) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < N; i++) {
-                    if (lists.flow_flag[i][f]) {
+                    if (lists.flow_flag[i][f] && t >= lists.ew_x[i]) {
                         flow_production += X[i][t];
                     }
                 }
@@ -631,27 +731,18 @@ static bool SolveFOSubproblem(
             }
         }
 
-        // 最早生产期约束 (仅约束 t < e_i)
-        for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
-                if (t < lists.ew_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
-            }
-        }
+        // 最早生产期约束 - t < e_i 的 x_it 不创建 (时间窗稀疏变量)
 
         // 欠交定义
         for (int i = 0; i < N; i++) {
             for (int t = 0; t < T; t++) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -682,25 +773,33 @@ static bool SolveFOSubproblem(
             }
         }
         // 约束9: Carryover排他性
-        for (int g = 0; g < G; g++) {
-            for (int t = 1; t < T; t++) {
-                IloExpr sum_other_y(env);
-                for (int g2 = 0; g2 < G; g2++) {
-                    if (g2 != g) {
-                        sum_other_y += Y[g2][t];
-                    }
-                }
-                model.add(Lambda[g][t] + Lambda[g][t-1] + Y[g][t] - sum_other_y <= 2);
-                sum_other_y.end();
-            }
-        }
-
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, kFOSubproblemTimeLimit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        lease.Own(AddCarryoverExclusivity(env, model, values, Y, Lambda, G, T));
+
+        // 子问题转储: y/lambda 须在装载前命名
+        if (SubproblemDumpEnabled(values)) {
+            NameSetupVars(Y, Lambda, G, T);
+        }
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "fo_window");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = "fo_window";
+            dump.k = a;
+            dump.W = values.fo_window;
+            dump.win_begin = wnd_start;
+            dump.win_end = wnd_end;
+            dump.time_limit = time_limit;
+            dump.threads = values.cplex_threads;
+            dump.start_y = &fo_state.y_current;
+            dump.start_lambda = &fo_state.lambda_current;
+            DumpSubproblem(cplex, values, dump);
+        }
+
+        // 用户割平面: 窗口外变量固定为整数值，全部周期均可分离
+        auto cut_callback = AttachLotSizingCuts(cplex, kCutScopeFO, env, values, lists,
+                                                X, Y, Lambda, B, values.machine_capacity, T);
+        auto progress = AttachProgress(cplex, cut_callback.get(),
+                                       IloCplex::Callback::Context::Id::Relaxation);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -709,11 +808,14 @@ static bool SolveFOSubproblem(
         LOG("\n=============== CPLEX START ===============");
 
         bool solved = cplex.solve();
+        RecordSolveEffort(values, cplex);
+        g_deadline.RecordSolve(cplex.getTime());
 
         // 求解后关闭CPLEX输出并刷新
         cplex.setOut(env.getNullStream());
         if (g_logger) g_logger->Flush();
         LOG("=============== CPLEX END =================");
+        RecordCutStats(values, "  [FO]", cut_callback.get());
         LOG_RAW("\n");
 
         bool has_incumbent = false;
@@ -742,11 +844,9 @@ static bool SolveFOSubproblem(
                 }
             }
 
-            env.end();
             return true;
         } else {
             LOG("  [FO] 求解失败");
-            env.end();
             return false;
         }
 
@@ -759,34 +859,55 @@ static bool SolveFOSubproblem(
     }
 }
 
-// FO 主循环
-static void RunFOPhase(AllValues& values, AllLists& lists,
-                       const RFState& rf_state, double rf_objective,
-                       FOState& fo_state, double& fo_cpu_time) {
-    LOG("\n[FO] 启动 Fix-and-Optimize 阶段");
-    LOG_FMT("[FO] 参数: W_o=%d S_o=%d H=%d Delta=%d\n",
-            kFOWindowSize, kFOStep, kFOMaxRounds, kFOBoundaryBuffer);
-
-    InitFOState(fo_state, rf_state, rf_objective);
-    fo_cpu_time = 0.0;
+// 核心窗口 [a, a+W_o) 是否含活跃周期
+static bool FOWindowActive(const FOState& fo_state, int a, int T, int fo_window) {
+    if (fo_state.period_active.empty()) {
+        return true;
+    }
+    for (int t = a; t < min(T, a + fo_window); t++) {
+        if (fo_state.period_active[t]) return true;
+    }
+    return false;
+}
 
+// FO 滑动窗口轮次 (fo_state 已初始化)
+static void RunFOWindows(AllValues& values, AllLists& lists,
+                         FOState& fo_state, double& fo_cpu_time) {
     int T = values.number_of_periods;
 
-    for (int h = 1; h <= kFOMaxRounds; h++) {
-        LOG_FMT("\n[FO] 轮次 %d/%d\n", h, kFOMaxRounds);
+    for (int h = 1; h <= values.fo_rounds; h++) {
+        LOG_FMT("\n[FO] 轮次 %d/%d\n", h, values.fo_rounds);
+        g_progress.SetRound(h);
 
         bool improved_in_round = false;
         int windows_in_round = 0;
 
-        // 滑动窗口
-        for (int a = 0; a < T; a += kFOStep) {
+        // 滑动窗口 (跳过冻结周期与不含活跃周期的窗口)
+        for (int a = fo_state.frozen_until; a < T; a += values.fo_step) {
+            if (!FOWindowActive(fo_state, a, T, values.fo_window)) {
+                continue;
+            }
+            // 截止时间临近或收到中断: 停止改进，保留当前解进入收尾求解
+            if (g_interrupt.Requested()) {
+                LOG("  [FO] 已中断，停止局部优化");
+                break;
+            }
+            if (g_deadline.ShouldWrapUp()) {
+                g_deadline.MarkWrapUp();
+                LOG_FMT("  [FO] 截止时间临近 (剩余 %.1fs)，停止局部优化\n", g_deadline.Remaining());
+                break;
+            }
+
             windows_in_round++;
+            g_progress.SetWindow(a, values.fo_window);
+            g_progress.Emit("window");
             vector<vector<int>> y_solution, lambda_solution;
             double obj = -1.0, cpu = 0.0;
 
             bool feasible = SolveFOSubproblem(a, fo_state, values, lists,
                                                y_solution, lambda_solution,
-                                               &obj, &cpu);
+                                               &obj, &cpu,
+                                               (T - a + values.fo_step - 1) / values.fo_step);
             fo_cpu_time += cpu;
 
             if (feasible && obj < fo_state.current_objective - 1e-6) {
@@ -799,6 +920,7 @@ static void RunFOPhase(AllValues& values, AllLists& lists,
                 fo_state.lambda_current = lambda_solution;
                 fo_state.current_objective = obj;
                 fo_state.windows_improved++;
+                g_progress.EmitSolver("improve", obj, -1.0, 0, true);
                 improved_in_round = true;
             }
         }
@@ -811,9 +933,27 @@ static void RunFOPhase(AllValues& values, AllLists& lists,
             LOG("[FO] 无改进，提前终止");
             break;
         }
+        if (g_deadline.WrappedUp() || g_interrupt.Requested()) {
+            break;
+        }
     }
 }
 
+// FO 主循环
+static void RunFOPhase(AllValues& values, AllLists& lists,
+                       const RFState& rf_state, double rf_objective,
+                       FOState& fo_state, double& fo_cpu_time) {
+    LOG("\n[FO] 启动 Fix-and-Optimize 阶段");
+    g_progress.SetPhase("FO");
+    LOG_FMT("[FO] 参数: W_o=%d S_o=%d H=%d Delta=%d\n",
+            values.fo_window, values.fo_step, values.fo_rounds, values.fo_buffer);
+
+    InitFOState(fo_state, rf_state, rf_objective);
+    fo_cpu_time = 0.0;
+
+    RunFOWindows(values, lists, fo_state, fo_cpu_time);
+}
+
 // FO 最终收尾求解
 static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
                           double& final_objective, double& final_cpu_time) {
@@ -824,22 +964,27 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
     int N = values.number_of_items;
     int F = values.number_of_flows;
 
+    double time_limit = g_deadline.FinalBudget(values.rf_time);
+
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, time_limit);
+        IloEnv env = lease.Env();
         IloModel model(env);
 
-        IloArray<IloNumVarArray> X(env, N);
         IloArray<IloNumVarArray> Y(env, G);
         IloArray<IloNumVarArray> Lambda(env, G);
         IloArray<IloNumVarArray> I(env, F);
         IloArray<IloNumVarArray> P(env, F);
-        IloArray<IloNumVarArray> B(env, N);
         IloNumVarArray U(env, N, 0, 1, ILOBOOL);
 
-        for (int i = 0; i < N; i++) {
-            X[i] = IloNumVarArray(env, T, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, T, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        IloArray<IloNumVarArray> X = CreateWindowVars(env, lists.ew_x, T);
+        IloArray<IloNumVarArray> B = CreateWindowVars(env, lists.lw_x, T);
+
+        // 变量随环境归还结束 (见 cplex_pool.h)；Y、Lambda、I、P 的行在下面创建
+        for (auto vars : {X, Y, Lambda, I, P, B}) lease.Own(vars);
+        lease.Own(U);
 
         for (int f = 0; f < F; f++) {
             I[f] = IloNumVarArray(env, T, 0, IloInfinity);
@@ -861,7 +1006,7 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
         // 目标函数
         IloExpr objective(env);
         for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 objective += lists.cost_x[i] * X[i][t];
             }
             // 欠交惩罚 (仅 t >= l_i)
@@ -888,7 +1033,7 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
         // 约束 (同上)
         for (int i = 0; i < N; i++) {
             IloExpr total_production(env);
-            for (int t = 0; t < T; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < T; t++) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -898,6 +1043,7 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
         for (int t = 0; t < T; t++) {
             IloExpr capacity(env);
             for (int i = 0; i < N; i++) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < G; g++) {
@@ -907,24 +1053,15 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
             capacity.end();
         }
 
-        for (int g = 0; g < G; g++) {
-            for (int t = 0; t < T; t++) {
-                IloExpr family_production(env);
-                for (int i = 0; i < N; i++) {
-                    if (lists.group_flag[i][g]) {
-                        family_production += lists.usage_x[i] * X[i][t];
-                    }
-                }
-                model.add(family_production <= values.machine_capacity * (Y[g][t] + Lambda[g][t]));
-                family_production.end();
-            }
-        }
+        // t > l_i 的生产在下方禁止，Big-M 只计入窗口仍开放的订单
+        AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                                  values.machine_capacity, nullptr, true);
 
         for (int f = 0; f < F; f++) {
             for (int t = 0; t < T; t++) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < N; i++) {
-                    if (lists.flow_flag[i][f]) {
+                    if (lists.flow_flag[i][f] && t >= lists.ew_x[i]) {
                         flow_production += X[i][t];
                     }
                 }
@@ -943,11 +1080,10 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
             }
         }
 
+        // t < e_i 的 x_it 未创建 (时间窗稀疏变量)，t > l_i 的生产以上界 0 禁止
         for (int i = 0; i < N; i++) {
-            for (int t = 0; t < T; t++) {
-                if (t < lists.ew_x[i] || t > lists.lw_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
+            for (int t = max(lists.ew_x[i], lists.lw_x[i] + 1); t < T; t++) {
+                X[i][t].setUB(0);
             }
         }
 
@@ -955,13 +1091,11 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
             for (int t = 0; t < T; t++) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -991,25 +1125,28 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
             }
         }
         // 约束9: Carryover排他性
-        for (int g = 0; g < G; g++) {
-            for (int t = 1; t < T; t++) {
-                IloExpr sum_other_y(env);
-                for (int g2 = 0; g2 < G; g2++) {
-                    if (g2 != g) {
-                        sum_other_y += Y[g2][t];
-                    }
-                }
-                model.add(Lambda[g][t] + Lambda[g][t-1] + Y[g][t] - sum_other_y <= 2);
-                sum_other_y.end();
-            }
+        lease.Own(AddCarryoverExclusivity(env, model, values, Y, Lambda, G, T));
+
+        // 子问题转储: y/lambda 须在装载前命名
+        if (SubproblemDumpEnabled(values)) {
+            NameSetupVars(Y, Lambda, G, T);
+        }
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "fo_final");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = "fo_final";
+            dump.k = T;
+            dump.time_limit = time_limit;
+            dump.threads = values.cplex_threads;
+            DumpSubproblem(cplex, values, dump);
         }
 
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, kRFSubproblemTimeLimit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        // 用户割平面 (见 lot_sizing_cuts.h)
+        auto cut_callback = AttachLotSizingCuts(cplex, kCutScopeFO, env, values, lists,
+                                                X, Y, Lambda, B, values.machine_capacity, T);
+        auto progress = AttachProgress(cplex, cut_callback.get(),
+                                       IloCplex::Callback::Context::Id::Relaxation);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -1018,11 +1155,13 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
         LOG("\n=============== CPLEX START ===============");
 
         bool solved = cplex.solve();
+        RecordSolveEffort(values, cplex);
 
         // 求解后关闭CPLEX输出并刷新
         cplex.setOut(env.getNullStream());
         if (g_logger) g_logger->Flush();
         LOG("=============== CPLEX END =================");
+        RecordCutStats(values, "[FO]", cut_callback.get());
         LOG_RAW("\n");
 
         if (solved) {
@@ -1031,32 +1170,10 @@ static bool SolveFOFinal(FOState& fo_state, AllValues& values, AllLists& lists,
             LOG_FMT("[FO] 最终目标: %.2f\n", final_objective);
 
             // Save X, I, B, U to AllLists for JSON output
-            lists.small_x.resize(N);
-            lists.small_b.resize(N);
-            lists.small_u.resize(N);
-            lists.small_i.resize(F);
+            ExtractFinalPlan(cplex, values, lists, X, B, I, U);
 
-            for (int i = 0; i < N; i++) {
-                lists.small_x[i].resize(T);
-                lists.small_b[i].resize(T);
-                for (int t = 0; t < T; t++) {
-                    lists.small_x[i][t] = cplex.getValue(X[i][t]);
-                    lists.small_b[i][t] = cplex.getValue(B[i][t]);
-                }
-                lists.small_u[i] = cplex.getValue(U[i]);
-            }
-
-            for (int f = 0; f < F; f++) {
-                lists.small_i[f].resize(T);
-                for (int t = 0; t < T; t++) {
-                    lists.small_i[f][t] = cplex.getValue(I[f][t]);
-                }
-            }
-
-            env.end();
             return true;
         } else {
-            env.end();
             return false;
         }
 
@@ -1110,6 +1227,7 @@ void SolveRFO(AllValues& values, AllLists& lists) {
     double final_objective = -1.0;
     double final_cpu_time = 0.0;
 
+    g_progress.SetPhase("FO-FINAL");
     bool final_success = SolveFOFinal(fo_state, values, lists,
                                        final_objective, final_cpu_time);
 
@@ -1128,7 +1246,7 @@ void SolveRFO(AllValues& values, AllLists& lists) {
     }
     values.result_step1.runtime = rfo_wall_time;
     values.result_step1.cpu_time = total_cpu_time;
-    values.result_step1.gap = 0.0;
+    values.result_step1.gap = -1.0;  // 启发式无自身下界，gap 由下界模块计算
 
     // 计算改进
     double improvement = rf_objective - values.result_step1.objective;
@@ -1137,7 +1255,6 @@ void SolveRFO(AllValues& values, AllLists& lists) {
 
     // ========== Calculate metrics ==========
     auto& m = values.metrics;
-    int T = values.number_of_periods;
 
     // RFO-specific metrics
     m.rfo_rf_objective = rf_objective;
@@ -1149,100 +1266,100 @@ void SolveRFO(AllValues& values, AllLists& lists) {
     m.rfo_fo_time = fo_cpu_time;
     m.rfo_final_solve_time = final_cpu_time;
 
-    // Cost breakdown (from saved variables)
-    m.cost_production = 0.0;
-    m.cost_setup = 0.0;
-    m.cost_inventory = 0.0;
-    m.cost_backorder = 0.0;
-    m.cost_unmet = 0.0;
+    ComputePlanMetrics(values, lists);
 
-    for (int i = 0; i < values.number_of_items; ++i) {
-        for (int t = 0; t < T; ++t) {
-            m.cost_production += lists.cost_x[i] * lists.small_x[i][t];
-            m.cost_backorder += lists.cost_b[i] * lists.small_b[i][t];
-        }
-        m.cost_unmet += lists.cost_u[i] * lists.small_u[i];
-    }
+    LOG("\n========================================");
+    LOG("[RFO] 算法完成");
+    LOG("========================================");
+    LOG_FMT("[RFO] RF目标:   %.2f\n", rf_objective);
+    LOG_FMT("[RFO] 最终目标: %.2f\n", values.result_step1.objective);
+    LOG_FMT("[RFO] 改进:     %.2f (%.2f%%)\n", improvement, improvement_pct);
+    LOG_FMT("[RFO] 总耗时:   %.2f秒\n", rfo_wall_time);
+    LOG_FMT("[RFO] CPU时间:  %.2f秒\n", total_cpu_time);
+}
 
-    for (int g = 0; g < values.number_of_groups; ++g) {
-        for (int t = 0; t < T; ++t) {
-            m.cost_setup += lists.cost_y[g] * lists.small_y[g][t];
-        }
+// ============================================================================
+// 滚动重排程入口
+// ============================================================================
+
+void SolveReplan(AllValues& values, AllLists& lists, const ReplanWarmStart& warm) {
+    LOG("\n========================================");
+    LOG("[重排程] 以旧计划暖启动，只优化受影响周期");
+    LOG("========================================");
+
+    auto replan_start = chrono::steady_clock::now();
+    auto& m = values.metrics;
+
+    FOState fo_state;
+    fo_state.y_current = warm.y;
+    fo_state.lambda_current = warm.lambda;
+    fo_state.current_objective = -1.0;
+    fo_state.rounds_completed = 0;
+    fo_state.windows_improved = 0;
+    fo_state.frozen_until = warm.frozen;
+    fo_state.period_active = warm.active;
+
+    // 阶段1: 固定映射后的 (y, lambda) 求解剩余 LP，得到暖启动目标
+    g_progress.SetPhase("REPLAN");
+    double warm_objective = -1.0;
+    double warm_cpu_time = 0.0;
+    if (!SolveFOFinal(fo_state, values, lists, warm_objective, warm_cpu_time)) {
+        // 映射后的计划在新算例上不可行 (如新增 setup 占满产能)，放弃冻结约束整体重算
+        LOG("[重排程] 旧计划映射后不可行，退回完整 RFO 求解 (冻结周期不再保证)");
+        m.replan_fallback = true;
+        SolveRFO(values, lists);
+        return;
     }
+    m.replan_warm_objective = warm_objective;
+    fo_state.current_objective = warm_objective;
+    LOG_FMT("[重排程] 暖启动目标: %.2f\n", warm_objective);
 
-    for (int f = 0; f < values.number_of_flows; ++f) {
-        for (int t = 0; t < T; ++t) {
-            m.cost_inventory += lists.cost_i[f] * lists.small_i[f][t];
-        }
+    // 阶段2: 受影响周期上的 FO 窗口
+    double fo_cpu_time = 0.0;
+    int affected = static_cast<int>(std::count(warm.active.begin(), warm.active.end(), true));
+    if (affected > 0) {
+        LOG_FMT("\n[FO] 启动 Fix-and-Optimize 阶段 (受影响周期 %d 个，冻结 %d 个)\n",
+                affected, warm.frozen);
+        g_progress.SetPhase("FO");
+        RunFOWindows(values, lists, fo_state, fo_cpu_time);
+    } else {
+        LOG("[重排程] 无受影响周期，沿用旧计划");
     }
 
-    // Setup/Carryover statistics
-    m.total_setups = 0;
-    m.total_carryovers = 0;
-    m.saved_setup_cost = 0.0;
-
-    for (int g = 0; g < values.number_of_groups; ++g) {
-        for (int t = 0; t < T; ++t) {
-            if (lists.small_y[g][t] == 1) m.total_setups++;
-            if (lists.small_l[g][t] == 1) {
-                m.total_carryovers++;
-                m.saved_setup_cost += lists.cost_y[g];
-            }
+    // 阶段3: 有改进时重新收尾 (lists 中的 X/I/B/U 仍为暖启动计划的值)
+    double final_objective = warm_objective;
+    double final_cpu_time = 0.0;
+    if (fo_state.windows_improved > 0) {
+        g_progress.SetPhase("FO-FINAL");
+        if (!SolveFOFinal(fo_state, values, lists, final_objective, final_cpu_time)) {
+            final_objective = fo_state.current_objective;
         }
     }
 
-    // Demand fulfillment
-    m.unmet_count = 0;
-    m.total_backorder = 0.0;
-    m.total_demand = 0.0;
-    int on_time_count = 0;
+    double replan_wall_time = chrono::duration<double>(
+        chrono::steady_clock::now() - replan_start).count();
 
-    for (int i = 0; i < values.number_of_items; ++i) {
-        m.total_demand += lists.final_demand[i];
-        if (lists.small_u[i] > 0.5) {
-            m.unmet_count++;
-        } else {
-            int lw = lists.lw_x[i];
-            if (lw < T && lists.small_b[i][lw] < 0.5) {
-                on_time_count++;
-            }
-        }
-        int T_last = T - 1;
-        m.total_backorder += lists.small_b[i][T_last];
-    }
+    lists.small_y = fo_state.y_current;
+    lists.small_l = fo_state.lambda_current;
 
-    m.unmet_rate = values.number_of_items > 0
-        ? (double)m.unmet_count / values.number_of_items : 0.0;
-    m.on_time_rate = values.number_of_items > 0
-        ? (double)on_time_count / values.number_of_items : 0.0;
-
-    // Capacity utilization
-    m.capacity_util_by_period.resize(T);
-    m.capacity_util_avg = 0.0;
-    m.capacity_util_max = 0.0;
-
-    for (int t = 0; t < T; ++t) {
-        double usage = 0.0;
-        for (int i = 0; i < values.number_of_items; ++i) {
-            usage += lists.usage_x[i] * lists.small_x[i][t];
-        }
-        for (int g = 0; g < values.number_of_groups; ++g) {
-            usage += lists.usage_y[g] * lists.small_y[g][t];
-        }
-        double util = values.machine_capacity > 0
-            ? usage / values.machine_capacity : 0.0;
-        m.capacity_util_by_period[t] = util;
-        m.capacity_util_avg += util;
-        if (util > m.capacity_util_max) m.capacity_util_max = util;
-    }
-    m.capacity_util_avg /= T;
+    values.result_step1.objective = final_objective;
+    values.result_step1.runtime = replan_wall_time;
+    values.result_step1.cpu_time = warm_cpu_time + fo_cpu_time + final_cpu_time;
+    values.result_step1.gap = -1.0;
 
-    LOG("\n========================================");
-    LOG("[RFO] 算法完成");
-    LOG("========================================");
-    LOG_FMT("[RFO] RF目标:   %.2f\n", rf_objective);
-    LOG_FMT("[RFO] 最终目标: %.2f\n", values.result_step1.objective);
-    LOG_FMT("[RFO] 改进:     %.2f (%.2f%%)\n", improvement, improvement_pct);
-    LOG_FMT("[RFO] 总耗时:   %.2f秒\n", rfo_wall_time);
-    LOG_FMT("[RFO] CPU时间:  %.2f秒\n", total_cpu_time);
+    // 沿用 RFO 指标字段: 初始解为暖启动计划
+    double improvement = warm_objective - final_objective;
+    m.rfo_rf_objective = warm_objective;
+    m.rfo_rf_time = warm_cpu_time;
+    m.rfo_fo_rounds = fo_state.rounds_completed;
+    m.rfo_fo_windows_improved = fo_state.windows_improved;
+    m.rfo_fo_improvement = improvement;
+    m.rfo_fo_improvement_pct = (warm_objective > 0) ? (improvement / warm_objective * 100.0) : 0.0;
+    m.rfo_fo_time = fo_cpu_time;
+    m.rfo_final_solve_time = final_cpu_time;
+
+    ComputePlanMetrics(values, lists);
+
+    LOG_FMT("[重排程] 暖启动目标: %.2f 最终目标: %.2f 改进窗口=%d 总耗时=%.2f秒\n",
+            warm_objective, final_objective, fo_state.windows_improved, replan_wall_time);
 }
@@ -6,6 +6,14 @@
 //   Stage 3: 固定 y* 和 lambda*, 恢复真实产能, 求解最终生产计划
 
 #include "optimizer.h"
+#include "lot_sizing_model.h"
+#include "model_bounds.h"
+#include "lot_sizing_cuts.h"
+#include "plan_metrics.h"
+#include "cplex_pool.h"
+#include "subproblem_dump.h"
+#include "deadline.h"
+#include "progress.h"
 #include "logger.h"
 
 // Stage 1: 固定 lambda=0, 放大产能, 求解 y* 启动结构
@@ -15,21 +23,20 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             values.rr_capacity, values.rr_bonus);
 
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, g_deadline.Budget(values.cpx_runtime_limit, 3));
+        IloEnv env = lease.Env();
         IloModel model(env);
 
         // 决策变量
-        IloArray<IloNumVarArray> X(env, values.number_of_items);
         IloArray<IloNumVarArray> Y(env, values.number_of_groups);
         IloArray<IloNumVarArray> I(env, values.number_of_flows);
         IloArray<IloNumVarArray> P(env, values.number_of_flows);
-        IloArray<IloNumVarArray> B(env, values.number_of_items);
         IloNumVarArray U(env, values.number_of_items, 0, 1, ILOBOOL);
 
-        for (int i = 0; i < values.number_of_items; i++) {
-            X[i] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        IloArray<IloNumVarArray> X = CreateWindowVars(env, lists.ew_x, values.number_of_periods);
+        IloArray<IloNumVarArray> B = CreateWindowVars(env, lists.lw_x, values.number_of_periods);
 
         for (int g = 0; g < values.number_of_groups; g++) {
             Y[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
@@ -46,11 +53,15 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             P[f] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
         }
 
+        // 变量随环境归还结束 (见 cplex_pool.h)
+        for (auto vars : {X, Y, Z, I, P, B}) lease.Own(vars);
+        lease.Own(U);
+
         // 目标函数
         IloExpr objective(env);
 
         for (int i = 0; i < values.number_of_items; i++) {
-            for (int t = 0; t < values.number_of_periods; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; t++) {
                 objective += lists.cost_x[i] * X[i][t];
             }
             // 欠交惩罚 (仅 t >= l_i)
@@ -88,7 +99,7 @@ void SolveStep1(AllValues& values, AllLists& lists) {
         // 需求满足约束
         for (int i = 0; i < values.number_of_items; i++) {
             IloExpr total_production(env);
-            for (int t = 0; t < values.number_of_periods; t++) {
+            for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; t++) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -100,6 +111,7 @@ void SolveStep1(AllValues& values, AllLists& lists) {
         for (int t = 0; t < values.number_of_periods; t++) {
             IloExpr capacity(env);
             for (int i = 0; i < values.number_of_items; i++) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < values.number_of_groups; g++) {
@@ -109,20 +121,33 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             capacity.end();
         }
 
-        // 产品大类级 Big-M 约束
+        // 产品大类级 Big-M 约束 (M_gt 见 model_bounds.h)
+        vector<vector<double>> big_m = ComputeFamilyBigM(values, lists, capacity_big);
         for (int g = 0; g < values.number_of_groups; g++) {
             for (int t = 0; t < values.number_of_periods; t++) {
                 IloExpr family_production(env);
                 for (int i = 0; i < values.number_of_items; i++) {
-                    if (lists.group_flag[i][g]) {
+                    if (lists.group_flag[i][g] && t >= lists.ew_x[i]) {
                         family_production += lists.usage_x[i] * X[i][t];
                     }
                 }
-                model.add(family_production <= capacity_big * Y[g][t]);
+                model.add(family_production <= big_m[g][t] * Y[g][t]);
                 family_production.end();
             }
         }
 
+        // 订单级上界 x_it <= d_i y_gt (可选)
+        if (values.item_vub) {
+            for (int i = 0; i < values.number_of_items; i++) {
+                for (int g = 0; g < values.number_of_groups; g++) {
+                    if (!lists.group_flag[i][g]) continue;
+                    for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; t++) {
+                        model.add(X[i][t] <= lists.final_demand[i] * Y[g][t]);
+                    }
+                }
+            }
+        }
+
         // Z[g][t] = Y[g][t-1] * Y[g][t] 线性化约束
         for (int g = 0; g < values.number_of_groups; g++) {
             model.add(Z[g][0] == 0);  // t=0 没有前一周期
@@ -138,7 +163,9 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             for (int t = 0; t < values.number_of_periods; t++) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < values.number_of_items; i++) {
-                    flow_production += lists.flow_flag[i][f] * X[i][t];
+                    if (t >= lists.ew_x[i]) {
+                        flow_production += lists.flow_flag[i][f] * X[i][t];
+                    }
                 }
 
                 if (t == 0) {
@@ -158,27 +185,18 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             }
         }
 
-        // 最早生产期约束 (仅约束 t < e_i)
-        for (int i = 0; i < values.number_of_items; i++) {
-            for (int t = 0; t < values.number_of_periods; t++) {
-                if (t < lists.ew_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
-            }
-        }
+        // 最早生产期约束 - t < e_i 的 x_it 不创建 (时间窗稀疏变量)
 
         // 欠交定义
         for (int i = 0; i < values.number_of_items; i++) {
             for (int t = 0; t < values.number_of_periods; t++) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -190,12 +208,23 @@ void SolveStep1(AllValues& values, AllLists& lists) {
         }
 
         // 求解
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, values.cpx_runtime_limit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "rr_step1");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = "rr_step1";
+            dump.win_end = values.number_of_periods;
+            dump.time_limit = cplex.getParam(IloCplex::Param::TimeLimit);
+            dump.threads = values.cplex_threads;
+            DumpSubproblem(cplex, values, dump);
+        }
+
+        // 用户割平面: 阶段1无 carryover 变量，按 z_gt = y_gt 分离
+        auto cut_callback = AttachLotSizingCuts(cplex, kCutScopeRR, env, values, lists,
+                                                X, Y, IloArray<IloNumVarArray>(), B,
+                                                capacity_big, values.number_of_periods);
+        auto progress = AttachProgress(cplex, cut_callback.get(),
+                                       IloCplex::Callback::Context::Id::Relaxation);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -205,6 +234,8 @@ void SolveStep1(AllValues& values, AllLists& lists) {
 
         auto step1_start = chrono::steady_clock::now();
         bool has_solution = cplex.solve();
+        RecordSolveEffort(values, cplex);
+        g_deadline.RecordSolve(cplex.getTime());
         auto step1_end = chrono::steady_clock::now();
         double step1_wall_time = chrono::duration<double>(step1_end - step1_start).count();
 
@@ -212,6 +243,7 @@ void SolveStep1(AllValues& values, AllLists& lists) {
         cplex.setOut(env.getNullStream());
         if (g_logger) g_logger->Flush();
         LOG("=============== CPLEX END =================");
+        RecordCutStats(values, "[阶段1]", cut_callback.get());
         LOG_RAW("\n");
 
         bool has_incumbent = false;
@@ -238,8 +270,8 @@ void SolveStep1(AllValues& values, AllLists& lists) {
                 for (int i = 0; i < values.number_of_items; i++) {
                     vector<double> x_row, b_row;
                     for (int t = 0; t < values.number_of_periods; t++) {
-                        x_row.push_back(cplex.getValue(X[i][t]));
-                        b_row.push_back(cplex.getValue(B[i][t]));
+                        x_row.push_back(WindowValue(cplex, X, i, t));
+                        b_row.push_back(WindowValue(cplex, B, i, t));
                     }
                     lists.small_x.push_back(x_row);
                     lists.small_b.push_back(b_row);
@@ -280,8 +312,6 @@ void SolveStep1(AllValues& values, AllLists& lists) {
             values.result_step1.gap = -1;
         }
 
-        env.end();
-
     } catch (IloException& e) {
         LOG_FMT("[阶段1] CPLEX错误: %s\n", e.getMessage());
     } catch (...) {
@@ -302,7 +332,9 @@ void SolveStep2(AllValues& values, AllLists& lists) {
     }
 
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, g_deadline.Budget(values.cpx_runtime_limit, 2));
+        IloEnv env = lease.Env();
         IloModel model(env);
 
         IloArray<IloNumVarArray> Y(env, values.number_of_groups);
@@ -312,6 +344,8 @@ void SolveStep2(AllValues& values, AllLists& lists) {
             Y[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
             Lambda[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
         }
+        lease.Own(Y);
+        lease.Own(Lambda);
 
         // 目标: 最大化跨期总和
         IloExpr objective(env);
@@ -353,27 +387,44 @@ void SolveStep2(AllValues& values, AllLists& lists) {
         }
 
         // 约束 (c): 防止跨期与其他族的启动冲突
+        // 聚合写法以 S_{t-1} - y_{g,t-1} 代替 sum_{g'!=g} y_{g',t-1}
         int num_groups = values.number_of_groups;
-        for (int g = 0; g < num_groups; ++g) {
-            for (int t = 2; t < values.number_of_periods; ++t) {
-                IloExpr sum_other_setups(env);
-                for (int g_prime = 0; g_prime < num_groups; ++g_prime) {
-                    if (g_prime != g) {
-                        sum_other_setups += Y[g_prime][t - 1];
+        if (values.aggregate_exclusivity) {
+            IloNumVarArray S = AddSetupCount(env, model, Y, num_groups, values.number_of_periods);
+            lease.Own(S);
+            for (int g = 0; g < num_groups; ++g) {
+                for (int t = 2; t < values.number_of_periods; ++t) {
+                    model.add(Lambda[g][t-1] + Lambda[g][t]
+                              <= 2.0 - (S[t - 1] - Y[g][t - 1]) / num_groups);
+                }
+            }
+        } else {
+            for (int g = 0; g < num_groups; ++g) {
+                for (int t = 2; t < values.number_of_periods; ++t) {
+                    IloExpr sum_other_setups(env);
+                    for (int g_prime = 0; g_prime < num_groups; ++g_prime) {
+                        if (g_prime != g) {
+                            sum_other_setups += Y[g_prime][t - 1];
+                        }
                     }
+                    model.add(Lambda[g][t-1] + Lambda[g][t] <= 2.0 - sum_other_setups / num_groups);
+                    sum_other_setups.end();
                 }
-                model.add(Lambda[g][t-1] + Lambda[g][t] <= 2.0 - sum_other_setups / num_groups);
-                sum_other_setups.end();
             }
         }
 
         // 求解
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, values.cpx_runtime_limit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "rr_step2");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = "rr_step2";
+            dump.win_end = values.number_of_periods;
+            dump.time_limit = cplex.getParam(IloCplex::Param::TimeLimit);
+            dump.threads = values.cplex_threads;
+            DumpSubproblem(cplex, values, dump);
+        }
+        auto progress = AttachProgress(cplex, nullptr, 0);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -383,6 +434,8 @@ void SolveStep2(AllValues& values, AllLists& lists) {
 
         auto step2_start = chrono::steady_clock::now();
         bool has_solution = cplex.solve();
+        RecordSolveEffort(values, cplex);
+        g_deadline.RecordSolve(cplex.getTime());
         auto step2_end = chrono::steady_clock::now();
         double step2_wall_time = chrono::duration<double>(step2_end - step2_start).count();
 
@@ -442,8 +495,6 @@ void SolveStep2(AllValues& values, AllLists& lists) {
             values.result_step2.gap = -1;
         }
 
-        env.end();
-
     } catch (IloException& e) {
         LOG_FMT("[阶段2] CPLEX错误: %s\n", e.getMessage());
     } catch (...) {
@@ -492,21 +543,20 @@ void SolveStep3(AllValues& values, AllLists& lists) {
     }
 
     try {
-        IloEnv env;
+        // 从环境池借出 (通用参数已设置，见 cplex_pool.h)
+        CplexLease lease = AcquireCplex(values, g_deadline.FinalBudget(values.cpx_runtime_limit));
+        IloEnv env = lease.Env();
         IloModel model(env);
 
-        IloArray<IloNumVarArray> X(env, values.number_of_items);
         IloArray<IloNumVarArray> Y(env, values.number_of_groups);
         IloArray<IloNumVarArray> Lambda(env, values.number_of_groups);
         IloArray<IloNumVarArray> I(env, values.number_of_flows);
-        IloArray<IloNumVarArray> B(env, values.number_of_items);
         IloArray<IloNumVarArray> P(env, values.number_of_flows);
         IloNumVarArray U(env, values.number_of_items, 0, 1, ILOBOOL);
 
-        for (int i = 0; i < values.number_of_items; ++i) {
-            X[i] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
-            B[i] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
-        }
+        // X 仅在 t >= e_i、B 仅在 t >= l_i 创建 (时间窗稀疏变量)
+        IloArray<IloNumVarArray> X = CreateWindowVars(env, lists.ew_x, values.number_of_periods);
+        IloArray<IloNumVarArray> B = CreateWindowVars(env, lists.lw_x, values.number_of_periods);
 
         for (int g = 0; g < values.number_of_groups; ++g) {
             Y[g] = IloNumVarArray(env, values.number_of_periods, 0, 1, ILOBOOL);
@@ -518,11 +568,15 @@ void SolveStep3(AllValues& values, AllLists& lists) {
             P[f] = IloNumVarArray(env, values.number_of_periods, 0, IloInfinity);
         }
 
+        // 变量随环境归还结束 (见 cplex_pool.h)
+        for (auto vars : {X, Y, Lambda, I, P, B}) lease.Own(vars);
+        lease.Own(U);
+
         // 目标函数
         IloExpr objective(env);
 
         for (int i = 0; i < values.number_of_items; ++i) {
-            for (int t = 0; t < values.number_of_periods; ++t) {
+            for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; ++t) {
                 objective += lists.cost_x[i] * X[i][t];
             }
             // 欠交惩罚 (仅 t >= l_i)
@@ -571,7 +625,7 @@ void SolveStep3(AllValues& values, AllLists& lists) {
         // 需求满足约束
         for (int i = 0; i < values.number_of_items; ++i) {
             IloExpr total_production(env);
-            for (int t = 0; t < values.number_of_periods; ++t) {
+            for (int t = max(0, lists.ew_x[i]); t < values.number_of_periods; ++t) {
                 total_production += X[i][t];
             }
             model.add(total_production + U[i] * lists.final_demand[i] >= lists.final_demand[i]);
@@ -582,6 +636,7 @@ void SolveStep3(AllValues& values, AllLists& lists) {
         for (int t = 0; t < values.number_of_periods; ++t) {
             IloExpr capacity(env);
             for (int i = 0; i < values.number_of_items; ++i) {
+                if (t < lists.ew_x[i]) continue;  // 窗口外无变量
                 capacity += lists.usage_x[i] * X[i][t];
             }
             for (int g = 0; g < values.number_of_groups; ++g) {
@@ -591,26 +646,16 @@ void SolveStep3(AllValues& values, AllLists& lists) {
             capacity.end();
         }
 
-        // 产品大类级 Setup 约束（含 carryover）
-        for (int g = 0; g < values.number_of_groups; ++g) {
-            for (int t = 0; t < values.number_of_periods; ++t) {
-                IloExpr family_production(env);
-                for (int i = 0; i < values.number_of_items; ++i) {
-                    if (lists.group_flag[i][g]) {
-                        family_production += lists.usage_x[i] * X[i][t];
-                    }
-                }
-                model.add(family_production <= values.machine_capacity * (Y[g][t] + Lambda[g][t]));
-                family_production.end();
-            }
-        }
+        // 产品大类级 Setup 约束（含 carryover）；t > l_i 的生产在下方禁止
+        AddFamilySetupConstraints(env, model, values, lists, X, Y, Lambda,
+                                  values.machine_capacity, nullptr, true);
 
         // 下游工序流平衡
         for (int f = 0; f < values.number_of_flows; ++f) {
             for (int t = 0; t < values.number_of_periods; ++t) {
                 IloExpr flow_production(env);
                 for (int i = 0; i < values.number_of_items; ++i) {
-                    if (lists.flow_flag[i][f]) {
+                    if (lists.flow_flag[i][f] && t >= lists.ew_x[i]) {
                         flow_production += X[i][t];
                     }
                 }
@@ -633,11 +678,10 @@ void SolveStep3(AllValues& values, AllLists& lists) {
         }
 
         // 时间窗约束
+        // t < e_i 的 x_it 未创建 (时间窗稀疏变量)，t > l_i 的生产以上界 0 禁止
         for (int i = 0; i < values.number_of_items; ++i) {
-            for (int t = 0; t < values.number_of_periods; ++t) {
-                if (t < lists.ew_x[i] || t > lists.lw_x[i]) {
-                    model.add(X[i][t] == 0);
-                }
+            for (int t = max(lists.ew_x[i], lists.lw_x[i] + 1); t < values.number_of_periods; ++t) {
+                X[i][t].setUB(0);
             }
         }
 
@@ -646,13 +690,11 @@ void SolveStep3(AllValues& values, AllLists& lists) {
             for (int t = 0; t < values.number_of_periods; ++t) {
                 if (t >= lists.lw_x[i]) {
                     IloExpr cumulative_production(env);
-                    for (int tau = 0; tau <= t; tau++) {
+                    for (int tau = max(0, lists.ew_x[i]); tau <= t; tau++) {
                         cumulative_production += X[i][tau];
                     }
                     model.add(B[i][t] == lists.final_demand[i] - cumulative_production);
                     cumulative_production.end();
-                } else {
-                    model.add(B[i][t] == 0);
                 }
             }
         }
@@ -664,12 +706,17 @@ void SolveStep3(AllValues& values, AllLists& lists) {
         }
 
         // 求解
-        IloCplex cplex(model);
-        cplex.setParam(IloCplex::TiLim, values.cpx_runtime_limit);
-        cplex.setParam(IloCplex::Threads, values.cplex_threads);
-        cplex.setParam(IloCplex::Param::MIP::Strategy::File, 3);
-        cplex.setParam(IloCplex::Param::WorkDir, values.cplex_workdir.c_str());
-        cplex.setParam(IloCplex::Param::WorkMem, values.cplex_workmem);
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "rr_step3");
+        if (SubproblemDumpEnabled(values)) {
+            SubproblemDump dump;
+            dump.phase = "rr_step3";
+            dump.win_end = values.number_of_periods;
+            dump.time_limit = cplex.getParam(IloCplex::Param::TimeLimit);
+            dump.threads = values.cplex_threads;
+            DumpSubproblem(cplex, values, dump);
+        }
+        auto progress = AttachProgress(cplex, nullptr, 0);
 
         // CPLEX 日志输出到双向流
         if (g_logger) {
@@ -679,6 +726,7 @@ void SolveStep3(AllValues& values, AllLists& lists) {
 
         auto step3_start = chrono::steady_clock::now();
         bool has_solution = cplex.solve();
+        RecordSolveEffort(values, cplex);
         auto step3_end = chrono::steady_clock::now();
         double step3_wall_time = chrono::duration<double>(step3_end - step3_start).count();
 
@@ -708,133 +756,14 @@ void SolveStep3(AllValues& values, AllLists& lists) {
                 values.result_step3.cpu_time = cplex.getTime();
                 values.result_step3.gap = cplex.getMIPRelativeGap();
 
-                int total_carryovers_used = 0;
-                double saved_setup_cost = 0.0;
-                for (int g = 0; g < values.number_of_groups; ++g) {
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        if (lists.small_l[g][t] == 1) {
-                            total_carryovers_used++;
-                            saved_setup_cost += lists.cost_y[g];
-                        }
-                    }
-                }
-                LOG_FMT("[阶段3] 使用 %d 个跨期，节省启动成本 %.2f\n", total_carryovers_used, saved_setup_cost);
-
                 // Save decision variables to AllLists for JSON output
-                lists.small_x.resize(values.number_of_items);
-                lists.small_b.resize(values.number_of_items);
-                lists.small_u.resize(values.number_of_items);
-                lists.small_i.resize(values.number_of_flows);
-
-                for (int i = 0; i < values.number_of_items; ++i) {
-                    lists.small_x[i].resize(values.number_of_periods);
-                    lists.small_b[i].resize(values.number_of_periods);
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        lists.small_x[i][t] = cplex.getValue(X[i][t]);
-                        lists.small_b[i][t] = cplex.getValue(B[i][t]);
-                    }
-                    lists.small_u[i] = cplex.getValue(U[i]);
-                }
-
-                for (int f = 0; f < values.number_of_flows; ++f) {
-                    lists.small_i[f].resize(values.number_of_periods);
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        lists.small_i[f][t] = cplex.getValue(I[f][t]);
-                    }
-                }
+                ExtractFinalPlan(cplex, values, lists, X, B, I, U);
 
                 // ========== Calculate metrics ==========
                 auto& m = values.metrics;
-
-                // Cost breakdown
-                m.cost_production = 0.0;
-                m.cost_setup = 0.0;
-                m.cost_inventory = 0.0;
-                m.cost_backorder = 0.0;
-                m.cost_unmet = 0.0;
-
-                for (int i = 0; i < values.number_of_items; ++i) {
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        m.cost_production += lists.cost_x[i] * cplex.getValue(X[i][t]);
-                        m.cost_backorder += lists.cost_b[i] * cplex.getValue(B[i][t]);
-                    }
-                    m.cost_unmet += lists.cost_u[i] * cplex.getValue(U[i]);
-                }
-
-                for (int g = 0; g < values.number_of_groups; ++g) {
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        m.cost_setup += lists.cost_y[g] * lists.small_y[g][t];
-                    }
-                }
-
-                for (int f = 0; f < values.number_of_flows; ++f) {
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        m.cost_inventory += lists.cost_i[f] * cplex.getValue(I[f][t]);
-                    }
-                }
-
-                // Setup/Carryover statistics
-                m.total_setups = 0;
-                m.total_carryovers = total_carryovers_used;
-                m.saved_setup_cost = saved_setup_cost;
-
-                for (int g = 0; g < values.number_of_groups; ++g) {
-                    for (int t = 0; t < values.number_of_periods; ++t) {
-                        if (lists.small_y[g][t] == 1) m.total_setups++;
-                    }
-                }
-
-                // Demand fulfillment
-                m.unmet_count = 0;
-                m.total_backorder = 0.0;
-                m.total_demand = 0.0;
-                int on_time_count = 0;
-
-                for (int i = 0; i < values.number_of_items; ++i) {
-                    m.total_demand += lists.final_demand[i];
-                    if (cplex.getValue(U[i]) > 0.5) {
-                        m.unmet_count++;
-                    } else {
-                        // Check if delivered on time (no backorder at due date)
-                        int lw = lists.lw_x[i];
-                        if (lw < values.number_of_periods && cplex.getValue(B[i][lw]) < 0.5) {
-                            on_time_count++;
-                        }
-                    }
-                    // Sum backorder at final period
-                    int T_last = values.number_of_periods - 1;
-                    m.total_backorder += cplex.getValue(B[i][T_last]);
-                }
-
-                m.unmet_rate = values.number_of_items > 0
-                    ? (double)m.unmet_count / values.number_of_items : 0.0;
-                m.on_time_rate = values.number_of_items > 0
-                    ? (double)on_time_count / values.number_of_items : 0.0;
-
-                // Capacity utilization
-                m.capacity_util_by_period.resize(values.number_of_periods);
-                m.capacity_util_avg = 0.0;
-                m.capacity_util_max = 0.0;
-
-                for (int t = 0; t < values.number_of_periods; ++t) {
-                    double usage = 0.0;
-                    for (int i = 0; i < values.number_of_items; ++i) {
-                        usage += lists.usage_x[i] * cplex.getValue(X[i][t]);
-                    }
-                    for (int g = 0; g < values.number_of_groups; ++g) {
-                        usage += lists.usage_y[g] * lists.small_y[g][t];
-                    }
-                    double util = values.machine_capacity > 0
-                        ? usage / values.machine_capacity : 0.0;
-                    m.capacity_util_by_period[t] = util;
-                    m.capacity_util_avg += util;
-                    if (util > m.capacity_util_max) m.capacity_util_max = util;
-                }
-                m.capacity_util_avg /= values.number_of_periods;
-
-                // CPLEX solver stats
-                m.cplex_nodes = cplex.getNnodes();
-                m.cplex_iterations = cplex.getNiterations();
+                ComputePlanMetrics(values, lists);
+                LOG_FMT("[阶段3] 使用 %d 个跨期，节省启动成本 %.2f\n",
+                        m.total_carryovers, m.saved_setup_cost);
 
                 // RR-specific metrics
                 m.rr_step1_objective = values.result_step1.objective;
@@ -884,8 +813,6 @@ void SolveStep3(AllValues& values, AllLists& lists) {
             values.result_step3.gap = -1;
         }
 
-        env.end();
-
     } catch (IloException& e) {
         LOG_FMT("[阶段3] CPLEX错误: %s\n", e.getMessage());
     } catch (...) {
@@ -0,0 +1,89 @@
+// subproblem_dump.cpp - 子问题转储实现
+
+#include "subproblem_dump.h"
+#include "logger.h"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::atomic<int> g_dump_sequence{0};
+std::once_flag g_dump_dir_once;
+bool g_dump_dir_ok = false;
+
+}  // namespace
+
+void NameSetupVars(IloArray<IloNumVarArray>& Y, IloArray<IloNumVarArray>& Lambda, int G, int T) {
+    for (int g = 0; g < G; g++) {
+        for (int t = 0; t < T; t++) {
+            string suffix = "_" + to_string(g) + "_" + to_string(t);
+            Y[g][t].setName(("y" + suffix).c_str());
+            Lambda[g][t].setName(("lambda" + suffix).c_str());
+        }
+    }
+}
+
+void DumpSubproblem(IloCplex& cplex, const AllValues& values, const SubproblemDump& dump) {
+    std::call_once(g_dump_dir_once, [&]() {
+        std::error_code ec;
+        fs::create_directories(values.dump_dir, ec);
+        g_dump_dir_ok = !ec;
+        if (ec) {
+            LOG_FMT("[转储] 无法创建目录: %s\n", values.dump_dir.c_str());
+        }
+    });
+    if (!g_dump_dir_ok) {
+        return;
+    }
+
+    int sequence = g_dump_sequence++;
+    char stem[96];
+    snprintf(stem, sizeof(stem), "%s_%04d_k%d_W%d", dump.phase.c_str(), sequence, dump.k, dump.W);
+    string model_name = string(stem) + "." + values.dump_format;
+    fs::path dir(values.dump_dir);
+
+    try {
+        cplex.exportModel((dir / model_name).string().c_str());
+    } catch (IloException& e) {
+        LOG_FMT("[转储] 导出失败 %s: %s\n", model_name.c_str(), e.getMessage());
+        return;
+    }
+
+    ofstream fout(dir / (string(stem) + ".json"));
+    fout << "{\n"
+         << "  \"phase\": \"" << dump.phase << "\",\n"
+         << "  \"sequence\": " << sequence << ",\n"
+         << "  \"k\": " << dump.k << ",\n"
+         << "  \"W\": " << dump.W << ",\n"
+         << "  \"window\": [" << dump.win_begin << ", " << dump.win_end << "],\n"
+         << "  \"time_limit\": " << dump.time_limit << ",\n"
+         << "  \"threads\": " << dump.threads << ",\n"
+         << "  \"parallel_retry\": " << (dump.parallel_retry ? "true" : "false") << ",\n"
+         << "  \"instance\": \"" << JsonEscape(values.input_file) << "\",\n"
+         << "  \"algorithm\": \"" << values.algorithm_name << "\",\n"
+         << "  \"rows\": " << cplex.getNrows() << ",\n"
+         << "  \"columns\": " << cplex.getNcols() << ",\n"
+         << "  \"binaries\": " << cplex.getNbinVars() << ",\n"
+         << "  \"model\": \"" << model_name << "\",\n"
+         << "  \"mip_start\": ";
+    if (dump.start_y != nullptr && dump.start_lambda != nullptr) {
+        fout << "{";
+        bool first = true;
+        for (int g = 0; g < values.number_of_groups; g++) {
+            for (int t = dump.win_begin; t < dump.win_end; t++) {
+                fout << (first ? "" : ", ") << "\"y_" << g << "_" << t << "\": " << (*dump.start_y)[g][t]
+                     << ", \"lambda_" << g << "_" << t << "\": " << (*dump.start_lambda)[g][t];
+                first = false;
+            }
+        }
+        fout << "}\n";
+    } else {
+        fout << "null\n";
+    }
+    fout << "}\n";
+
+    LOG_FMT("[转储] %s\n", (dir / model_name).string().c_str());
+}
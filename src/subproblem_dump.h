@@ -0,0 +1,43 @@
+// subproblem_dump.h - 子问题转储
+// --dump-subproblems <目录> 把 RF/FO/RR 子问题与完整模型在求解前导出为模型文件 (--dump-format lp|mps|sav)，
+// 每个子问题附一个同名 JSON:
+//   {"phase": "fo_window", "sequence": 12, "k": 8, "W": 6, "window": [6, 16],
+//    "time_limit": 12.5, "threads": 0, "parallel_retry": false,
+//    "instance": "...", "algorithm": "RFO", "rows": ..., "columns": ..., "binaries": ...,
+//    "model": "fo_window_0012_k8_W6.lp", "mip_start": {"y_0_6": 1, "lambda_0_6": 0, ...}}
+// phase 为 rf_window / rf_final / fo_window / fo_final / rr_step1-3 / direct
+// (与 cplex_params.h 的阶段名一致)；window 为整数 (y, lambda) 的周期区间 (RR 与 direct 为全部周期)；
+// mip_start 为窗口内 (y, lambda) 的已知可行取值 (FO 为当前计划，其余无，写 null)，
+// 键与模型文件中的变量名一致 (转储时 y/lambda 命名为 y_<g>_<t> / lambda_<g>_<t>)。
+// 转储目录由 LS-NTGF-Replay 在其他参数配置下重新求解或按阶段调参 (见 replay.h)
+
+#ifndef SUBPROBLEM_DUMP_H_
+#define SUBPROBLEM_DUMP_H_
+
+#include "optimizer.h"
+
+// 一个子问题的描述
+struct SubproblemDump {
+    string phase;
+    int k = 0;
+    int W = 0;
+    int win_begin = 0;           // 整数窗口 [win_begin, win_end)
+    int win_end = 0;
+    double time_limit = 0.0;
+    int threads = 0;
+    bool parallel_retry = false; // RF 并行重试 (可能被淘汰中止)
+    const vector<vector<int>>* start_y = nullptr;       // 窗口内的已知可行取值，空为无
+    const vector<vector<int>>* start_lambda = nullptr;
+};
+
+inline bool SubproblemDumpEnabled(const AllValues& values) {
+    return !values.dump_dir.empty();
+}
+
+// 给 y/lambda 命名 (须在 lease.Load 之前调用)，仅在转储开启时调用
+void NameSetupVars(IloArray<IloNumVarArray>& Y, IloArray<IloNumVarArray>& Lambda, int G, int T);
+
+// 导出已装载的模型与附带 JSON；失败只记日志，不影响求解
+void DumpSubproblem(IloCplex& cplex, const AllValues& values, const SubproblemDump& dump);
+
+#endif  // SUBPROBLEM_DUMP_H_
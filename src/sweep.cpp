@@ -0,0 +1,327 @@
+// sweep.cpp - 系数扫描实现
+
+#include "sweep.h"
+#include "logger.h"
+#include "lot_sizing_model.h"
+#include "model_bounds.h"
+#include "cplex_pool.h"
+#include "deadline.h"
+#include "interrupt.h"
+#include <filesystem>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kSweepThreadsPerEnv = 4;   // 自动工作线程数时每个环境的目标线程数
+
+// 单个变体的结果
+struct SweepResult {
+    string status = "skipped";
+    double objective = -1.0;
+    double bound = -1.0;
+    double gap = -1.0;
+    double time = 0.0;
+    long nodes = 0;
+    int setups = 0;
+    int carryovers = 0;
+    int unmet = 0;
+    int worker = -1;
+    bool warm_start = false;     // 以上一个变体的解作为 MIP start
+};
+
+const char* StatusName(IloAlgorithm::Status status) {
+    switch (status) {
+        case IloAlgorithm::Optimal:    return "optimal";
+        case IloAlgorithm::Feasible:   return "feasible";
+        case IloAlgorithm::Infeasible: return "infeasible";
+        default:                       return "no_solution";
+    }
+}
+
+// 工作线程: 构建一次模型，依次求解 [begin, end) 的变体
+void RunSweepWorker(const AllValues& values, const AllLists& lists,
+                    const vector<SweepVariant>& variants, int begin, int end,
+                    int threads, int worker, vector<SweepResult>& results) {
+    int N = values.number_of_items;
+    int G = values.number_of_groups;
+    int T = values.number_of_periods;
+
+    try {
+        CplexLease lease = CplexPool::Instance().Acquire(values, values.cpx_runtime_limit, threads);
+        IloEnv env = lease.Env();
+        IloModel model(env);
+
+        LotSizingVars vars;
+        LotSizingRows rows;
+        BuildLotSizingModel(env, model, values, lists, vars, &rows);
+        OwnLotSizingVars(lease, vars);
+
+        // MIP start 覆盖全部变量 (时间窗外的空句柄跳过)
+        IloNumVarArray all_vars(env);
+        auto collect = [&](const IloArray<IloNumVarArray>& array, int n) {
+            for (int a = 0; a < n; a++) {
+                for (int t = 0; t < T; t++) {
+                    if (array[a][t].getImpl()) all_vars.add(array[a][t]);
+                }
+            }
+        };
+        collect(vars.X, N);
+        collect(vars.Y, G);
+        collect(vars.Lambda, G);
+        collect(vars.I, values.number_of_flows);
+        collect(vars.P, values.number_of_flows);
+        collect(vars.B, N);
+        for (int i = 0; i < N; i++) {
+            all_vars.add(vars.U[i]);
+        }
+
+        IloCplex& cplex = lease.Load(model);
+        lease.ApplyPhase(values, "direct");
+        cplex.setOut(env.getNullStream());
+
+        // 模型中的当前系数，只修改变化的部分
+        double current_capacity = values.machine_capacity;
+        vector<double> current_b(lists.cost_b.begin(), lists.cost_b.begin() + N);
+        vector<double> current_u(lists.cost_u.begin(), lists.cost_u.begin() + N);
+
+        IloNumArray start_values(env);
+        bool have_start = false;
+
+        for (int v = begin; v < end; v++) {
+            if (g_interrupt.Requested()) {
+                break;
+            }
+            const SweepVariant& variant = variants[v];
+            SweepResult& result = results[v];
+            result.worker = worker;
+
+            // 产能: 行上界与族 setup 行的 Big-M (紧 Big-M 随产能变化)
+            double capacity = variant.capacity > 0 ? variant.capacity : values.machine_capacity;
+            if (capacity != current_capacity) {
+                for (int t = 0; t < T; t++) {
+                    rows.capacity[t].setUB(capacity);
+                }
+                vector<vector<double>> big_m = ComputeFamilyBigM(values, lists, capacity);
+                for (int g = 0; g < G; g++) {
+                    for (int t = 0; t < T; t++) {
+                        rows.family_setup[g][t].setLinearCoef(vars.Y[g][t], -big_m[g][t]);
+                        rows.family_setup[g][t].setLinearCoef(vars.Lambda[g][t], -big_m[g][t]);
+                    }
+                }
+                current_capacity = capacity;
+            }
+
+            // 目标系数: b_it (t >= l_i) 与 u_i
+            for (int i = 0; i < N; i++) {
+                double cost_b = (variant.b_penalty >= 0 ? variant.b_penalty : lists.cost_b[i])
+                              * variant.cost_b_scale;
+                double cost_u = (variant.u_penalty >= 0 ? variant.u_penalty : lists.cost_u[i])
+                              * variant.cost_u_scale;
+                if (cost_b != current_b[i]) {
+                    for (int t = lists.lw_x[i]; t < T; t++) {
+                        rows.objective.setLinearCoef(vars.B[i][t], cost_b);
+                    }
+                    current_b[i] = cost_b;
+                }
+                if (cost_u != current_u[i]) {
+                    rows.objective.setLinearCoef(vars.U[i], cost_u);
+                    current_u[i] = cost_u;
+                }
+            }
+
+            // 上一个变体的解作为 MIP start，产能收紧后不可行时由 CPLEX 修复
+            if (have_start) {
+                if (cplex.getNMIPStarts() > 0) {
+                    cplex.deleteMIPStarts(0, cplex.getNMIPStarts());
+                }
+                cplex.addMIPStart(all_vars, start_values, IloCplex::MIPStartRepair);
+                result.warm_start = true;
+            }
+
+            cplex.setParam(IloCplex::TiLim,
+                           g_interrupt.Clamp(g_deadline.Budget(values.cpx_runtime_limit, end - v)));
+
+            auto start = chrono::steady_clock::now();
+            cplex.solve();
+            result.time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            result.nodes = static_cast<long>(cplex.getNnodes64());
+
+            IloAlgorithm::Status status = cplex.getStatus();
+            result.status = StatusName(status);
+            if (status == IloAlgorithm::Optimal || status == IloAlgorithm::Feasible) {
+                result.objective = cplex.getObjValue();
+                result.bound = cplex.getBestObjValue();
+                result.gap = cplex.getMIPRelativeGap();
+                for (int g = 0; g < G; g++) {
+                    for (int t = 0; t < T; t++) {
+                        if (cplex.getValue(vars.Y[g][t]) > 0.5) result.setups++;
+                        if (cplex.getValue(vars.Lambda[g][t]) > 0.5) result.carryovers++;
+                    }
+                }
+                for (int i = 0; i < N; i++) {
+                    if (cplex.getValue(vars.U[i]) > 0.5) result.unmet++;
+                }
+                cplex.getValues(start_values, all_vars);
+                have_start = true;
+            }
+
+            LOG_FMT("[扫描] #%d %s: %s 目标=%.2f gap=%.4f 时间=%.2fs%s\n", worker,
+                    variant.name.c_str(), result.status.c_str(), result.objective, result.gap,
+                    result.time, result.warm_start ? " (热启动)" : "");
+        }
+        // 只引用已登记的变量，结束数组本身即可
+        all_vars.end();
+        start_values.end();
+
+    } catch (IloException& e) {
+        LOG_FMT("[扫描] #%d CPLEX错误: %s\n", worker, e.getMessage());
+        for (int v = begin; v < end; v++) {
+            if (results[v].status == "skipped") results[v].status = "error";
+        }
+    }
+}
+
+// 空单元格返回 fallback
+double ParseCell(const vector<string>& cells, int column, double fallback) {
+    if (column < 0 || column >= static_cast<int>(cells.size())) return fallback;
+    string cell = cells[column];
+    cell.erase(std::remove_if(cell.begin(), cell.end(),
+                              [](unsigned char c) { return std::isspace(c); }),
+               cell.end());
+    return cell.empty() ? fallback : stod(cell);
+}
+
+}  // namespace
+
+bool ReadSweepVariants(const string& path, vector<SweepVariant>& variants) {
+    ifstream fin(path);
+    if (!fin) {
+        return false;
+    }
+
+    string line;
+    vector<string> header;
+    if (!getline(fin, line)) return false;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    SplitString(line, header, ",");
+
+    auto column = [&](const string& name) {
+        auto it = std::find(header.begin(), header.end(), name);
+        return it == header.end() ? -1 : static_cast<int>(it - header.begin());
+    };
+    int name_col = column("name");
+    int capacity_col = column("capacity");
+    int u_col = column("u_penalty");
+    int b_col = column("b_penalty");
+    int b_scale_col = column("cost_b_scale");
+    int u_scale_col = column("cost_u_scale");
+
+    vector<string> cells;
+    while (getline(fin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        SplitString(line, cells, ",");
+
+        SweepVariant variant;
+        try {
+            variant.capacity = ParseCell(cells, capacity_col, -1.0);
+            variant.u_penalty = ParseCell(cells, u_col, -1.0);
+            variant.b_penalty = ParseCell(cells, b_col, -1.0);
+            variant.cost_b_scale = ParseCell(cells, b_scale_col, 1.0);
+            variant.cost_u_scale = ParseCell(cells, u_scale_col, 1.0);
+        } catch (const exception&) {
+            LOG_FMT("[扫描] 变体行格式无效: %s\n", line.c_str());
+            return false;
+        }
+        variant.name = (name_col >= 0 && name_col < static_cast<int>(cells.size()) &&
+                        !cells[name_col].empty())
+                     ? cells[name_col] : "v" + to_string(variants.size() + 1);
+        variants.push_back(variant);
+    }
+    return true;
+}
+
+int RunSweep(const CommandLineArgs& args, AllValues& values, AllLists& lists) {
+    ApplyArgs(args, values);
+
+    vector<SweepVariant> variants;
+    if (!ReadSweepVariants(args.sweep, variants) || variants.empty()) {
+        LOG_FMT("[错误] 无法读取扫描变体: %s\n", args.sweep.c_str());
+        return 1;
+    }
+
+    if (args.enable_merge) {
+        int original_items = values.number_of_items;
+        UpdateBigOrderFG(values, lists);
+        LOG_FMT("[合并] 完成: %d -> %d 订单\n", original_items, values.number_of_items);
+    }
+
+    int n = static_cast<int>(variants.size());
+    int hardware = max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int workers = args.sweep_workers > 0 ? args.sweep_workers
+                : max(1, hardware / max(kSweepThreadsPerEnv, values.cplex_threads));
+    workers = min(workers, n);
+    int threads = values.cplex_threads > 0 ? values.cplex_threads : max(1, hardware / workers);
+
+    LOG("\n========================================");
+    LOG_FMT("[扫描] 变体=%d 工作线程=%d 每个环境线程=%d 单变体时限=%.1fs\n",
+            n, workers, threads, values.cpx_runtime_limit);
+    LOG("========================================");
+
+    auto sweep_start = chrono::steady_clock::now();
+    vector<SweepResult> results(n);
+    vector<std::thread> pool;
+    for (int w = 0; w < workers; w++) {
+        int begin = n * w / workers;
+        int end = n * (w + 1) / workers;
+        pool.emplace_back(RunSweepWorker, std::cref(values), std::cref(lists), std::cref(variants),
+                          begin, end, threads, w, std::ref(results));
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - sweep_start).count();
+
+    RecordCplexPoolStats(values);
+
+    // 结果表: 每个变体一行
+    std::error_code ec;
+    fs::create_directories(args.output_dir, ec);
+    string result_file = args.output_dir + "/sweep_result_" + GetCurrentTimestamp() + ".csv";
+    ofstream fout(result_file);
+    if (!fout) {
+        LOG("[错误] 无法写入扫描结果文件");
+        return 1;
+    }
+
+    auto optional = [](double value) {
+        std::ostringstream cell;
+        if (value >= 0) cell << value;
+        return cell.str();
+    };
+    fout << fixed;
+    fout << "variant,capacity,u_penalty,b_penalty,cost_b_scale,cost_u_scale,"
+         << "status,objective,bound,gap,time,nodes,setups,carryovers,unmet_count,worker,warm_start\n";
+    for (int v = 0; v < n; v++) {
+        const SweepVariant& variant = variants[v];
+        const SweepResult& result = results[v];
+        double capacity = variant.capacity > 0 ? variant.capacity : values.machine_capacity;
+        fout << variant.name << "," << setprecision(0) << capacity << ","
+             << optional(variant.u_penalty) << "," << optional(variant.b_penalty) << ","
+             << setprecision(4) << variant.cost_b_scale << "," << variant.cost_u_scale << ","
+             << result.status << "," << setprecision(2) << result.objective << ","
+             << result.bound << "," << setprecision(6) << result.gap << ","
+             << setprecision(3) << result.time << "," << result.nodes << ","
+             << result.setups << "," << result.carryovers << "," << result.unmet << ","
+             << result.worker << "," << (result.warm_start ? 1 : 0) << "\n";
+    }
+    fout.close();
+
+    int solved = static_cast<int>(std::count_if(results.begin(), results.end(),
+        [](const SweepResult& r) { return r.objective >= 0; }));
+    LOG_FMT("\n[扫描] 完成: %d/%d 个变体有解, 墙钟 %.2fs\n", solved, n, wall);
+    LOG_FMT("[保存] 扫描结果已保存: %s\n", result_file.c_str());
+    return 0;
+}
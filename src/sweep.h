@@ -0,0 +1,37 @@
+// sweep.h - 系数扫描
+// --sweep <变体.csv> 在同一算例上批量求解只改系数的变体 (产能、未满足/欠交惩罚)。
+// 每个工作线程从环境池借出一个环境，只构建一次完整模型 (见 lot_sizing_model.h)；
+// 变体之间原地修改产能行上界 (setUB)、族 setup 行的 Big-M 系数与目标中 b/u 的系数
+// (setLinearCoef)，以上一个变体的解作为 MIP start 重新求解，根 LP 从已有基热启动。
+// 变体按文件顺序连续分块给各工作线程，相邻变体的解最接近。
+//
+// 变体文件第一行为表头，列可任选，空单元格表示沿用算例/命令行的值:
+//   name,capacity,u_penalty,b_penalty,cost_b_scale,cost_u_scale
+//   base,,,,,
+//   cap1300,1300,,,,
+//   strict,,20000,200,,
+// u_penalty / b_penalty 把所有订单的 cost_u / cost_b 设为该值，*_scale 再整体乘以系数。
+// 结果写入 <输出目录>/sweep_result_<时间>.csv，每个变体一行
+
+#ifndef SWEEP_H_
+#define SWEEP_H_
+
+#include "solve_driver.h"
+
+// 扫描变体 (< 0 表示沿用基准值)
+struct SweepVariant {
+    string name;
+    double capacity = -1.0;
+    double u_penalty = -1.0;
+    double b_penalty = -1.0;
+    double cost_b_scale = 1.0;
+    double cost_u_scale = 1.0;
+};
+
+// 读取变体文件
+bool ReadSweepVariants(const string& path, vector<SweepVariant>& variants);
+
+// 在已读取的算例上执行扫描 (含订单合并)，返回进程退出码
+int RunSweep(const CommandLineArgs& args, AllValues& values, AllLists& lists);
+
+#endif  // SWEEP_H_
@@ -0,0 +1,475 @@
+// tune.cpp - 超参数调优实现
+
+#include "tune.h"
+#include "child_solve.h"
+#include "logger.h"
+#include "interrupt.h"
+#include <filesystem>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int kTuneFirstInstances = 2;   // 第一轮每个候选求解的实例数
+constexpr double kTuneFailScore = 1.0;   // 无解的得分 (相对偏差 100%)
+constexpr int kTuneThreadsPerRun = 4;    // 自动并行数时每个子进程的目标线程数
+
+// 可调参数及候选取值 (键与 --profile 相同)
+struct TuneParam {
+    string key;
+    vector<string> levels;
+};
+
+using TuneConfig = vector<string>;       // 与 TuneSpace 的参数一一对应
+
+// 单次求解记录
+struct TuneRun {
+    int config = -1;
+    int instance = -1;                   // 类别内实例下标
+    string status = "skipped";           // 中断后未启动的求解保持 skipped
+    double objective = -1.0;
+    double time = 0.0;                   // 子进程墙钟时间
+};
+
+vector<TuneParam> TuneSpace(AlgorithmType algorithm) {
+    vector<TuneParam> space = {
+        {"rf_window", {"4", "5", "6", "7", "8", "10"}},
+        {"rf_step", {"1", "2", "3"}},
+        {"rf_retries", {"1", "2", "3", "5"}},
+    };
+    switch (algorithm) {
+        case AlgorithmType::RF:
+            break;
+        case AlgorithmType::RFO:
+            space.push_back({"fo_window", {"4", "6", "8", "10", "12"}});
+            space.push_back({"fo_step", {"1", "2", "3", "4"}});
+            space.push_back({"fo_rounds", {"1", "2", "3"}});
+            space.push_back({"fo_buffer", {"0", "1", "2"}});
+            break;
+        case AlgorithmType::RR:
+            space = {
+                {"rr_capacity", {"1.0", "1.1", "1.2", "1.3", "1.5", "2.0"}},
+                {"rr_bonus", {"0", "10", "25", "50", "100", "200"}},
+            };
+            break;
+    }
+    return space;
+}
+
+string FormatValue(double value) {
+    ostringstream out;
+    out << value;
+    return out.str();
+}
+
+// 参数当前值 (候选 0)
+string CurrentValue(const CommandLineArgs& args, const string& key) {
+    if (key == "rf_window") return to_string(args.rf_window);
+    if (key == "rf_step") return to_string(args.rf_step);
+    if (key == "rf_retries") return to_string(args.rf_retries);
+    if (key == "fo_window") return to_string(args.fo_window);
+    if (key == "fo_step") return to_string(args.fo_step);
+    if (key == "fo_rounds") return to_string(args.fo_rounds);
+    if (key == "fo_buffer") return to_string(args.fo_buffer);
+    if (key == "rr_capacity") return FormatValue(args.rr_capacity);
+    if (key == "rr_bonus") return FormatValue(args.rr_bonus);
+    return "";
+}
+
+string ConfigValue(const vector<TuneParam>& space, const TuneConfig& config, const string& key) {
+    for (size_t p = 0; p < space.size(); p++) {
+        if (space[p].key == key) return config[p];
+    }
+    return "";
+}
+
+// 步长不超过窗口长度
+bool ConfigValid(const vector<TuneParam>& space, const TuneConfig& config) {
+    auto step_fits = [&](const char* step, const char* window) {
+        string s = ConfigValue(space, config, step);
+        string w = ConfigValue(space, config, window);
+        return s.empty() || w.empty() || atoi(s.c_str()) <= atoi(w.c_str());
+    };
+    return step_fits("rf_step", "rf_window") && step_fits("fo_step", "fo_window");
+}
+
+string ConfigText(const vector<TuneParam>& space, const TuneConfig& config) {
+    string text;
+    for (size_t p = 0; p < space.size(); p++) {
+        if (p > 0) text += " ";
+        text += space[p].key + "=" + config[p];
+    }
+    return text;
+}
+
+// 候选 0 为当前参数，其余随机采样 (去重，满足步长约束)
+vector<TuneConfig> SampleConfigs(const CommandLineArgs& args, const vector<TuneParam>& space) {
+    vector<TuneConfig> configs;
+    TuneConfig current;
+    for (const auto& param : space) current.push_back(CurrentValue(args, param.key));
+    configs.push_back(current);
+
+    set<TuneConfig> seen(configs.begin(), configs.end());
+    std::mt19937 rng(args.tune_seed);
+    int attempts = 0;
+    while (static_cast<int>(configs.size()) < args.tune_configs && attempts < args.tune_configs * 100) {
+        attempts++;
+        TuneConfig config;
+        for (const auto& param : space) {
+            std::uniform_int_distribution<size_t> pick(0, param.levels.size() - 1);
+            config.push_back(param.levels[pick(rng)]);
+        }
+        if (ConfigValid(space, config) && seen.insert(config).second) {
+            configs.push_back(config);
+        }
+    }
+    return configs;
+}
+
+class Tuner {
+public:
+    Tuner(const CommandLineArgs& args, const string& program, const fs::path& root)
+        : args_(args), program_(ResolveProgram(program)), root_(root),
+          space_(TuneSpace(args.algorithm)), configs_(SampleConfigs(args, space_)) {
+        int hardware = max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        workers_ = args.tune_workers > 0 ? args.tune_workers
+                 : max(1, hardware / max(kTuneThreadsPerRun, args.cplex_threads));
+        threads_ = args.cplex_threads > 0 ? args.cplex_threads : max(1, hardware / workers_);
+    }
+
+    const vector<TuneParam>& Space() const { return space_; }
+    const vector<TuneConfig>& Configs() const { return configs_; }
+    int Workers() const { return workers_; }
+    int Threads() const { return threads_; }
+
+    // 对一个类别做 successive halving，返回胜出候选；runs 为该类别全部求解记录
+    int Race(const string& instance_class, const vector<const TuneInstance*>& instances,
+             vector<TuneRun>& runs, vector<vector<double>>& scores);
+
+private:
+    vector<string> Command(const TuneConfig& config, const string& instance,
+                           const fs::path& run_dir) const;
+    void Execute(const string& instance_class, const TuneInstance& instance, TuneRun& run);
+    void ExecuteBatch(const string& instance_class, const vector<const TuneInstance*>& instances,
+                      vector<TuneRun>& runs, size_t first);
+
+    const CommandLineArgs& args_;
+    string program_;
+    fs::path root_;
+    vector<TuneParam> space_;
+    vector<TuneConfig> configs_;
+    int workers_ = 1;
+    int threads_ = 1;
+    std::mutex log_mutex_;
+};
+
+vector<string> Tuner::Command(const TuneConfig& config, const string& instance,
+                              const fs::path& run_dir) const {
+    // 数值参数按 ostream 默认格式输出，与原先拼接的命令行一致
+    auto text = [](auto value) {
+        ostringstream ss;
+        ss << value;
+        return ss.str();
+    };
+    vector<string> options = {string("--algo=") + AlgorithmName(args_.algorithm),
+                              "-t", text(args_.time_limit)};
+    if (args_.deadline > 0) options.insert(options.end(), {"--deadline", text(args_.deadline)});
+    options.insert(options.end(), {
+        "--capacity", text(args_.machine_capacity),
+        "--u-penalty", text(args_.u_penalty),
+        "--b-penalty", text(args_.b_penalty),
+        "--threshold", text(args_.big_order_threshold),
+        "--cplex-threads", text(threads_),
+        "--cplex-workmem", text(args_.cplex_workmem),
+        "--cplex-workdir", args_.cplex_workdir,
+    });
+    if (!args_.enable_merge) options.push_back("--no-merge");
+    for (size_t p = 0; p < space_.size(); p++) {
+        string flag = space_[p].key;
+        std::replace(flag.begin(), flag.end(), '_', '-');
+        options.insert(options.end(), {"--" + flag, config[p]});
+    }
+    return ChildSolveCommand(program_, options, run_dir, instance);
+}
+
+void Tuner::Execute(const string& instance_class, const TuneInstance& instance, TuneRun& run) {
+    fs::path run_dir = root_ / "runs" /
+        (instance_class + "_c" + to_string(run.config) + "_i" + to_string(run.instance));
+    std::error_code ec;
+    fs::create_directories(run_dir, ec);
+    ChildSolveResult result = RunChildSolve(Command(configs_[run.config], instance.path, run_dir), run_dir);
+    run.status = result.status;
+    run.objective = result.objective;
+    run.time = result.time;
+
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    LOG_FMT("[调参] %s 候选 %d 实例 %s: %s 目标=%.2f 时间=%.1fs\n",
+            instance_class.c_str(), run.config,
+            fs::path(instance.path).filename().string().c_str(),
+            run.status.c_str(), run.objective, run.time);
+}
+
+// 并行执行 runs[first, end)；收到中断后不再启动新的求解
+void Tuner::ExecuteBatch(const string& instance_class, const vector<const TuneInstance*>& instances,
+                         vector<TuneRun>& runs, size_t first) {
+    std::atomic<size_t> next{first};
+    auto work = [&]() {
+        for (size_t k = next++; k < runs.size(); k = next++) {
+            if (g_interrupt.Requested()) break;
+            Execute(instance_class, *instances[runs[k].instance], runs[k]);
+        }
+    };
+    vector<std::thread> pool;
+    int count = min(workers_, static_cast<int>(runs.size() - first));
+    for (int w = 0; w < count; w++) pool.emplace_back(work);
+    for (auto& thread : pool) thread.join();
+}
+
+int Tuner::Race(const string& instance_class, const vector<const TuneInstance*>& instances,
+                vector<TuneRun>& runs, vector<vector<double>>& scores) {
+    int C = static_cast<int>(configs_.size());
+    int n = static_cast<int>(instances.size());
+    vector<vector<int>> run_of(C, vector<int>(n, -1));   // [c][i] -> runs 下标
+    vector<int> alive(C);
+    for (int c = 0; c < C; c++) alive[c] = c;
+
+    // 已求解实例上的得分 [c][i] (未求解为 -1)
+    auto solved = [&](int c, int i) {
+        return run_of[c][i] >= 0 && runs[run_of[c][i]].status != "skipped";
+    };
+    auto compute_scores = [&]() {
+        scores.assign(C, vector<double>(n, -1.0));
+        for (int i = 0; i < n; i++) {
+            double best = -1.0;
+            for (int c = 0; c < C; c++) {
+                if (!solved(c, i)) continue;
+                double obj = runs[run_of[c][i]].objective;
+                if (obj >= 0 && (best < 0 || obj < best)) best = obj;
+            }
+            for (int c = 0; c < C; c++) {
+                if (!solved(c, i)) continue;
+                double obj = runs[run_of[c][i]].objective;
+                scores[c][i] = obj < 0 ? kTuneFailScore : (obj - best) / max(fabs(best), 1.0);
+            }
+        }
+    };
+    auto mean_of = [&](int c, int used, bool time) {
+        double sum = 0.0;
+        int count = 0;
+        for (int i = 0; i < used; i++) {
+            if (scores[c][i] < 0) continue;
+            sum += time ? runs[run_of[c][i]].time : scores[c][i];
+            count++;
+        }
+        return count > 0 ? sum / count : kTuneFailScore;
+    };
+
+    int used = 0;
+    for (int round = 1; ; round++) {
+        int target = used == 0 ? min(kTuneFirstInstances, n) : min(n, used * 2);
+        size_t first = runs.size();
+        for (int c : alive) {
+            for (int i = used; i < target; i++) {
+                TuneRun run;
+                run.config = c;
+                run.instance = i;
+                run_of[c][i] = static_cast<int>(runs.size());
+                runs.push_back(run);
+            }
+        }
+        LOG_FMT("[调参] %s 第 %d 轮: 候选 %zu 个，实例 [%d,%d)，求解 %zu 次\n",
+                instance_class.c_str(), round, alive.size(), used, target, runs.size() - first);
+        ExecuteBatch(instance_class, instances, runs, first);
+        used = target;
+        compute_scores();
+
+        std::stable_sort(alive.begin(), alive.end(), [&](int a, int b) {
+            double sa = mean_of(a, used, false);
+            double sb = mean_of(b, used, false);
+            if (fabs(sa - sb) > kEpsilon) return sa < sb;
+            return mean_of(a, used, true) < mean_of(b, used, true);
+        });
+        if (alive.size() == 1 || used >= n || g_interrupt.Requested()) {
+            break;
+        }
+        alive.resize((alive.size() + 1) / 2);
+    }
+
+    int winner = alive.front();
+    LOG_FMT("[调参] %s 胜出候选 %d: %s (平均偏差 %.4f，平均时间 %.1fs)\n",
+            instance_class.c_str(), winner, ConfigText(space_, configs_[winner]).c_str(),
+            mean_of(winner, used, false), mean_of(winner, used, true));
+    if (winner != 0) {
+        // 与当前参数在双方都求解过的实例上比较
+        double sum_winner = 0.0, sum_current = 0.0;
+        int common = 0;
+        for (int i = 0; i < n; i++) {
+            if (scores[0][i] < 0 || scores[winner][i] < 0) continue;
+            sum_winner += scores[winner][i];
+            sum_current += scores[0][i];
+            common++;
+        }
+        if (common > 0) {
+            LOG_FMT("[调参] %s 当前参数在相同 %d 个实例上的平均偏差 %.4f (胜出 %.4f)\n",
+                    instance_class.c_str(), common, sum_current / common, sum_winner / common);
+        }
+    }
+    return winner;
+}
+
+}  // namespace
+
+bool ReadTuneInstances(const string& path, vector<TuneInstance>& instances) {
+    instances.clear();
+    std::error_code ec;
+
+    if (fs::is_directory(path, ec)) {
+        fs::path root(path);
+        for (const auto& entry : fs::recursive_directory_iterator(root, ec)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".csv") continue;
+            fs::path relative = fs::relative(entry.path().parent_path(), root, ec);
+            TuneInstance instance;
+            instance.path = entry.path().string();
+            instance.instance_class = (relative.empty() || relative == ".")
+                ? "default" : relative.begin()->string();
+            instances.push_back(instance);
+        }
+        std::sort(instances.begin(), instances.end(),
+                  [](const TuneInstance& a, const TuneInstance& b) { return a.path < b.path; });
+        return !instances.empty();
+    }
+
+    ifstream fin(path);
+    if (!fin) {
+        return false;
+    }
+    fs::path base = fs::path(path).parent_path();
+    string line;
+    vector<string> cells;
+    while (getline(fin, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        SplitString(line, cells, ",");
+        if (cells.empty() || cells[0].empty()) continue;
+
+        fs::path file(cells[0]);
+        if (file.is_relative()) file = base / file;
+        TuneInstance instance;
+        instance.path = file.string();
+        instance.instance_class = (cells.size() > 1 && !cells[1].empty()) ? cells[1] : "default";
+        instances.push_back(instance);
+    }
+    return !instances.empty();
+}
+
+int RunTuner(const CommandLineArgs& args, const string& program) {
+    vector<TuneInstance> instances;
+    if (!ReadTuneInstances(args.tune, instances)) {
+        LOG_FMT("[错误] 无法读取调参实例集: %s\n", args.tune.c_str());
+        return 1;
+    }
+
+    // 按类别分组，类别内顺序按种子打乱 (各轮依次取用)
+    map<string, vector<const TuneInstance*>> classes;
+    for (const auto& instance : instances) {
+        classes[instance.instance_class].push_back(&instance);
+    }
+    std::mt19937 rng(args.tune_seed);
+    for (auto& [name, members] : classes) {
+        std::shuffle(members.begin(), members.end(), rng);
+    }
+
+    fs::path root = fs::path(args.output_dir) / ("tune_" + GetCurrentTimestamp());
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (ec) {
+        LOG_FMT("[错误] 无法创建调参目录: %s\n", root.string().c_str());
+        return 1;
+    }
+
+    Tuner tuner(args, program, root);
+    const auto& space = tuner.Space();
+    const auto& configs = tuner.Configs();
+    LOG_FMT("[调参] 算法 %s: 实例 %zu 个 (类别 %zu 个)，候选配置 %zu 个，并行 %d 进程 x %d 线程\n",
+            AlgorithmName(args.algorithm), instances.size(), classes.size(), configs.size(),
+            tuner.Workers(), tuner.Threads());
+    for (size_t c = 0; c < configs.size(); c++) {
+        LOG_FMT("[调参] 候选 %zu: %s%s\n", c, ConfigText(space, configs[c]).c_str(),
+                c == 0 ? " (当前参数)" : "");
+    }
+
+    ofstream runs_csv(root / "runs.csv");
+    runs_csv << "class,config,instance,status,objective,time,score";
+    for (const auto& param : space) runs_csv << "," << param.key;
+    runs_csv << "\n";
+
+    map<string, int> winners;
+    map<string, pair<double, double>> winner_stats;   // 平均偏差, 平均时间
+    map<string, int> class_runs;
+    for (const auto& [name, members] : classes) {
+        if (g_interrupt.Requested()) break;
+        vector<TuneRun> runs;
+        vector<vector<double>> scores;
+        int winner = tuner.Race(name, members, runs, scores);
+        winners[name] = winner;
+        class_runs[name] = static_cast<int>(runs.size());
+
+        double score_sum = 0.0, time_sum = 0.0;
+        int count = 0;
+        runs_csv << fixed;
+        for (const auto& run : runs) {
+            double score = scores[run.config][run.instance];
+            runs_csv << name << "," << run.config << ","
+                     << members[run.instance]->path << "," << run.status << ","
+                     << setprecision(2) << run.objective << ","
+                     << setprecision(3) << run.time << ","
+                     << setprecision(6) << score;
+            for (const auto& value : configs[run.config]) runs_csv << "," << value;
+            runs_csv << "\n";
+            if (run.config == winner && score >= 0) {
+                score_sum += score;
+                time_sum += run.time;
+                count++;
+            }
+        }
+        winner_stats[name] = {count > 0 ? score_sum / count : kTuneFailScore,
+                              count > 0 ? time_sum / count : 0.0};
+    }
+
+    if (winners.empty()) {
+        LOG("[调参] 已中断，未得到调参结果");
+        return 1;
+    }
+
+    fs::path profile_path = root / "profile.ini";
+    ofstream profile(profile_path);
+    profile << "; LS-NTGF 调参结果 (--tune)\n";
+    profile << "; 算法: " << AlgorithmName(args.algorithm) << "  实例集: " << args.tune
+            << "  候选配置: " << configs.size() << "  种子: " << args.tune_seed << "\n";
+    profile << "; 加载: --profile " << profile_path.string() << " --profile-class <类别>\n";
+    for (const auto& [name, winner] : winners) {
+        profile << "\n[" << name << "]\n";
+        profile << fixed << setprecision(4);
+        profile << "; 实例 " << classes[name].size() << " 个，求解 " << class_runs[name]
+                << " 次，胜出候选 " << winner << "，平均偏差 " << winner_stats[name].first
+                << "，平均时间 " << setprecision(1) << winner_stats[name].second << "s\n";
+        profile << "algo = " << AlgorithmName(args.algorithm) << "\n";
+        for (size_t p = 0; p < space.size(); p++) {
+            profile << space[p].key << " = " << configs[winner][p] << "\n";
+        }
+    }
+
+    LOG_FMT("[调参] 求解记录: %s\n", (root / "runs.csv").string().c_str());
+    LOG_FMT("[调参] 参数配置: %s\n", profile_path.string().c_str());
+    if (g_interrupt.Requested()) {
+        LOG("[调参] 已中断，配置文件只含已完成的类别");
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// tune.h - 超参数调优
+// --tune <实例集> 对当前算法 (--algo) 的超参数做 racing 式配置搜索:
+//   RF:  rf_window, rf_step, rf_retries
+//   RFO: 以上与 fo_window, fo_step, fo_rounds, fo_buffer
+//   RR:  rr_capacity, rr_bonus
+// 实例集为目录 (递归查找 *.csv，子目录名为实例类别，根目录下的文件属于 default)，
+// 或列表文件 (每行 "路径[,类别]"，相对路径相对列表文件所在目录，缺省类别为 default)。
+//
+// 候选配置为当前参数加上 --tune-configs - 1 个随机采样的配置。每个类别独立做 successive halving:
+// 第一轮所有候选在 2 个实例上求解，之后每轮实例数翻倍、保留得分较好的一半，直到只剩一个候选或
+// 实例用完。得分为相对同一实例上最好目标值的偏差 (无解记为 100%) 在已求解实例上的平均值，
+// 得分相同时平均求解时间短者优先。
+//
+// 每次求解启动本程序的子进程 (沿用 -t、--deadline、产能、惩罚、合并与 CPLEX 参数)，
+// 子进程数为 --tune-workers，CPLEX 线程在子进程间均分。结果写入 <输出目录>/tune_<时间>/:
+//   runs.csv     全部求解记录 (类别、候选、实例、状态、目标、时间、得分)
+//   profile.ini  每个类别一节，用 --profile profile.ini --profile-class <类别> 加载
+
+#ifndef TUNE_H_
+#define TUNE_H_
+
+#include "solve_driver.h"
+
+// 调参实例
+struct TuneInstance {
+    string path;
+    string instance_class;
+};
+
+// 读取实例集 (目录或列表文件)
+bool ReadTuneInstances(const string& path, vector<TuneInstance>& instances);
+
+// 执行调参，program 为本程序路径 (启动子进程)；返回进程退出码
+int RunTuner(const CommandLineArgs& args, const string& program);
+
+#endif  // TUNE_H_